@@ -38,3 +38,68 @@ BOOST_AUTO_TEST_CASE(basic)
   HistoryLogDataInstall::Ptr p = dynamic_pointer_cast<HistoryLogDataInstall>( history[1] );
   BOOST_CHECK_EQUAL( p->userdata(), "trans|ID" ); // properly (un)escaped?
 }
+
+namespace
+{
+  std::vector<HistoryLogData::Ptr> readSorted( bool reverse_r, const Date & from_r = Date(), const Date & to_r = Date() )
+  {
+    std::vector<HistoryLogData::Ptr> history;
+    parser::HistoryLogReader parser( TESTS_SRC_DIR "/parser/HistoryLogReader_sorted_test.dat",
+				     parser::HistoryLogReader::Options(),
+      [&history]( HistoryLogData::Ptr ptr )->bool {
+	history.push_back( ptr );
+	return true;
+      } );
+    parser.setReverseOrder( reverse_r );
+    BOOST_CHECK_EQUAL( parser.reverseOrder(), reverse_r );
+
+    if ( to_r )
+      parser.readFromTo( from_r, to_r );
+    else if ( from_r )
+      parser.readFrom( from_r );
+    else
+      parser.readAll();
+    return history;
+  }
+
+  Date date( const std::string & str_r )
+  { return Date( str_r, HISTORY_LOG_DATE_FORMAT ); }
+}
+
+BOOST_AUTO_TEST_CASE(readFromTo)
+{
+  std::vector<HistoryLogData::Ptr> history;
+
+  history = readSorted( false );
+  BOOST_REQUIRE_EQUAL( history.size(), 5 );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRepoAdd>	( history[0] ) );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRepoRemove>	( history[4] ) );
+
+  history = readSorted( false, date( "2020-01-01 10:05:00" ) );	// exclusive
+  BOOST_REQUIRE_EQUAL( history.size(), 3 );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataStampCommand>	( history[0] ) );
+
+  history = readSorted( false, date( "2020-01-01 00:00:00" ), date( "2020-01-02 08:00:01" ) );	// to is exclusive
+  BOOST_REQUIRE_EQUAL( history.size(), 3 );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRepoAdd>	( history[0] ) );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataStampCommand>	( history[2] ) );
+
+  history = readSorted( false, date( "2021-01-01 00:00:00" ) );
+  BOOST_CHECK_EQUAL( history.size(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(reverse)
+{
+  std::vector<HistoryLogData::Ptr> history;
+
+  history = readSorted( true );
+  BOOST_REQUIRE_EQUAL( history.size(), 5 );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRepoRemove>	( history[0] ) );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRemove>	( history[1] ) );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRepoAdd>	( history[4] ) );
+
+  history = readSorted( true, date( "2020-01-01 10:00:00" ), date( "2020-01-03 00:00:00" ) );
+  BOOST_REQUIRE_EQUAL( history.size(), 3 );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataRemove>	( history[0] ) );
+  BOOST_CHECK( dynamic_pointer_cast<HistoryLogDataInstall>	( history[2] ) );
+}
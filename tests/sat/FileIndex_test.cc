@@ -0,0 +1,79 @@
+#include "TestSetup.h"
+#include <zypp/sat/FileIndex.h>
+#include <zypp/sat/LookupAttr.h>
+#include <zypp/PoolQuery.h>
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+/** The expected result by scanning the filelists. */
+sat::FileIndex::Solvables scan( Repository repo_r, const std::string & str_r, sat::FileIndex::Mode mode_r )
+{
+  std::set<sat::Solvable> ret;
+  sat::LookupAttr q( sat::SolvAttr::filelist, repo_r );
+  for_( it, q.begin(), q.end() )
+  {
+    std::string path( it.asString() );
+    bool match = false;
+    switch ( mode_r )
+    {
+      case sat::FileIndex::PATH:	match = ( path == str_r ); break;
+      case sat::FileIndex::DIR:		match = str::startsWith( path, str_r + "/" ); break;
+      case sat::FileIndex::BASENAME:	match = ( Pathname( path ).basename() == str_r ); break;
+    }
+    if ( match )
+      ret.insert( it.inSolvable() );
+  }
+  return sat::FileIndex::Solvables( ret.begin(), ret.end() );
+}
+
+BOOST_AUTO_TEST_CASE(fileindex)
+{
+  test.loadRepo( TESTS_SRC_DIR "/data/OBS_zypp_svn-11.1", "obs" );
+  Repository repo( test.satpool().reposFind( "obs" ) );
+  BOOST_REQUIRE( repo );
+
+  shared_ptr<const sat::FileIndex> idx( sat::FileIndex::get( repo ) );
+  BOOST_REQUIRE( idx );
+  BOOST_CHECK( idx->size() );
+  BOOST_CHECK_EQUAL( idx, sat::FileIndex::get( repo ) );	// cached
+
+  BOOST_CHECK( ! idx->path( "/usr/bin/zypper" ).empty() );
+  BOOST_CHECK( idx->path( "/usr/bin/zypper" ) == scan( repo, "/usr/bin/zypper", sat::FileIndex::PATH ) );
+  BOOST_CHECK( idx->path( "/usr/bin/nonexisting" ).empty() );
+  BOOST_CHECK( idx->path( "zypper" ).empty() );
+
+  BOOST_CHECK( ! idx->dir( "/usr/bin" ).empty() );
+  BOOST_CHECK( idx->dir( "/usr/bin" ) == scan( repo, "/usr/bin", sat::FileIndex::DIR ) );
+  BOOST_CHECK( idx->dir( "/usr/bin/" ) == idx->dir( "/usr/bin" ) );
+  BOOST_CHECK( idx->dir( "/etc" ) == scan( repo, "/etc", sat::FileIndex::DIR ) );
+  BOOST_CHECK( idx->dir( "/us" ).empty() );
+
+  BOOST_CHECK( ! idx->basename( "zypper.lr" ).empty() );
+  BOOST_CHECK( idx->basename( "zypper.lr" ) == scan( repo, "zypper.lr", sat::FileIndex::BASENAME ) );
+
+  BOOST_CHECK( sat::FileIndex::poolLookup( "/usr/bin/zypper" ) == idx->path( "/usr/bin/zypper" ) );
+}
+
+BOOST_AUTO_TEST_CASE(fileindex_poolquery)
+{
+  // exact path
+  PoolQuery q;
+  q.addAttribute( sat::SolvAttr::filelist, "/usr/bin/zypper" );
+  q.setMatchExact();
+  q.setCaseSensitive();
+  BOOST_CHECK_EQUAL( q.size(), sat::FileIndex::poolLookup( "/usr/bin/zypper" ).size() );
+
+  // directory
+  PoolQuery d;
+  d.addAttribute( sat::SolvAttr::filelist, "/etc/" );
+  d.setFlags( Match::STRINGSTART );
+  d.setCaseSensitive();
+  BOOST_CHECK_EQUAL( d.size(), sat::FileIndex::poolLookup( "/etc", sat::FileIndex::DIR ).size() );
+}
@@ -1,6 +1,13 @@
 #include "TestSetup.h"
+#include <atomic>
+#include <thread>
 #include <zypp/Repository.h>
+#include <zypp/PoolQuery.h>
 #include <zypp/sat/Pool.h>
+extern "C"
+{
+#include <solv/pool.h>
+}
 
 static TestSetup test( TestSetup::initLater );
 struct TestInit {
@@ -91,6 +98,66 @@ BOOST_AUTO_TEST_CASE(repolist)
   //test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1" );
 }
 
+BOOST_AUTO_TEST_CASE(freeze)
+{
+  // openSUSE-11.1 is still loaded
+  sat::Pool satpool( test.satpool() );
+  BOOST_REQUIRE( satpool.reposFind( ":openSUSE-11.1" ) );
+  BOOST_CHECK( ! satpool.frozen() );
+
+  Capability cap( "glibc > 2.0" );
+  std::vector<sat::Solvable> expectProviders( satpool.whatProvides( cap ).begin(), satpool.whatProvides( cap ).end() );
+  BOOST_CHECK( ! expectProviders.empty() );
+  PoolQuery q;
+  q.addString( "lib" );
+  q.addAttribute( sat::SolvAttr::name );
+  std::vector<sat::Solvable> expectHits( q.begin(), q.end() );
+  BOOST_CHECK( ! expectHits.empty() );
+
+  {
+    sat::Pool::Frozen frozen( satpool.freeze() );
+    BOOST_CHECK( frozen );
+    BOOST_CHECK( satpool.frozen() );
+    // readers must not rebuild libsolvs string hash
+    BOOST_CHECK( satpool.get()->ss.stringhashtbl );
+
+    // changes are rejected
+    BOOST_CHECK_THROW( satpool.reposInsert( "newrepo" ), Exception );
+    BOOST_CHECK_THROW( IdString( "no-string-like-this-in-the-pool" ), Exception );
+    BOOST_CHECK_EQUAL( IdString( "glibc" ), IdString( "glibc" ) );	// known strings are fine
+
+    // concurrent readers
+    std::atomic<unsigned> failed { 0 };
+    auto reader = [&]() {
+      for ( unsigned i = 0; i < 20; ++i )
+      {
+        std::vector<sat::Solvable> providers( satpool.whatProvides( cap ).begin(), satpool.whatProvides( cap ).end() );
+        if ( providers != expectProviders )
+          ++failed;
+        PoolQuery tq;
+        tq.addString( "lib" );
+        tq.addAttribute( sat::SolvAttr::name );
+        std::vector<sat::Solvable> hits( tq.begin(), tq.end() );
+        if ( hits != expectHits )
+          ++failed;
+        for ( const sat::Solvable & solv : hits )
+          solv.summary();
+      }
+    };
+    std::vector<std::thread> threads;
+    for ( unsigned i = 0; i < 4; ++i )
+      threads.push_back( std::thread( reader ) );
+    for ( std::thread & t : threads )
+      t.join();
+    BOOST_CHECK_EQUAL( failed.load(), 0U );
+  }
+  BOOST_CHECK( ! satpool.frozen() );
+
+  Repository repo( satpool.reposInsert( "newrepo" ) );
+  BOOST_CHECK( repo );
+  repo.eraseFromPool();
+}
+
 #if 0
 BOOST_AUTO_TEST_CASE(LookupAttr_)
 {
@@ -0,0 +1,85 @@
+#include "TestSetup.h"
+#include <zypp/sat/TrigramIndex.h>
+#include <zypp/base/StrMatcher.h>
+#include <zypp/PoolQuery.h>
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+typedef sat::TrigramIndex::Literals Literals;
+
+Literals lits( const std::string & str_r, const Match & mode_r )
+{
+  Literals ret;
+  if ( ! sat::TrigramIndex::literals( StrMatcher( str_r, mode_r ), ret ) )
+    ret.clear();
+  return ret;
+}
+
+BOOST_AUTO_TEST_CASE(literals)
+{
+  BOOST_CHECK( lits( "", Match::SUBSTRING ).empty() );
+  BOOST_CHECK( lits( "ab", Match::SUBSTRING ).empty() );			// too short
+  BOOST_CHECK( lits( "zypper", Match::STRING ) == Literals({ { "zypper" } }) );
+  BOOST_CHECK( lits( "zypper", Match::SUBSTRING ) == Literals({ { "zypper" } }) );
+
+  BOOST_CHECK( lits( "lib*zypp?x[0-9]", Match::GLOB ) == Literals({ { "lib", "zypp", "x" } }) );
+  BOOST_CHECK( lits( "*", Match::GLOB ).empty() );
+
+  BOOST_CHECK( lits( "^lib.*zypp$", Match::REGEX ) == Literals({ { "lib", "zypp" } }) );
+  BOOST_CHECK( lits( "zypperx?", Match::REGEX ) == Literals({ { "zypper" } }) );
+  BOOST_CHECK( lits( "^(zypper|yast2)$", Match::REGEX ) == Literals({ { "zypper" }, { "yast2" } }) );
+  BOOST_CHECK( lits( "\\b(zypper|ya)\\b", Match::REGEX ).empty() );		// 'ya' too short
+  BOOST_CHECK( lits( "(a|b)c(d)", Match::REGEX ).empty() );			// too complex
+  BOOST_CHECK( lits( "lib\\w+", Match::REGEX ).empty() );			// character class
+}
+
+BOOST_AUTO_TEST_CASE(trigram_index)
+{
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  Repository repo( test.satpool().reposFind( "opensuse" ) );
+  BOOST_REQUIRE( repo );
+
+  Pathname solvfile( RepoManagerOptions::makeTestSetup( test.root() ).repoSolvCachePath / "opensuse" / "solv" );
+  BOOST_REQUIRE( sat::TrigramIndex::build( solvfile ) );
+
+  sat::TrigramIndex idx( solvfile );
+  BOOST_REQUIRE( idx );
+  BOOST_CHECK_EQUAL( idx.solvablesSize(), repo.solvablesSize() );
+
+  // every match must be a candidate
+  Literals literals( lits( "zypp", Match::SUBSTRING ) );
+  std::vector<unsigned> offsets;
+  sat::detail::SolvableIdType start = repo.solvablesBegin()->id();	// offsets are relative to the repos 1st solvable
+  BOOST_REQUIRE( idx.candidates( sat::SolvAttr::name, literals, offsets ) );
+  BOOST_CHECK( ! offsets.empty() );
+  for ( const sat::Solvable & solv : repo.solvables() )
+  {
+    if ( solv.ident().asString().find( "zypp" ) != std::string::npos )
+      BOOST_CHECK( std::binary_search( offsets.begin(), offsets.end(), unsigned(solv.id() - start) ) );
+  }
+
+  // PoolQuery takes the index into account and still finds the same
+  PoolQuery q;
+  q.addAttribute( sat::SolvAttr::name, "zypp" );
+  q.setMatchSubstring();
+  unsigned expected = 0;
+  for ( const sat::Solvable & solv : repo.solvables() )
+    if ( solv.ident().asString().find( "zypp" ) != std::string::npos )
+      ++expected;
+  BOOST_CHECK_EQUAL( q.size(), expected );
+
+  // a truncated index is not used
+  Pathname idxfile( sat::TrigramIndex::indexFile( solvfile ) );
+  off_t fullsize = PathInfo( idxfile ).size();
+  BOOST_REQUIRE_EQUAL( ::truncate( idxfile.c_str(), fullsize - 8 ), 0 );
+  BOOST_CHECK( ! sat::TrigramIndex( solvfile ) );
+  BOOST_REQUIRE_EQUAL( ::truncate( idxfile.c_str(), 16 ), 0 );
+  BOOST_CHECK( ! sat::TrigramIndex( solvfile ) );
+}
@@ -3,6 +3,7 @@
 // tests for Edition
 //
 
+#include "TestSetup.h"
 #include <zypp/base/Logger.h>
 #include <zypp/Edition.h>
 
@@ -36,3 +37,23 @@ BOOST_AUTO_TEST_CASE(edition)
   BOOST_CHECK_EQUAL( Edition::compare("2:1-1","2:1-1"), 0 );
   BOOST_CHECK_EQUAL( Edition::compare("3:1-1","2:1-1"), 1 );
 }
+
+BOOST_AUTO_TEST_CASE(edition_ranks)
+{
+  TestSetup test( Arch_x86_64 );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1" );
+
+  std::vector<Edition> editions;
+  for ( const sat::Solvable & solv : test.satpool().solvables() )
+    editions.push_back( solv.edition() );
+  BOOST_REQUIRE( editions.size() > 1000 );	// enough compares to build the ranks
+
+  // The ranks must order like the strings.
+  auto sign = []( int val_r ) { return val_r < 0 ? -1 : val_r > 0 ? 1 : 0; };
+  for ( unsigned i = 1; i < editions.size(); ++i )
+  {
+    BOOST_CHECK_EQUAL( sign( Edition::compare( editions[i-1], editions[i] ) ),
+                       sign( Edition::compare( editions[i-1].c_str(), editions[i].c_str() ) ) );
+  }
+  BOOST_CHECK_EQUAL( Edition::compare( Edition("1.0-1"), Edition("1_0-1") ), 0 );
+}
@@ -0,0 +1,119 @@
+#include "TestSetup.h"
+#include <thread>
+#include <zypp/PoolContext.h>
+#include <zypp/PoolQuery.h>
+#include <zypp/ResPool.h>
+#include <zypp/Locale.h>
+#include <zypp/VendorAttr.h>
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+unsigned countPackages( const std::string & name_r )
+{
+  PoolQuery q;
+  q.addKind( ResKind::package );
+  q.addAttribute( sat::SolvAttr::name, name_r );
+  q.setMatchExact();
+  return q.size();
+}
+
+BOOST_AUTO_TEST_CASE(pool_context)
+{
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  unsigned defaultSize = sat::Pool::instance().solvablesSize();
+  BOOST_REQUIRE( defaultSize );
+
+  PoolContext ctx;
+  BOOST_CHECK( ! ctx.isDefault() );
+  BOOST_CHECK( ! ctx.isCurrent() );
+  BOOST_CHECK( PoolContext::current().isDefault() );
+  {
+    PoolContext::Scope scope( ctx );
+    BOOST_CHECK( ctx.isCurrent() );
+    BOOST_CHECK( sat::Pool::instance().reposEmpty() );
+    BOOST_CHECK( ResPool::instance().empty() );
+    // builtin ids are shared
+    BOOST_CHECK_EQUAL( IdString( "package" ), ResKind::package );
+
+    test.loadRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1", "obs" );
+    BOOST_CHECK_EQUAL( sat::Pool::instance().reposSize(), 1 );
+    BOOST_CHECK( sat::Pool::instance().reposFind( "obs" ) );
+    BOOST_CHECK( ! sat::Pool::instance().reposFind( "opensuse" ) );
+    BOOST_CHECK( ! ResPool::instance().empty() );
+    BOOST_CHECK_EQUAL( &ResPool::instance().resolver(), ctx.resolver().get() );
+    {
+      PoolContext::Scope nested( PoolContext::defaultContext() );
+      BOOST_CHECK( PoolContext::current().isDefault() );
+      BOOST_CHECK_EQUAL( sat::Pool::instance().solvablesSize(), defaultSize );
+    }
+    BOOST_CHECK( ctx.isCurrent() );
+  }
+  BOOST_CHECK( PoolContext::current().isDefault() );
+  BOOST_CHECK_EQUAL( sat::Pool::instance().solvablesSize(), defaultSize );
+  BOOST_CHECK( ! sat::Pool::instance().reposFind( "obs" ) );
+
+  // the pools are independent of each other
+  unsigned inDefault = 0;
+  unsigned inContext = 0;
+  std::thread worker( [&]() {
+    PoolContext::Scope scope( ctx );
+    for ( unsigned i = 0; i < 10; ++i )
+      inContext = countPackages( "dev86" );
+  } );
+  for ( unsigned i = 0; i < 10; ++i )
+    inDefault = countPackages( "dev86" );
+  worker.join();
+  BOOST_CHECK( inContext );
+  BOOST_CHECK_EQUAL( inDefault, 0 );
+}
+
+BOOST_AUTO_TEST_CASE(const_strings)
+{
+  PoolContext ctx;
+  sat::detail::IdType inDefault = sat::detail::constStr2id( "product()" );
+  {
+    PoolContext::Scope scope( ctx );
+    BOOST_CHECK_EQUAL( sat::detail::constStr2id( "product()" ), inDefault );
+    // strings interned after the context was created are not shared
+    IdString( "a-string-new-to-the-context" );
+    BOOST_CHECK_THROW( sat::detail::constStr2id( "a-string-new-to-the-context" ), Exception );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(static_caches)
+{
+  // Let the same id denote different strings in the two pools.
+  PoolContext ctx;
+  IdString inContext;
+  {
+    PoolContext::Scope scope( ctx );
+    inContext = IdString( "other_CT" );
+  }
+  IdString inDefault( "suse_DF" );
+  for ( unsigned i = 0; inDefault.id() < inContext.id(); ++i )
+    inDefault = IdString( "suse_DF" + str::numstring( i ) );
+  BOOST_REQUIRE_EQUAL( inDefault.id(), inContext.id() );
+
+  // Fill the caches in the default pool...
+  VendorAttr vendorAttr;
+  std::string defaultStr( inDefault.asString() );
+  BOOST_CHECK_EQUAL( Arch( inDefault ).asString(), defaultStr );
+  BOOST_CHECK_EQUAL( Locale( inDefault ).country().asString(), defaultStr.substr( 5 ) );
+  BOOST_CHECK( vendorAttr.equivalent( inDefault, IdString( "suse" ) ) );
+  {
+    // ...and don't get their entries in the context.
+    PoolContext::Scope scope( ctx );
+    BOOST_CHECK_EQUAL( Arch( inContext ).asString(), "other_CT" );
+    BOOST_CHECK_EQUAL( Arch( inContext ).idStr(), inContext );
+    BOOST_CHECK_EQUAL( Locale( inContext ).language(), LanguageCode( "other" ) );
+    BOOST_CHECK_EQUAL( Locale( inContext ).country(), CountryCode( "CT" ) );
+    BOOST_CHECK( ! vendorAttr.equivalent( inContext, IdString( "suse" ) ) );
+  }
+}
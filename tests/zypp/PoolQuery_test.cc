@@ -1,6 +1,7 @@
 #include "TestSetup.h"
 #include <zypp/PoolQuery.h>
 #include <zypp/PoolQueryUtil.tcc>
+#include <zypp/ZConfig.h>
 
 #define BOOST_TEST_MODULE PoolQuery
 
@@ -635,6 +636,54 @@ BOOST_AUTO_TEST_CASE(pool_predicated_matcher)
   }
 }
 
+BOOST_AUTO_TEST_CASE(pool_query_parallel)
+{
+  cout << "****parallel****"  << endl;
+  // No repo here has an index, so the plain query iterates lazily
+  // and serves as reference for the parallel scan.
+  BOOST_REQUIRE( ! ZConfig::instance().repo_trigramIndex() );
+  auto check = []( const PoolQuery & q )
+  {
+    PoolQuery ref( q );
+    ref.setParallel( false );
+    BOOST_CHECK( ! ref.parallel() );
+    std::vector<sat::Solvable> seq( ref.begin(), ref.end() );
+
+    PoolQuery par( q );
+    par.setParallel();
+    BOOST_CHECK( par.parallel() );
+    std::vector<sat::Solvable> res( par.begin(), par.end() );
+
+    BOOST_CHECK( ! seq.empty() );
+    BOOST_CHECK_EQUAL( seq.size(), res.size() );
+    BOOST_CHECK( seq == res );
+  };
+
+  {
+    PoolQuery q;
+    q.addString("zypp");
+    q.addAttribute(sat::SolvAttr::name);
+    q.addAttribute(sat::SolvAttr::description);
+    check( q );
+  }
+  {
+    PoolQuery q;
+    q.addString("^/usr/bin/");
+    q.setMatchRegex();
+    q.setFilesMatchFullPath();
+    q.addAttribute(sat::SolvAttr::filelist);
+    check( q );
+  }
+  {
+    PoolQuery q;
+    q.addString("kde");
+    q.addAttribute(sat::SolvAttr::summary);
+    q.addRepo("opensuse");
+    q.setUninstalledOnly();
+    check( q );
+  }
+}
+
 BOOST_AUTO_TEST_CASE(pool_query_serialize)
 {
   std::vector<PoolQuery> queries;
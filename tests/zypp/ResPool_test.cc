@@ -0,0 +1,117 @@
+#include "TestSetup.h"
+#include <zypp/ResPool.h>
+#include <zypp/PoolQuery.h>
+
+#define BOOST_TEST_MODULE ResPool
+
+namespace
+{
+  const std::vector<std::string> sharedNames { "bin86", "virtualbox-ose", "virtualbox-ose-kmp-default", "xorg-x11-driver-virtualbox-ose" };
+
+  /** The byIdent index must match a scan of the whole pool. */
+  void checkIndex( const ResPool & pool_r, const std::string & name_r )
+  {
+    std::set<sat::Solvable> expected;
+    for ( const PoolItem & pi : pool_r )
+    {
+      if ( pi.isKind<Package>() && pi.name() == name_r )
+        expected.insert( pi.satSolvable() );
+    }
+    std::set<sat::Solvable> indexed;
+    for ( const PoolItem & pi : pool_r.byIdent( ResKind::package, name_r ) )
+    {
+      BOOST_CHECK( pi );
+      BOOST_CHECK( pi.satSolvable() );
+      indexed.insert( pi.satSolvable() );
+    }
+    BOOST_CHECK_MESSAGE( indexed == expected, name_r << ": " << indexed.size() << " indexed, " << expected.size() << " in pool" );
+  }
+
+  void checkIndex( const ResPool & pool_r )
+  {
+    for ( const std::string & name : sharedNames )
+      checkIndex( pool_r, name );
+    checkIndex( pool_r, "zypper" );
+  }
+
+  unsigned countIdent( const ResPool & pool_r, const std::string & name_r, const std::string & alias_r )
+  {
+    unsigned ret = 0;
+    for ( const PoolItem & pi : pool_r.byIdent( ResKind::package, name_r ) )
+    {
+      if ( pi.repository().alias() == alias_r )
+        ++ret;
+    }
+    return ret;
+  }
+} // namespace
+
+BOOST_AUTO_TEST_CASE(incremental_store)
+{
+  TestSetup test( Arch_x86_64 );
+  ResPool pool { test.pool() };
+
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  ResPool::size_type opensuseSize = pool.size();
+  BOOST_REQUIRE( opensuseSize );
+  BOOST_CHECK( countIdent( pool, "zypper", "opensuse" ) );
+  checkIndex( pool );
+
+  // add a repo
+  test.loadRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1", "obs" );
+  ResPool::size_type obsSize = pool.size() - opensuseSize;
+  BOOST_REQUIRE( obsSize );
+  for ( const std::string & name : sharedNames )
+  {
+    BOOST_CHECK( countIdent( pool, name, "opensuse" ) );
+    BOOST_CHECK( countIdent( pool, name, "obs" ) );
+  }
+  checkIndex( pool );
+
+  // remove the first repo
+  test.satpool().reposFind( "opensuse" ).eraseFromPool();
+  BOOST_CHECK_EQUAL( pool.size(), obsSize );
+  for ( const PoolItem & pi : pool )
+    BOOST_CHECK_EQUAL( pi.repository().alias(), "obs" );
+  BOOST_CHECK( pool.byIdent( ResKind::package, "zypper" ).empty() );
+  checkIndex( pool );
+
+  // and add it again
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  BOOST_CHECK_EQUAL( pool.size(), opensuseSize + obsSize );
+  checkIndex( pool );
+}
+
+BOOST_AUTO_TEST_CASE(hardlocks_reapplied_to_new_items)
+{
+  TestSetup test( Arch_x86_64 );
+  ResPool pool { test.pool() };
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+
+  PoolQuery q;
+  q.addKind( ResKind::package );
+  q.addAttribute( sat::SolvAttr::name, "virtualbox-ose" );
+  q.setMatchExact();
+  pool.setHardLockQueries( ResPool::HardLockQueries { q } );
+
+  BOOST_REQUIRE( countIdent( pool, "virtualbox-ose", "opensuse" ) );
+  for ( const PoolItem & pi : pool.byIdent( ResKind::package, "virtualbox-ose" ) )
+    BOOST_CHECK( pi.status().isLocked() );
+
+  // items of a repo added later are locked as well
+  test.loadRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1", "obs" );
+  BOOST_REQUIRE( countIdent( pool, "virtualbox-ose", "obs" ) );
+  for ( const PoolItem & pi : pool.byIdent( ResKind::package, "virtualbox-ose" ) )
+    BOOST_CHECK_MESSAGE( pi.status().isLocked(), pi );
+  for ( const PoolItem & pi : pool.byIdent( ResKind::package, "bin86" ) )
+    BOOST_CHECK_MESSAGE( ! pi.status().isLocked(), pi );
+
+  // and after the repo was reloaded
+  test.satpool().reposFind( "obs" ).eraseFromPool();
+  test.loadRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1", "obs" );
+  BOOST_REQUIRE( countIdent( pool, "virtualbox-ose", "obs" ) );
+  for ( const PoolItem & pi : pool.byIdent( ResKind::package, "virtualbox-ose" ) )
+    BOOST_CHECK_MESSAGE( pi.status().isLocked(), pi );
+
+  pool.setHardLockQueries( ResPool::HardLockQueries() );
+}
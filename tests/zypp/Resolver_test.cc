@@ -2,9 +2,19 @@
 #define BOOST_CHECK_MODULE Resolver
 using namespace boost::unit_test;
 
+#define ZYPP_USE_RESOLVER_INTERNALS
 #include "TestSetup.h"
+#include <zypp/PoolContext.h>
 #include <zypp/ResPool.h>
 #include <zypp/ResPoolProxy.h>
+#include <zypp/ResolverStatistics.h>
+#include <zypp/ResolverWhatIf.h>
+#include <zypp/TmpPath.h>
+#include <zypp/base/GzStream.h>
+#include <zypp/misc/LoadTestcase.h>
+#include <zypp/misc/TestcaseArchive.h>
+#include <zypp/misc/TestcaseSetup.h>
+#include <zypp/solver/detail/ItemCapKind.h>
 #include <zypp/pool/PoolStats.h>
 #include <zypp/ui/Selectable.h>
 
@@ -98,3 +108,295 @@ BOOST_AUTO_TEST_CASE(inrOnlyRequires)
   // Fillup only namespace recommends
   BOOST_checkresult( resolve( inrMode|onlyRequires ), { Apde } );
 }
+
+BOOST_AUTO_TEST_CASE(incrementalSolve)
+{
+  test.resolver().setIncrementalSolve( true );
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  sat::detail::CSolver * solver = test.resolver().get();
+
+  // unchanged request: solver and result are reused
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK_EQUAL( test.resolver().get(), solver );
+
+  // changed flags or jobs are solved again by the same solver
+  BOOST_checkresult( resolve( onlyRequires ), { Ap, Ip, Apde } );
+  BOOST_CHECK_EQUAL( test.resolver().get(), solver );
+  Ap.status().setTransact( false, ResStatus::USER );
+  BOOST_checkresult( resolve( inrMode ), { Apde, Aprec } );
+  BOOST_CHECK_EQUAL( test.resolver().get(), solver );
+
+  test.resolver().setDefaultIncrementalSolve();
+  BOOST_CHECK( ! test.resolver().incrementalSolve() );
+}
+
+BOOST_AUTO_TEST_CASE(whatIf)
+{
+  test.resolver().setOnlyRequires( false );
+  test.resolver().setIgnoreAlreadyRecommended( true );
+
+  WhatIfJobs installAspell;
+  installAspell.install.push_back( Ap );
+  WhatIfJobs installOnlyRequires;
+  installOnlyRequires.install.push_back( Ap );
+  installOnlyRequires.conflicts.insert( Capability( "recommended-pkg" ) );
+
+  std::vector<WhatIfResult> results( test.resolver().whatIf( { installAspell, WhatIfJobs(), installOnlyRequires }, 2 ) );
+  BOOST_REQUIRE_EQUAL( results.size(), 3 );
+  auto asSet = []( const WhatIfResult & result_r ) {
+    PoolItemSet ret( result_r.toInstall.begin(), result_r.toInstall.end() );
+    ret.insert( result_r.toRemove.begin(), result_r.toRemove.end() );
+    return ret;
+  };
+  BOOST_CHECK( results[0].solved );
+  BOOST_CHECK_EQUAL( results[0].problems, 0 );
+  BOOST_checkresult( asSet( results[0] ), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK( results[1].solved );
+  BOOST_checkresult( asSet( results[1] ), {} );
+  BOOST_checkresult( asSet( results[2] ), { Ap, Ip, Apde } );
+
+  // the pool is untouched
+  BOOST_CHECK( ! test.satpool().frozen() );
+  BOOST_CHECK( ! Ap.status().transacts() );
+  BOOST_checkresult( resolve(), {} );
+}
+
+BOOST_AUTO_TEST_CASE(isInstalledBy)
+{
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+
+  // Aprec is recommended by Ap
+  solver::detail::ItemCapKindList by( test.resolver().isInstalledBy( Aprec ) );
+  BOOST_REQUIRE_EQUAL( by.size(), 1 );
+  BOOST_CHECK_EQUAL( by.front().item(), Ap );
+  BOOST_CHECK_EQUAL( by.front().capKind(), Dep::RECOMMENDS );
+  BOOST_CHECK( by.front().initialInstallation() );
+  BOOST_CHECK( ! test.resolver().installs( Ap ).empty() );
+  // repeated queries reuse the collected info
+  BOOST_CHECK_EQUAL( test.resolver().isInstalledBy( Aprec ).size(), 1 );
+
+  Ap.status().setTransact( false, ResStatus::USER );
+  BOOST_checkresult( resolve(), {} );
+  BOOST_CHECK( test.resolver().isInstalledBy( Aprec ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE(statistics)
+{
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  Ap.status().setTransact( false, ResStatus::USER );
+
+  const ResolverStatistics & stats( test.resolver().statistics() );
+  BOOST_CHECK_EQUAL( stats.solverRuns, 1 );
+  BOOST_CHECK( ! stats.reused );
+  BOOST_CHECK( stats.jobCount > 0 );
+  BOOST_CHECK( stats.ruleCount > 0 );
+  BOOST_CHECK( stats.learntRules <= stats.ruleCount );
+  BOOST_CHECK( stats.decisions > 0 );
+  BOOST_CHECK_EQUAL( stats.problemCount, 0 );
+  BOOST_CHECK( stats.total() >= stats.solve );
+}
+
+BOOST_AUTO_TEST_CASE(lazyProblems)
+{
+  Capability missing( "not-provided-by-anything" );
+  test.resolver().addRequire( missing );
+  BOOST_CHECK( ! test.resolver().resolvePool() );
+
+  ResolverProblemList problems( test.resolver().problems() );
+  BOOST_REQUIRE_EQUAL( problems.size(), 1 );
+  ResolverProblem_Ptr problem( problems.front() );
+  BOOST_CHECK( ! problem->rendered() );
+
+  BOOST_CHECK( problem->description().find( missing.asString() ) != std::string::npos );
+  BOOST_CHECK( ! problem->rendered() );	// solutions are not yet needed
+
+  // A new solver run renders the problems still in use
+  test.resolver().removeRequire( missing );
+  BOOST_CHECK( test.resolver().resolvePool() );
+  BOOST_CHECK( problem->rendered() );
+  BOOST_CHECK( ! problem->solutions().empty() );
+  BOOST_CHECK( ! problem->completeProblemInfo().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(installSpecs)
+{
+  std::vector<std::string> unknown( test.resolver().addInstallSpecs( { "aspell-de", "no-such-package", "provides:no-such-capability" } ) );
+  BOOST_CHECK( unknown == std::vector<std::string>({ "no-such-package", "provides:no-such-capability" }) );
+  BOOST_CHECK( test.resolver().getInstallNames() == IdStringSet({ IdString("aspell-de") }) );
+  {
+    // unknown names are not added to the pool
+    sat::Pool::Frozen frozen( sat::Pool::instance().freeze() );
+    BOOST_CHECK( test.resolver().addInstallSpecs( { "not-in-the-pool" } ) == std::vector<std::string>({ "not-in-the-pool" }) );
+    BOOST_CHECK( test.resolver().addInstallSpecs( { "provides:not-in-the-pool >= 1" } ) == std::vector<std::string>({ "provides:not-in-the-pool >= 1" }) );
+    BOOST_CHECK_EQUAL( Capability::lookup( "aspell-de" ), Capability( "aspell-de" ) );
+  }
+  BOOST_CHECK( ! Capability::lookup( "not-in-the-pool" ) );
+
+  BOOST_CHECK( test.resolver().resolvePool() );
+  BOOST_CHECK( Apde.status().transacts() );
+  BOOST_CHECK( ! Apde.status().isByUser() );	// selected by the solver, not in the pool
+
+  test.resolver().removeInstallNames();
+  BOOST_CHECK( test.resolver().getInstallNames().empty() );
+  BOOST_CHECK( test.resolver().resolvePool() );
+  BOOST_CHECK( ! Apde.status().transacts() );
+}
+
+/** The transacting items of the current pool (comparable across pools). */
+std::set<std::string> transacting()
+{
+  std::set<std::string> ret;
+  for ( const PoolItem & pi : ResPool::instance() )
+  {
+    if ( pi.status().transacts() )
+      ret.insert( str::Str() << ( pi.status().isToBeInstalled() ? "+" : "-" ) << pi.repository().alias()
+                             << ":" << pi.name() << "-" << pi.edition() << "." << pi.arch() );
+  }
+  return ret;
+}
+
+/** The item a trial job refers to (\c uninstall jobs name just an installed one). */
+PoolItem findTrialItem( const misc::testcase::TestcaseTrial::Node & node_r )
+{
+  for ( const PoolItem & pi : ResPool::instance().byIdent( ResKind( node_r.getProp( "kind" ) ), node_r.getProp( "name" ) ) )
+  {
+    if ( node_r.getProp( "channel" ).empty() ? pi.status().isInstalled()
+         : ( pi.repository().alias() == node_r.getProp( "channel" )
+             && pi.arch().asString() == node_r.getProp( "arch" )
+             && pi.edition().version() == node_r.getProp( "version" )
+             && pi.edition().release() == node_r.getProp( "release" ) ) )
+      return pi;
+  }
+  return PoolItem();
+}
+
+/** Replay the trial jobs written by the testcaseArchive test. */
+void applyTrialNode( const misc::testcase::TestcaseTrial::Node & node_r, Resolver & resolver_r )
+{
+  const std::string & job { node_r.name() };
+  if ( job == "addRequire" )
+  {
+    resolver_r.addRequire( Capability( node_r.getProp( "name" ) ) );
+    return;
+  }
+
+  PoolItem pi { findTrialItem( node_r ) };
+  BOOST_REQUIRE_MESSAGE( pi, job << " " << node_r.getProp( "name" ) );
+  if ( job == "lock" )
+    pi.status().setLock( true, ResStatus::USER );
+  else if ( job == "keep" )
+    pi.status().setTransact( false, ResStatus::USER );
+  else if ( job == "install" )
+    pi.status().setToBeInstalled( ResStatus::USER );
+  else if ( job == "uninstall" )
+    pi.status().setToBeUninstalled( ResStatus::USER );
+  else
+    BOOST_ERROR( "Unexpected job " << job );
+}
+
+BOOST_AUTO_TEST_CASE(testcaseArchive)
+{
+  using misc::testcase::LoadTestcase;
+  using misc::testcase::TestcaseRepoType;
+
+  filesystem::TmpDir tmp;
+  Capability req( "aspell-de" );
+  test.resolver().addRequire( req );
+  Aprec.status().setLock( true, ResStatus::USER );
+  BOOST_REQUIRE( test.resolver().createSolverTestcaseArchive( tmp.path().asString(), false ) );
+  BOOST_REQUIRE( test.resolver().resolvePool() );
+  std::set<std::string> expected { transacting() };
+  BOOST_CHECK( ! expected.empty() );
+  test.resolver().removeRequire( req );
+  Aprec.status().setLock( false, ResStatus::USER );
+  BOOST_CHECK( test.resolver().resolvePool() );
+
+  BOOST_CHECK_EQUAL( LoadTestcase::testcaseTypeAt( tmp.path() ), LoadTestcase::Archive );
+  BOOST_CHECK_EQUAL( LoadTestcase::testcaseTypeAt( tmp.path() / "zypp-testcase.ztc" ), LoadTestcase::Archive );
+
+  LoadTestcase tc;
+  std::string err;
+  BOOST_REQUIRE_MESSAGE( tc.loadTestcaseAt( tmp.path(), &err ), err );
+  const misc::testcase::TestcaseSetup & setup { tc.setupInfo() };
+  BOOST_CHECK_EQUAL( setup.repos().size(), test.satpool().reposSize() );
+  bool systemFound = false;
+  for ( const auto & repo : setup.repos() )
+  {
+    BOOST_CHECK( repo.type() == TestcaseRepoType::Solv );
+    BOOST_CHECK( PathInfo( setup.globalPath() / repo.path() ).isFile() );
+    if ( repo.alias() == sat::Pool::systemRepoAlias() )
+      systemFound = true;
+  }
+  BOOST_CHECK( systemFound );
+  BOOST_REQUIRE_EQUAL( tc.trialInfo().size(), 1 );
+
+  // replay it in a pool of its own: the result must be the same
+  PoolContext ctx;
+  PoolContext::Scope scope( ctx );
+  RepoManager repoManager { test.repomanager() };
+  BOOST_REQUIRE( setup.applySetup( repoManager ) );
+  BOOST_CHECK_EQUAL( sat::Pool::instance().reposSize(), test.satpool().reposSize() );
+  BOOST_CHECK_EQUAL( sat::Pool::instance().solvablesSize(), test.satpool().solvablesSize() );
+  base::SetTracker<LocaleSet> localesTracker = setup.localesTracker();
+  localesTracker.removed().insert( localesTracker.current().begin(), localesTracker.current().end() );
+  sat::Pool::instance().initRequestedLocales( localesTracker.removed() );
+  localesTracker.added().insert( localesTracker.current().begin(), localesTracker.current().end() );
+  sat::Pool::instance().setRequestedLocales( localesTracker.added() );
+
+  Resolver & resolver { *ctx.resolver() };
+  resolver.setFocus( setup.resolverFocus() );
+  resolver.setIgnoreAlreadyRecommended( setup.ignorealreadyrecommended() );
+  resolver.setOnlyRequires( setup.onlyRequires() );
+  resolver.setForceResolve( setup.forceResolve() );
+  resolver.setCleandepsOnRemove( setup.cleandepsOnRemove() );
+  for ( const auto & node : tc.trialInfo().front().nodes() )
+    applyTrialNode( node, resolver );
+  BOOST_CHECK( resolver.getRequire().count( req ) );
+
+  BOOST_REQUIRE( resolver.resolvePool() );
+  BOOST_CHECK( transacting() == expected );
+}
+
+BOOST_AUTO_TEST_CASE(testcaseArchiveCorrupted)
+{
+  using misc::testcase::TestcaseArchive;
+
+  filesystem::TmpDir tmp;
+  const Pathname archive { tmp.path() / TestcaseArchive::fileName };
+  {
+    // a member claiming more data than the archive holds
+    ofgzstream out( archive.c_str() );
+    out << "ZYPPTESTCASE 1\n" << "zypp-control.yaml\n" << "1000000000000\n" << "version: 1.0\n";
+  }
+  BOOST_CHECK( TestcaseArchive::isArchive( archive ) );
+  filesystem::TmpDir dir;
+  BOOST_CHECK_THROW( TestcaseArchive::extract( archive, dir.path() ), Exception );
+}
+
+BOOST_AUTO_TEST_CASE(resultCache)
+{
+  filesystem::TmpDir cache;
+  test.resolver().setResultCachePath( cache.path() );
+
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK( ! test.resolver().statistics().cached );
+
+  // same request: restored without solving
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK( test.resolver().statistics().cached );
+  BOOST_CHECK_EQUAL( test.resolver().statistics().solverRuns, 0 );
+  BOOST_CHECK( Apde.status().isBySolver() );
+  BOOST_CHECK( Ip.status().isToBeUninstalledDueToUpgrade() );
+
+  // changed flags are solved again
+  BOOST_checkresult( resolve( onlyRequires ), { Ap, Ip, Apde } );
+  BOOST_CHECK( ! test.resolver().statistics().cached );
+  Ap.status().setTransact( false, ResStatus::USER );
+
+  test.resolver().setDefaultResultCachePath();
+  BOOST_CHECK( test.resolver().resultCachePath().empty() );
+}
@@ -352,3 +352,80 @@ BOOST_AUTO_TEST_CASE(pickstatus_cycle)
 }
 
 /////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(byident)
+{
+  ResPool pool( test.pool() );
+  unsigned cnt = 0;
+  for ( const PoolItem & pi : pool.byIdent( ResKind::package, "candidate" ) )
+  {
+    BOOST_CHECK_EQUAL( pi.name(), "candidate" );
+    BOOST_CHECK_EQUAL( pi.kind(), ResKind::package );
+    ++cnt;
+  }
+  BOOST_CHECK_EQUAL( cnt, 7 );
+  BOOST_CHECK( pool.byIdentBegin( ResKind::package, "no_such_package" ) == pool.byIdentEnd( ResKind::package, "no_such_package" ) );
+
+  ResPoolProxy poolProxy( test.poolProxy() );
+  ui::Selectable::Ptr sel( poolProxy.lookup( ResKind::package, "candidate" ) );
+  BOOST_CHECK_EQUAL( sel->installedSize() + sel->availableSize(), cnt );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(lazyproxy)
+{
+  ResPoolProxy poolProxy( test.poolProxy() );
+  // lookup creates a Selectable on demand; repeated lookups return the same one
+  ui::Selectable::Ptr sel( poolProxy.lookup( ResKind::package, "candidate" ) );
+  BOOST_REQUIRE( sel );
+  BOOST_CHECK_EQUAL( poolProxy.lookup( ResKind::package, "candidate" ), sel );
+  BOOST_CHECK( ! poolProxy.lookup( ResKind::package, "no_such_package" ) );
+
+  // iterating a kind creates all its Selectables
+  unsigned cnt = 0;
+  for ( const ui::Selectable::Ptr & p : poolProxy.byKind( ResKind::package ) )
+  {
+    BOOST_CHECK_EQUAL( p->kind(), ResKind::package );
+    ++cnt;
+  }
+  BOOST_CHECK_EQUAL( cnt, poolProxy.size( ResKind::package ) );
+  BOOST_CHECK_EQUAL( ResPoolProxy::size_type( std::distance( poolProxy.begin(), poolProxy.end() ) ), poolProxy.size() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(proxyreuse)
+{
+  ui::Selectable::Ptr sel( test.poolProxy().lookup( ResKind::package, "candidate" ) );
+  BOOST_REQUIRE( sel );
+  PoolItem other;
+  for ( const PoolItem & pi : sel->available() )
+  {
+    if ( pi != sel->candidateObj() )
+    {
+      other = pi;
+      break;
+    }
+  }
+  BOOST_REQUIRE( other );
+  BOOST_CHECK_EQUAL( sel->setCandidate( other ), other );
+
+  // a repo not touching its items: the Selectable is reused and keeps its state
+  test.loadRepo( TESTS_SRC_DIR "/data/obs_virtualbox_11_1", "unrelated" );
+  ui::Selectable::Ptr kept( test.poolProxy().lookup( ResKind::package, "candidate" ) );
+  BOOST_CHECK_EQUAL( kept, sel );
+  BOOST_CHECK_EQUAL( kept->candidateObj(), other );
+
+  // a changed priority of one of its repos changes its range: a new Selectable
+  Repository repo( other.repository() );
+  RepoInfo info( repo.info() );
+  info.setPriority( info.priority() + 1 );
+  repo.setInfo( info );
+  ui::Selectable::Ptr renewed( test.poolProxy().lookup( ResKind::package, "candidate" ) );
+  BOOST_REQUIRE( renewed );
+  BOOST_CHECK( renewed != sel );
+  BOOST_CHECK_EQUAL( renewed->availableSize(), sel->availableSize() );
+}
+
+/////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+#include "TestSetup.h"
+#include <atomic>
+#include <thread>
+#include <zypp/ResPool.h>
+#include <zypp/ResPoolProxy.h>
+#include <zypp/pool/StatusStore.h>
+
+#define BOOST_TEST_MODULE StatusStore
+
+using zypp::pool::StatusStore;
+
+BOOST_AUTO_TEST_CASE(store)
+{
+  StatusStore store;
+  BOOST_CHECK_EQUAL( store.size(), 0 );
+  store.grow( StatusStore::blockSize + 1 );
+  BOOST_CHECK_EQUAL( store.size(), 2*StatusStore::blockSize );
+
+  ResStatus & installed { store.init( 3, true ) };
+  ResStatus & other { store.init( StatusStore::blockSize + 1, false ) };
+  BOOST_CHECK( installed.isInstalled() );
+  BOOST_CHECK( StatusStore::saved( installed ).isInstalled() );
+
+  // slots don't move when the store grows
+  store.grow( 10*StatusStore::blockSize );
+  BOOST_CHECK_EQUAL( &store[3], &installed );
+
+  BOOST_CHECK( installed.setToBeUninstalled( ResStatus::USER ) );
+  BOOST_CHECK( other.setLock( true, ResStatus::USER ) );
+  BOOST_CHECK( store.transacting()[3] );
+  BOOST_CHECK( ! store.transacting()[StatusStore::blockSize + 1] );
+  BOOST_CHECK( store.locked()[StatusStore::blockSize + 1] );
+  BOOST_CHECK( store.byUser()[3] );
+  BOOST_CHECK_EQUAL( store.count( []( const ResStatus & s ) { return s.transacts(); } ), 1 );
+
+  // save/restore
+  store.saveState();
+  BOOST_CHECK( ! store.diffState() );
+  store.resetTransact( ResStatus::USER );
+  BOOST_CHECK( ! installed.transacts() );
+  BOOST_CHECK( ! store.diffState() );	// solver state changes are ignored
+  BOOST_CHECK( other.setLock( false, ResStatus::USER ) );
+  BOOST_CHECK( store.diffState() );
+  store.restoreState();
+  BOOST_CHECK( installed.transacts() );
+  BOOST_CHECK( other.isLocked() );
+  BOOST_CHECK( ! store.diffState() );
+
+  // detach
+  ResStatus * detached { StatusStore::detach( installed ) };
+  BOOST_CHECK( detached->transacts() );
+  BOOST_CHECK( StatusStore::saved( *detached ).transacts() );
+  BOOST_CHECK( installed == ResStatus() );
+  BOOST_CHECK( ! store.transacting()[3] );
+  StatusStore::release( detached );
+}
+
+BOOST_AUTO_TEST_CASE(detached_slots)
+{
+  // slots outside a store are shared by all threads
+  std::atomic<unsigned> failed { 0 };
+  auto worker = [&]() {
+    std::vector<ResStatus *> slots;
+    for ( unsigned i = 0; i < 10000; ++i )
+    {
+      slots.push_back( StatusStore::detached() );
+      slots.back()->setLock( true, ResStatus::USER );
+      if ( i % 3 == 0 )
+      {
+        StatusStore::release( slots.back() );
+        slots.pop_back();
+      }
+    }
+    for ( ResStatus * slot : slots )
+    {
+      if ( ! slot->isLocked() )
+        ++failed;
+      StatusStore::release( slot );
+    }
+  };
+  std::vector<std::thread> threads;
+  for ( unsigned i = 0; i < 4; ++i )
+    threads.push_back( std::thread( worker ) );
+  for ( std::thread & t : threads )
+    t.join();
+  BOOST_CHECK_EQUAL( failed.load(), 0U );
+}
+
+BOOST_AUTO_TEST_CASE(pool_items)
+{
+  TestSetup test( Arch_x86_64 );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "opensuse" );
+  ResPool pool { ResPool::instance() };
+
+  PoolItem pi { *pool.byIdentBegin( ResKind::package, "zypper" ) };
+  BOOST_REQUIRE( pi );
+  BOOST_CHECK_EQUAL( &pool.statusStore()[pi.id()], &pi.status() );
+
+  pool.proxy().saveState();
+  BOOST_CHECK( pi.status().setToBeInstalled( ResStatus::USER ) );
+  BOOST_CHECK( pool.statusStore().transacting()[pi.id()] );
+  BOOST_CHECK( pool.proxy().diffState() );
+  pool.proxy().restoreState();
+  BOOST_CHECK( ! pi.status().transacts() );
+
+  // an item dropped from the pool keeps its status
+  BOOST_CHECK( pi.status().setToBeInstalled( ResStatus::USER ) );
+  sat::detail::SolvableIdType id { pi.id() };
+  pi.repository().eraseFromPool();
+  BOOST_CHECK( ! pool.statusStore().transacting()[id] );
+  BOOST_CHECK( pi.status().transacts() );
+}
@@ -142,6 +142,49 @@ BOOST_AUTO_TEST_CASE(StrMatcher_GLOB)
   BOOST_CHECK( !m( "default" ) );
 }
 
+BOOST_AUTO_TEST_CASE(StrMatcher_NOCASE)
+{
+  // long enough to use the vectorized kernel
+  std::string hay( "a pretty long string to search in, containing FauLt somewhere" );
+  StrMatcher m( "fault", Match::SUBSTRING | Match::NOCASE );
+  BOOST_CHECK( m( hay ) );
+  BOOST_CHECK( !m( "a pretty long string to search in, containing Faul t somewhere" ) );
+  BOOST_CHECK( m( "FAULT" ) );
+  BOOST_CHECK( !m( "FAUL" ) );
+
+  m.setFlags( Match::STRING | Match::NOCASE );
+  BOOST_CHECK( m( "FAULT" ) );
+  BOOST_CHECK( !m( "FAULTS" ) );
+
+  m.setFlags( Match::STRINGSTART | Match::NOCASE );
+  BOOST_CHECK( m( "FAULTS" ) );
+  BOOST_CHECK( !m( "FAUL" ) );
+
+  m.setFlags( Match::STRINGEND | Match::NOCASE );
+  BOOST_CHECK( m( "deFAULT" ) );
+  BOOST_CHECK( !m( "faulty" ) );
+
+  m.setSearchstring( "f*L?", Match::GLOB | Match::NOCASE );
+  BOOST_CHECK( m( "FAULT" ) );
+  BOOST_CHECK( m( "flt" ) );
+  BOOST_CHECK( !m( "fl" ) );
+}
+
+BOOST_AUTO_TEST_CASE(StrMatcher_GLOB_wildcards)
+{
+  StrMatcher m( "*lib*/[!x]?.so\\*", Match::GLOB );
+  BOOST_CHECK( m( "/usr/lib64/ab.so*" ) );
+  BOOST_CHECK( m( "lib/ab.so*" ) );
+  BOOST_CHECK( !m( "/usr/lib64/xb.so*" ) );
+  BOOST_CHECK( !m( "/usr/lib64/ab.so" ) );
+  BOOST_CHECK( !m( "/usr/lib64/ab.sox" ) );
+
+  // not handled by our own kernel, but must work the same
+  m.setSearchstring( "[[:digit:]]*" );
+  BOOST_CHECK( m( "1a" ) );
+  BOOST_CHECK( !m( "a1" ) );
+}
+
 BOOST_AUTO_TEST_CASE(StrMatcher_REGEX)
 {
   // REGEX matches substring (unless anchored)
@@ -12,6 +12,9 @@
 #include <zypp/ZYpp.h>
 #include <zypp/ZYppFactory.h>
 #include <zypp/TmpPath.h>
+#include <zypp/ExternalProgram.h>
+#include <zypp/PublicKey.h>
+#include <zypp/target/rpm/RpmDb.h>
 
 using boost::unit_test::test_case;
 using namespace zypp;
@@ -54,3 +57,29 @@ BOOST_AUTO_TEST_CASE(target_test)
     BOOST_CHECK_EQUAL( dlabel.summary, "A cool distribution" );
     BOOST_CHECK_EQUAL( dlabel.shortName, "" );
 }
+
+BOOST_AUTO_TEST_CASE(rpmdb_system_repo_state)
+{
+    filesystem::TmpDir tmp;
+    ZYpp::Ptr z = getZYpp();
+    z->initializeTarget( tmp.path() );
+    z->target()->load();
+
+    target::rpm::RpmDb & rpmdb( z->target()->rpmDb() );
+    BOOST_CHECK( rpmdb.systemRepoIsCurrent() );
+    BOOST_CHECK( rpmdb.systemRepoIsCurrent() );	// cached
+
+    // changed via RpmDb
+    rpmdb.importPubkey( PublicKey( Pathname(TESTS_SRC_DIR) / "/repo/yum/data/10.2-updates-subset/repodata/repomd.xml.key" ) );
+    BOOST_CHECK( ! rpmdb.systemRepoIsCurrent() );
+
+    z->target()->load();
+    BOOST_CHECK( rpmdb.systemRepoIsCurrent() );
+
+    // changed by an external rpm call
+    const char * argv[] = { "rpm", "--root", tmp.path().c_str(), "--import",
+                            TESTS_SRC_DIR "/repo/RepoSigcheck/signed_repo/repodata/repomd.xml.key", nullptr };
+    ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
+    BOOST_REQUIRE_EQUAL( prog.close(), 0 );
+    BOOST_CHECK( ! rpmdb.systemRepoIsCurrent() );
+}
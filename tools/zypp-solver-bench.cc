@@ -0,0 +1,460 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "../tests/lib/TestSetup.h"
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "argparse.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+
+#include <zypp/base/Json.h>
+#include <zypp/ResolverStatistics.h>
+#include <zypp/misc/LoadTestcase.h>
+#include <zypp/sat/Transaction.h>
+#include <zypp/ui/Selectable.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace zypp::misc::testcase;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... TESTCASE..." << endl;
+  cerr << "    Replay solver testcases and report the median load, prepare, solve and" << endl;
+  cerr << "    transaction times (in us) and the peak RSS (in KiB) as JSON. Prepare" << endl;
+  cerr << "    is the resolvers pool preparation (whatprovides), solve the remaining" << endl;
+  cerr << "    resolvePool time. Each testcase is replayed in a child process, so the" << endl;
+  cerr << "    peak RSS is the one of this testcase." << endl;
+  cerr << "    A TESTCASE directory not containing a testcase is scanned for testcase" << endl;
+  cerr << "    subdirectories. Compared to a --baseline (a previous JSON report) the" << endl;
+  cerr << "    exit code is 1 if any value exceeds the baseline by more than the" << endl;
+  cerr << "    threshold." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  inline long long usSince( Clock::time_point start_r )
+  { return std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start_r ).count(); }
+
+  /** The measured phases (in the order they are reported). */
+  const std::vector<std::string> phases { "load", "prepare", "solve", "transaction" };
+
+  /** Results of one testcase. */
+  struct Result
+  {
+    std::string _name;
+    bool _solved = false;
+    unsigned _skippedJobs = 0;
+    std::map<std::string,std::vector<long long>> _times;	///< per phase and run
+    long long _peakRss = 0;	///< of the process replaying the testcase
+
+    static long long median( std::vector<long long> vals_r )
+    {
+      if ( vals_r.empty() )
+        return 0;
+      std::sort( vals_r.begin(), vals_r.end() );
+      return vals_r[vals_r.size()/2];
+    }
+
+    long long value( const std::string & key_r ) const
+    {
+      if ( key_r == "peakRss" )
+        return _peakRss;
+      auto it = _times.find( key_r );
+      return it == _times.end() ? 0 : median( it->second );
+    }
+
+    std::string asJSON() const
+    {
+      json::Object ret {
+        { "name",	_name },
+        { "solved",	_solved },
+        { "skippedJobs",_skippedJobs },
+        { "peakRss",	_peakRss },
+      };
+      for ( const std::string & phase : phases )
+        ret.add( phase, value( phase ) );
+      return ret.asJSON();
+    }
+
+    /** Counterpart of \ref asJSON (the medians are taken as single run). */
+    static Result fromJSON( const YAML::Node & node_r )
+    {
+      Result ret;
+      ret._name = node_r["name"].as<std::string>();
+      ret._solved = node_r["solved"].as<bool>();
+      ret._skippedJobs = node_r["skippedJobs"].as<unsigned>();
+      ret._peakRss = node_r["peakRss"].as<long long>();
+      for ( const std::string & phase : phases )
+        ret._times[phase].push_back( node_r[phase].as<long long>() );
+      return ret;
+    }
+  };
+
+  /** Find the item a trial job refers to. */
+  PoolItem findItem( const TestcaseTrial::Node & node_r, bool installed_r )
+  {
+    ui::Selectable::Ptr sel { ui::Selectable::get( ResKind( node_r.getProp( "kind", "package" ) ), node_r.getProp( "name" ) ) };
+    if ( ! sel )
+      return PoolItem();
+    if ( installed_r )
+      return sel->installedObj();
+
+    const std::string & channel { node_r.getProp( "channel" ) };
+    const std::string & arch { node_r.getProp( "arch" ) };
+    const std::string & version { node_r.getProp( "version" ) };
+    if ( channel.empty() && arch.empty() && version.empty() )
+      return sel->candidateObj();
+    for ( const PoolItem & pi : sel->available() )
+    {
+      if ( ( channel.empty() || pi.repoInfo().alias() == channel )
+        && ( arch.empty() || pi.arch().asString() == arch )
+        && ( version.empty() || pi.edition().version() == version ) )
+        return pi;
+    }
+    return PoolItem();
+  }
+
+  /** Apply a trial job to the pool and resolver. Returns \c false if the job is not supported. */
+  bool applyJob( const TestcaseTrial::Node & node_r, Resolver & resolver_r )
+  {
+    const std::string & job { node_r.name() };
+    if ( job == "install" )
+    {
+      PoolItem pi { findItem( node_r, false ) };
+      return pi && pi.status().setToBeInstalled( ResStatus::USER );
+    }
+    if ( job == "uninstall" )
+    {
+      PoolItem pi { findItem( node_r, true ) };
+      return pi && pi.status().setToBeUninstalled( ResStatus::USER );
+    }
+    if ( job == "lock" )
+    {
+      PoolItem pi { findItem( node_r, node_r.getProp( "channel" ) == "@System" ) };
+      return pi && pi.status().setLock( true, ResStatus::USER );
+    }
+    if ( job == "addRequire" )
+      resolver_r.addRequire( Capability( node_r.getProp( "name" ) ) );
+    else if ( job == "addConflict" )
+      resolver_r.addConflict( Capability( node_r.getProp( "name" ) ) );
+    else if ( job == "upgradeRepo" )
+    {
+      Repository repo { sat::Pool::instance().reposFind( node_r.getProp( "name" ) ) };
+      if ( ! repo )
+        return false;
+      resolver_r.addUpgradeRepo( repo );
+    }
+    else if ( job == "distupgrade" )
+      resolver_r.setUpgradeMode( true );
+    else if ( job == "update" )
+      resolver_r.setUpdateMode( true );
+    else if ( job == "verify" )
+      resolver_r.setSystemVerification( true );
+    else
+      return false;
+    return true;
+  }
+
+  /** Load, prepare and solve a testcase once (in this process). */
+  void runTestcase( const Pathname & path_r, Result & result_r )
+  {
+    Clock::time_point start { Clock::now() };
+    LoadTestcase loader;
+    std::string err;
+    if ( ! loader.loadTestcaseAt( path_r, &err ) )
+      ZYPP_THROW( Exception( err ) );
+    const TestcaseSetup & setup { loader.setupInfo() };
+
+    TestSetup test( setup.architecture() );
+    {
+      RepoManager repoManager { test.repomanager() };
+      if ( ! setup.applySetup( repoManager ) )
+        ZYPP_THROW( Exception( "Failed to apply setup of " + path_r.asString() ) );
+      base::SetTracker<LocaleSet> localesTracker = setup.localesTracker();
+      localesTracker.removed().insert( localesTracker.current().begin(), localesTracker.current().end() );
+      test.satpool().initRequestedLocales( localesTracker.removed() );
+      localesTracker.added().insert( localesTracker.current().begin(), localesTracker.current().end() );
+      test.satpool().setRequestedLocales( localesTracker.added() );
+      test.poolProxy();
+    }
+    result_r._times["load"].push_back( usSince( start ) );
+
+    Resolver & resolver { test.resolver() };
+    resolver.setFocus( setup.resolverFocus() );
+    resolver.setIgnoreAlreadyRecommended( setup.ignorealreadyrecommended() );
+    resolver.setOnlyRequires( setup.onlyRequires() );
+    resolver.setForceResolve( setup.forceResolve() );
+    resolver.setCleandepsOnRemove( setup.cleandepsOnRemove() );
+    resolver.setAllowDowngrade( setup.allowDowngrade() );
+    resolver.setAllowNameChange( setup.allowNameChange() );
+    resolver.setAllowArchChange( setup.allowArchChange() );
+    resolver.setAllowVendorChange( setup.allowVendorChange() );
+    resolver.dupSetAllowDowngrade( setup.dupAllowDowngrade() );
+    resolver.dupSetAllowNameChange( setup.dupAllowNameChange() );
+    resolver.dupSetAllowArchChange( setup.dupAllowArchChange() );
+    resolver.dupSetAllowVendorChange( setup.dupAllowVendorChange() );
+    unsigned skipped = 0;
+    for ( const TestcaseTrial & trial : loader.trialInfo() )
+    {
+      for ( const TestcaseTrial::Node & node : trial.nodes() )
+      {
+        if ( ! applyJob( node, resolver ) )
+        {
+          WAR << "Skip unsupported job " << node.name() << " " << node.getProp( "name" ) << endl;
+          ++skipped;
+        }
+      }
+    }
+    result_r._skippedJobs = skipped;
+
+    start = Clock::now();
+    if ( resolver.updateMode() )
+    {
+      resolver.doUpdate();
+      result_r._solved = true;
+    }
+    else
+      result_r._solved = resolver.resolvePool();
+    long long solve = usSince( start );
+    long long prepare = std::chrono::duration_cast<std::chrono::microseconds>( resolver.statistics().prepare ).count();
+    result_r._times["prepare"].push_back( prepare );
+    result_r._times["solve"].push_back( solve - prepare );
+
+    start = Clock::now();
+    if ( result_r._solved )
+    {
+      sat::Transaction trans { resolver.getTransaction() };
+      trans.order();
+    }
+    result_r._times["transaction"].push_back( usSince( start ) );
+  }
+
+  /** Replay a testcase \a runs_r times in a child process.
+   * The peak RSS is a high-water mark of the whole process, so it is taken
+   * from a process replaying just this testcase.
+   */
+  Result runTestcaseForked( const Pathname & path_r, unsigned runs_r )
+  {
+    int fds[2];
+    if ( ::pipe( fds ) != 0 )
+      ZYPP_THROW( Exception( "pipe: " + str::strerror( errno ) ) );
+    pid_t pid = ::fork();
+    if ( pid < 0 )
+      ZYPP_THROW( Exception( "fork: " + str::strerror( errno ) ) );
+
+    if ( pid == 0 )
+    {
+      // child: report the result as JSON
+      ::close( fds[0] );
+      int ret = 0;
+      try
+      {
+        Result res;
+        res._name = path_r.basename();
+        for ( unsigned run = 0; run < runs_r; ++run )
+          runTestcase( path_r, res );
+        const std::string & json { res.asJSON() };
+        for ( std::string::size_type done = 0; done < json.size(); )
+        {
+          ssize_t cnt = ::write( fds[1], json.data() + done, json.size() - done );
+          if ( cnt <= 0 && errno != EINTR )
+            ::_exit( 2 );
+          if ( cnt > 0 )
+            done += cnt;
+        }
+      }
+      catch ( const Exception & excpt )
+      {
+        cerr << appname << ": ERR: " << path_r << ": " << excpt.asUserString() << endl;
+        ret = 1;
+      }
+      ::_exit( ret );
+    }
+
+    ::close( fds[1] );
+    std::string json;
+    char buf[4096];
+    for ( ssize_t cnt; ( cnt = ::read( fds[0], buf, sizeof(buf) ) ) != 0; )
+    {
+      if ( cnt > 0 )
+        json.append( buf, cnt );
+      else if ( errno != EINTR )
+        break;
+    }
+    ::close( fds[0] );
+
+    int status = 0;
+    struct rusage usage;
+    if ( ::wait4( pid, &status, 0, &usage ) != pid || ! WIFEXITED( status ) || WEXITSTATUS( status ) != 0 || json.empty() )
+      ZYPP_THROW( Exception( "Failed to replay " + path_r.asString() ) );
+
+    Result ret { Result::fromJSON( YAML::Load( json ) ) };
+    ret._peakRss = usage.ru_maxrss;
+    return ret;
+  }
+
+  /** Testcase directories below \a path_r (itself or its subdirectories). */
+  std::vector<Pathname> findTestcases( const Pathname & path_r )
+  {
+    std::vector<Pathname> ret;
+    if ( TestSetup::isTestcase( path_r ) )
+      ret.push_back( path_r );
+    else
+    {
+      std::list<std::string> entries;
+      filesystem::readdir( entries, path_r, false );
+      entries.sort();
+      for ( const std::string & entry : entries )
+      {
+        if ( TestSetup::isTestcase( path_r / entry ) )
+          ret.push_back( path_r / entry );
+      }
+    }
+    return ret;
+  }
+
+  /** Compare against a baseline report. Returns the number of regressions. */
+  unsigned compareBaseline( const std::vector<Result> & results_r, const Pathname & baseline_r, double threshold_r, long long minDelta_r )
+  {
+    YAML::Node baseline { YAML::LoadFile( baseline_r.asString() ) };	// JSON is YAML
+    std::map<std::string,YAML::Node> base;
+    for ( const YAML::Node & node : baseline["testcases"] )
+      base[node["name"].as<std::string>()] = node;
+
+    std::vector<std::string> keys { phases };
+    keys.push_back( "peakRss" );
+
+    unsigned regressions = 0;
+    for ( const Result & result : results_r )
+    {
+      auto it = base.find( result._name );
+      if ( it == base.end() )
+      {
+        cerr << result._name << ": not in baseline" << endl;
+        continue;
+      }
+      for ( const std::string & key : keys )
+      {
+        if ( ! it->second[key] )
+          continue;
+        long long was = it->second[key].as<long long>();
+        long long is = result.value( key );
+        if ( is - was > minDelta_r && is > was * ( 1.0 + threshold_r / 100.0 ) )
+        {
+          cerr << result._name << ": " << key << " regressed from " << was << " to " << is
+               << str::form( " (+%.1f%%)", was ? 100.0 * ( is - was ) / was : 100.0 ) << endl;
+          ++regressions;
+        }
+      }
+    }
+    return regressions;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",		"Print help and exit." )
+    ( "runs,n",		"Replay each testcase N times (default 3).", argparse::Option::Arg::required )
+    ( "output,o",	"Write the JSON report to FILE instead of stdout.", argparse::Option::Arg::required )
+    ( "baseline,b",	"Compare against the JSON report in FILE.", argparse::Option::Arg::required )
+    ( "threshold,t",	"Allowed increase over the baseline in percent (default 10).", argparse::Option::Arg::required )
+    ( "min-delta",	"Ignore increases below this absolute value (default 1000).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  unsigned runs = result.count( "runs" ) ? str::strtonum<unsigned>( result["runs"].arg() ) : 3;
+  double threshold = result.count( "threshold" ) ? str::strtonum<double>( result["threshold"].arg() ) : 10.0;
+  long long minDelta = result.count( "min-delta" ) ? str::strtonum<long long>( result["min-delta"].arg() ) : 1000;
+  if ( ! runs )
+    return errexit( "--runs must be at least 1" );
+
+  std::vector<Pathname> testcases;
+  for ( const std::string & arg : result.positionals() )
+  {
+    std::vector<Pathname> found { findTestcases( arg ) };
+    if ( found.empty() )
+      return errexit( "No testcase found at " + arg );
+    testcases.insert( testcases.end(), found.begin(), found.end() );
+  }
+  if ( testcases.empty() )
+    return usage( options, 100 );
+
+  // go...
+  std::vector<Result> results;
+  for ( const Pathname & testcase : testcases )
+  {
+    Result res;
+    try
+    {
+      res = runTestcaseForked( testcase, runs );
+    }
+    catch ( const Exception & excpt )
+    {
+      return errexit( testcase.asString() + ": " + excpt.asUserString() );
+    }
+    catch ( const YAML::Exception & excpt )
+    {
+      return errexit( testcase.asString() + ": Unexpected result: " + std::string( excpt.what() ) );
+    }
+    cerr << res._name << ": " << ( res._solved ? "solved" : "problems" ) << endl;
+    results.push_back( std::move(res) );
+  }
+
+  json::Object report {
+    { "runs",		runs },
+    { "testcases",	json::Array( results.begin(), results.end() ) },
+  };
+  if ( result.count( "output" ) )
+  {
+    std::ofstream out( result["output"].arg() );
+    out << report << endl;
+    if ( ! out )
+      return errexit( "Can't write " + result["output"].arg() );
+  }
+  else
+    cout << report << endl;
+
+  if ( result.count( "baseline" ) )
+  {
+    try
+    {
+      if ( compareBaseline( results, result["baseline"].arg(), threshold, minDelta ) )
+        return 1;
+    }
+    catch ( const YAML::Exception & excpt )
+    {
+      return errexit( "Can't read baseline: " + std::string( excpt.what() ) );
+    }
+  }
+  return 0;
+}
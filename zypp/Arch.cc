@@ -11,6 +11,7 @@
 */
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <inttypes.h>
 
 #include <zypp/base/Logger.h>
@@ -122,7 +123,7 @@ namespace zypp
 
   /** \relates Arch::CompatEntry */
   inline bool operator==( const Arch::CompatEntry & lhs, const Arch::CompatEntry & rhs )
-  { return lhs._idStr == rhs._idStr; }
+  { return lhs._archStr == rhs._archStr; }
   /** \relates Arch::CompatEntry */
   inline bool operator!=( const Arch::CompatEntry & lhs, const Arch::CompatEntry & rhs )
   { return ! ( lhs == rhs ); }
@@ -131,7 +132,15 @@ namespace zypp
 } // namespace zypp
 ///////////////////////////////////////////////////////////////////
 
-ZYPP_DEFINE_ID_HASHABLE( zypp::Arch::CompatEntry );
+namespace std
+{
+  /** Hashed by string, as ids are not unique across \ref zypp::PoolContext pools. */
+  template<> struct hash<zypp::Arch::CompatEntry>
+  {
+    size_t operator()( const zypp::Arch::CompatEntry & obj_r ) const
+    { return hash<std::string>()( obj_r._archStr ); }
+  };
+} // namespace std
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -259,10 +268,16 @@ namespace zypp
        * Creates an entry for nonbuiltin archs.
       */
       const Arch::CompatEntry & assertDef( const std::string & archStr_r )
-      { return *_compatSet.insert( Arch::CompatEntry( archStr_r ) ).first; }
+      {
+        std::lock_guard<std::mutex> guard( _mutex );
+        return *_compatSet.insert( Arch::CompatEntry( archStr_r ) ).first;
+      }
       /** \overload */
       const Arch::CompatEntry & assertDef( IdString archStr_r )
-      { return *_compatSet.insert( Arch::CompatEntry( archStr_r ) ).first; }
+      {
+        std::lock_guard<std::mutex> guard( _mutex );
+        return *_compatSet.insert( Arch::CompatEntry( archStr_r ) ).first;
+      }
 
       const_iterator begin() const
       { return _compatSet.begin(); }
@@ -425,6 +440,7 @@ namespace zypp
 
     private:
       Set _compatSet;
+      std::mutex _mutex;	///< Guards \ref assertDef, called from any thread.
     };
 
     /////////////////////////////////////////////////////////////////
@@ -475,7 +491,11 @@ namespace zypp
   //	METHOD TYPE : IdString
   //
   IdString Arch::idStr() const
-  { return _entry->_idStr; }
+  {
+    // Builtins are interned at startup and adopted by each PoolContext,
+    // a nonbuiltins id is the one of the current pool.
+    return( _entry->isBuiltIn() ? _entry->_idStr : IdString( _entry->_archStr ) );
+  }
 
   ///////////////////////////////////////////////////////////////////
   //
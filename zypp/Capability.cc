@@ -59,8 +59,8 @@ namespace zypp
       return pos_r;
     }
 
-    /** Split any 'op edition' from str_r */
-    void splitOpEdition( std::string & str_r, Rel & op_r, Edition & ed_r )
+    /** Split any 'op edition' from str_r (\a ed_r is left empty if there is none). */
+    void splitOpEdition( std::string & str_r, Rel & op_r, std::string & ed_r )
     {
       if ( str_r.empty() )
         return;
@@ -80,7 +80,7 @@ namespace zypp
             if ( op_r.parseFrom( str_r.substr( ch+1, oe-ch ) ) )
             {
               // found a legal 'op'
-              ed_r = Edition( str_r.substr( eb+1, ee-eb ) );
+              ed_r = str_r.substr( eb+1, ee-eb );
               if ( ch != std::string::npos ) // 'op' is not at str_r begin, so skip WS
                 ch = backskipWs( str_r, ch );
               str_r.erase( ch+1 );
@@ -100,7 +100,7 @@ namespace zypp
         // do edition first:
         ch = str_r.find_first_not_of( " \t", oe+1 );
         if ( ch != std::string::npos )
-          ed_r = Edition( str_r.substr( ch ) );
+          ed_r = str_r.substr( ch );
 
         // now finish op:
         ch = oe-1;
@@ -132,6 +132,28 @@ namespace zypp
       // HERE: It's a plain 'name'
     }
 
+    /** \overload */
+    void splitOpEdition( std::string & str_r, Rel & op_r, Edition & ed_r )
+    {
+      std::string ed;
+      splitOpEdition( str_r, op_r, ed );
+      if ( ! ed.empty() )
+        ed_r = Edition( ed );
+    }
+
+    /** Id of \a str_r if it is known to the pool (\c noId otherwise). */
+    inline sat::detail::IdType lookupStr( sat::detail::CPool * pool_r, const std::string & str_r )
+    { return ::pool_str2id( pool_r, str_r.c_str(), /*create*/false ); }
+
+    /** Id of a relation, created unless the pool is frozen (\c noId then). */
+    inline sat::detail::IdType lookupRel( sat::detail::CPool * pool_r, sat::detail::IdType name_r, sat::detail::IdType evr_r, int flags_r )
+    {
+      sat::detail::IdType ret = ::pool_rel2id( pool_r, name_r, evr_r, flags_r, /*create*/false );
+      if ( ! ret && ! sat::detail::PoolMember::myPool().frozen() )
+        ret = sat::detail::PoolMember::myPool().rel2id( name_r, evr_r, flags_r );
+      return ret;
+    }
+
     /** Build \ref Capability from data. No parsing required.
     */
     sat::detail::IdType relFromStr( sat::detail::CPool * pool_r,
@@ -149,19 +171,19 @@ namespace zypp
       {
         // map 'kind srcpackage' to 'arch src', the pseudo architecture
         // libsolv uses.
-        nid = ::pool_rel2id( pool_r, nid, IdString(ARCH_SRC).id(), REL_ARCH, /*create*/true );
+        nid = sat::detail::PoolMember::myPool().rel2id( nid, IdString(ARCH_SRC).id(), REL_ARCH );
       }
 
       // Extend name by architecture, if provided and not a srcpackage
       if ( ! arch_r.empty() && kind_r != ResKind::srcpackage )
       {
-        nid = ::pool_rel2id( pool_r, nid, arch_r.id(), REL_ARCH, /*create*/true );
+        nid = sat::detail::PoolMember::myPool().rel2id( nid, arch_r.id(), REL_ARCH );
       }
 
       // Extend 'op edition', if provided
       if ( op_r != Rel::ANY && ed_r != Edition::noedition )
       {
-        nid = ::pool_rel2id( pool_r, nid, ed_r.id(), op_r.bits(), /*create*/true );
+        nid = sat::detail::PoolMember::myPool().rel2id( nid, ed_r.id(), op_r.bits() );
       }
 
       return nid;
@@ -304,13 +326,21 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
 
   Capability::Capability( ResolverNamespace namespace_r, IdString value_r )
-  : _id( ::pool_rel2id( myPool().getPool(), asIdString(namespace_r).id(), (value_r.empty() ? STRID_NULL : value_r.id() ), REL_NAMESPACE, /*create*/true ) )
+  : _id( myPool().rel2id( asIdString(namespace_r).id(), (value_r.empty() ? STRID_NULL : value_r.id() ), REL_NAMESPACE ) )
   {}
 
 
   const char * Capability::c_str() const
   { return( _id ? ::pool_dep2str( myPool().getPool(), _id ) : "" ); }
 
+  std::string Capability::asString() const
+  {
+    if ( ! ISRELDEP( _id ) )
+      return c_str();
+    auto guard( myPool().frozenLock() );
+    return c_str();
+  }
+
   CapMatch Capability::_doMatch( sat::detail::IdType lhs,  sat::detail::IdType rhs )
   {
     if ( lhs == rhs )
@@ -372,6 +402,59 @@ namespace zypp
     return str::regex_match( name_r, what, filenameRegex );
   }
 
+  Capability Capability::lookup( const std::string & str_r )
+  {
+    static const std::string srcKindPrefix( ResKind::srcpackage.asString() + ':' );
+    sat::detail::CPool * pool = myPool().getPool();
+
+    std::string name( str_r );
+    Rel         op;
+    std::string ed;
+    splitOpEdition( name, op, ed );
+
+    // Name, '[.arch]' and kind as parsed by the ctor
+    sat::detail::IdType arch = sat::detail::noId;
+    if ( str::hasPrefix( name, srcKindPrefix ) )
+    {
+      name.erase( 0, srcKindPrefix.size() );
+      arch = ARCH_SRC;
+    }
+    else
+    {
+      std::string::size_type asep( name.rfind( "." ) );
+      if ( asep != std::string::npos )
+      {
+        // builtin archs are always known to the pool
+        sat::detail::IdType ext = lookupStr( pool, name.substr( asep+1 ) );
+        if ( ext && ( ext == ARCH_SRC || Arch( IdString(ext) ).isBuiltIn() ) )
+        {
+          arch = ext;
+          name.erase( asep );
+        }
+      }
+      ResKind explicitKind( ResKind::explicitBuiltin( name ) );
+      if ( explicitKind == ResKind::package || explicitKind == ResKind::srcpackage )
+        name.erase( 0, name.find( ':' )+1 );
+    }
+
+    // An unknown name is not provided by anything
+    sat::detail::IdType ret = lookupStr( pool, name );
+    if ( ! ret )
+      return Capability::Null;
+
+    if ( arch )
+      ret = lookupRel( pool, ret, arch, REL_ARCH );
+
+    if ( ret && op != Rel::ANY && ! ed.empty() )
+    {
+      sat::detail::IdType evr = lookupStr( pool, ed );
+      if ( ! evr && ! myPool().frozen() )
+        evr = Edition( ed ).id();
+      ret = evr ? lookupRel( pool, ret, evr, op.bits() ) : sat::detail::noId;
+    }
+    return Capability( ret );
+  }
+
   Capability Capability::guessPackageSpec( const std::string & str_r, bool & rewrote_r )
   {
     Capability cap( str_r );
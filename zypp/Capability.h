@@ -151,12 +151,15 @@ namespace zypp
       { return( _id == sat::detail::emptyId || _id == sat::detail::noId ); }
 
     public:
-      /** Conversion to <tt>const char *</tt> */
+      /** Conversion to <tt>const char *</tt>
+       * \note Dependency expressions are composed in libsolvs temporary
+       * buffers. On a \ref sat::Pool::freeze "frozen" pool accessed by many
+       * threads use \ref asString.
+       */
       const char * c_str() const;
 
       /** \overload */
-      std::string asString() const
-      { return c_str(); }
+      std::string asString() const;
 
     public:
       /** Helper providing more detailed information about a \ref Capability. */
@@ -248,6 +251,13 @@ namespace zypp
        */
       static Capability guessPackageSpec( const std::string & str_r, bool & rewrote_r );
 
+      /** The \ref Capability parsed from \a str_r, without adding its name to the pool.
+       * Parsed like the ctor does, but an unknown name yields \ref Null, as
+       * nothing can provide it. Edition and relation are created for known
+       * names, unless the pool is frozen (\ref Null then, if unknown).
+       */
+      static Capability lookup( const std::string & str_r );
+
     public:
       /** Expert backdoor. */
       sat::detail::IdType id() const
@@ -10,6 +10,7 @@
  *
 */
 #include <iostream>
+#include <mutex>
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
@@ -40,11 +41,11 @@ namespace zypp
       /** Lookup (translated) name for \a index_r.*/
       std::string name( IdString index_r )
       {
-	Link link( getIndex( index_r ) );
+	const char * text = getText( index_r.asString() );
 
 	std::string ret;
-	if ( link->second )
-	{ ret = _(link->second); }
+	if ( text )
+	{ ret = _(text); }
 	else
 	{
 	  ret = _("Unknown country: ");
@@ -59,28 +60,20 @@ namespace zypp
       typedef std::unordered_map<std::string,const char *> CodeMap;
       typedef CodeMap::const_iterator Link;
 
-      typedef std::unordered_map<IdString,Link> IndexMap;
-
       /** Ctor initializes the code maps.
        * http://www.iso.org/iso/en/prods-services/iso3166ma/02iso-3166-code-lists/list-en1.html
        */
       CodeMaps();
 
-      /** Return \ref Link for \a index_r, creating it if necessary. */
-      Link getIndex( IdString index_r )
-      {
-	auto it = _indexMap.find( index_r );
-	return( it != _indexMap.end()
-	      ? it->second
-	      : newIndex( index_r, index_r.asString() ) );
-      }
-
-      /** Return the CodeMap Index for \a code_r. */
-      Link newIndex( IdString index_r, const std::string & code_r )
+      /** Return the untranslated name for \a code_r (\c nullptr if unknown), remembering new codes.
+       * Keyed by string, as ids are not unique across \ref PoolContext pools.
+       */
+      const char * getText( const std::string & code_r )
       {
+	std::lock_guard<std::mutex> guard( _mutex );
 	Link link = _codeMap.find( code_r );
 	if ( link != _codeMap.end() )
-	  return (_indexMap[index_r] = link);
+	  return link->second;
 
 	// not found: Remember a new code
 	CodeMap::value_type nval( code_r, nullptr );
@@ -101,12 +94,12 @@ namespace zypp
 	  }
 	}
 	MIL << "Remember CountryCode '" << code_r << "': '" << (nval.second?nval.second:"Unknown country") << "'" << endl;
-	return (_indexMap[index_r] = _codeMap.insert( nval ).first);
+	return _codeMap.insert( nval ).first->second;
       }
 
     private:
       CodeMap _codeMap;
-      IndexMap _indexMap;
+      std::mutex _mutex;
     };
   } // namespace
   ///////////////////////////////////////////////////////////////////
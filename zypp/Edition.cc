@@ -117,6 +117,16 @@ namespace zypp
     return std::string();
   }
 
+  int Edition::_doCompareIds( const IdString & lhs, const IdString & rhs )
+  {
+    if ( unsigned lrank = myPool().evrRank( lhs.id() ) )
+    {
+      if ( unsigned rrank = myPool().evrRank( rhs.id() ) )
+        return( lrank == rrank ? 0 : lrank < rrank ? -1 : 1 );
+    }
+    return _doCompare( (lhs ? lhs.c_str() : (const char *)0 ), (rhs ? rhs.c_str() : (const char *)0 ) );
+  }
+
   int Edition::_doCompare( const char * lhs,  const char * rhs )
   {
     if ( lhs == rhs ) return 0;
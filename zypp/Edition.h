@@ -169,6 +169,8 @@ namespace zypp
       typedef Range<Edition, Match> MatchRange;
 
     private:
+      /** Use the pools EVR sort ranks if available (\see \ref sat::detail::PoolImpl::evrRank). */
+      static int _doCompareIds( const IdString & lhs, const IdString & rhs );
       static int _doCompare( const char * lhs,  const char * rhs );
       static int _doMatch( const char * lhs,  const char * rhs );
 
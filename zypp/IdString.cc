@@ -10,6 +10,7 @@
  *
 */
 #include <iostream>
+#include <cstring>
 #include <boost/mpl/int.hpp>
 
 #include <zypp/IdString.h>
@@ -29,11 +30,11 @@ namespace zypp
   /////////////////////////////////////////////////////////////////
 
   IdString::IdString( const char * str_r )
-  : _id( ::pool_str2id( myPool().getPool(), str_r, /*create*/true ) )
+  : _id( myPool().str2id( str_r, str_r ? ::strlen( str_r ) : 0 ) )
   {}
 
   IdString::IdString( const char * str_r, unsigned len_r )
-  : _id( ::pool_strn2id( myPool().getPool(), str_r, len_r, /*create*/true ) )
+  : _id( myPool().str2id( str_r, len_r ) )
   {}
 
   IdString::IdString( const std::string & str_r )
@@ -79,6 +79,10 @@ namespace zypp
    *    DBG << "na == a ? " << (na == "a") << endl;   // na == a ? 1
    *    DBG << "na == A ? " << (na == "A") << endl;   // na == A ? 1
    * \endcode
+   *
+   * Two \ref IdString are compared via \ref _doCompareIds, which by default
+   * passes their strings to \ref _doCompare. Redefine it if the Ids allow
+   * a shortcut (e.g. \ref Edition uses precomputed sort ranks).
    * \todo allow redefinition of order vis _doCompare not only for char* but on any level
    * \ingroup g_CRTP
    */
@@ -130,8 +134,7 @@ namespace zypp
       static int compare( const Derived & lhs,     const char * rhs )        { return compare( lhs.idStr(), rhs );}
 
       static int compare( const IdString & lhs,    const Derived & rhs )     { return compare( lhs, rhs.idStr() ); }
-      static int compare( const IdString & lhs,    const IdString & rhs )    { return lhs == rhs ? 0 : Derived::_doCompare( (lhs ? lhs.c_str() : (const char *)0 ),
-															    (rhs ? rhs.c_str() : (const char *)0 ) ); }
+      static int compare( const IdString & lhs,    const IdString & rhs )    { return lhs == rhs ? 0 : Derived::_doCompareIds( lhs, rhs ); }
       static int compare( const IdString & lhs,    const std::string & rhs ) { return compare( lhs, rhs.c_str() ); }
       static int compare( const IdString & lhs,    const char * rhs )        { return Derived::_doCompare( (lhs ? lhs.c_str() : (const char *)0 ), rhs ); }
 
@@ -153,6 +156,10 @@ namespace zypp
       int compare( const char * rhs )         const { return compare( idStr(), rhs ); }
 
     private:
+      /** Compare two different IdStrings. Derived may redefine it to take advantage of the Ids. */
+      static int _doCompareIds( const IdString & lhs, const IdString & rhs )
+      { return Derived::_doCompare( (lhs ? lhs.c_str() : (const char *)0 ), (rhs ? rhs.c_str() : (const char *)0 ) ); }
+
       static int _doCompare( const char * lhs,  const char * rhs )
       {
 	if ( ! lhs ) return rhs ? -1 : 0;
@@ -20,6 +20,11 @@ using std::endl;
 ///////////////////////////////////////////////////////////////////
 namespace zypp
 {
+  namespace
+  {
+    const IdString ptBR( sat::detail::constStr2id( "pt_BR" ) );
+  } // namespace
+
   /** Wrap static codemap data. */
   struct CodeMaps
   {
@@ -77,7 +82,7 @@ namespace zypp
 
     std::string name( IdString index_r )
     {
-      const LC & lc( getIndex( index_r ) );
+      LC lc( getIndex( index_r ) );
       std::string ret( lc._l.name() );
       if ( lc._c )
       {
@@ -90,13 +95,12 @@ namespace zypp
 
     Locale fallback( IdString index_r )
     {
-      static const IdString special( "pt_BR" );
       Locale ret;
-      if ( index_r == special )	// "pt_BR"->"en" - by now the only fallback exception
+      if ( index_r == ptBR )	// "pt_BR"->"en" - by now the only fallback exception
 	ret = Locale::enCode;
       else
       {
-	const LC & lc( getIndex( index_r ) );
+	LC lc( getIndex( index_r ) );
 	if ( lc._c )
 	  ret = lc._l;
 	else if ( lc._l && lc._l != LanguageCode::enCode )
@@ -128,42 +132,26 @@ namespace zypp
       LanguageCode _l;
       CountryCode  _c;
     };
-    typedef std::unordered_map<IdString,LC> CodeMap;
-
-    /** Ctor initializes the code maps. */
-    CodeMaps()
-    : _codeMap( { { IdString::Null,  LC( LanguageCode(IdString::Null),  CountryCode(IdString::Null) )  }
-                , { IdString::Empty, LC( LanguageCode(IdString::Empty), CountryCode(IdString::Empty) ) } } )
-    {}
 
-    /** Return \ref LC for \a index_r, creating it if necessary. */
-    const LC & getIndex( IdString index_r )
+    /** Return \ref LC for \a index_r.
+     * Not cached: Ids are not unique across \ref PoolContext pools, so a
+     * process wide map keyed by \ref IdString would mix them up.
+     */
+    static LC getIndex( IdString index_r )
     {
-      auto it = _codeMap.find( index_r );
-      if ( it == _codeMap.end() )
-      {
-	CodeMap::value_type newval( index_r, LC() );
-
-	boost::string_ref str( index_r.c_str() );
-	boost::string_ref::size_type sep = str.find( '_' );
-	if ( sep == boost::string_ref::npos )
-	  newval.second._l = LanguageCode( index_r );
-	else
-	{
-	  // bsc#1064999: dup! Creating a new IdString may invalidate the IdString.c_str() stored in str.
-	  std::string dup( str );
-	  str = dup;
-	  newval.second._l = LanguageCode( IdString(str.substr( 0, sep )) );
-	  newval.second._c = CountryCode( IdString(str.substr( sep+1 )) );
-	}
-
-	it = _codeMap.insert( std::move(newval) ).first;
-      }
-      return it->second;
+      if ( index_r.empty() )
+	return LC( LanguageCode(index_r), CountryCode(index_r) );	// Null or Empty
+
+      boost::string_ref str( index_r.c_str() );
+      boost::string_ref::size_type sep = str.find( '_' );
+      if ( sep == boost::string_ref::npos )
+	return LC( LanguageCode( index_r ) );
+
+      // bsc#1064999: dup! Creating a new IdString may invalidate the IdString.c_str() stored in str.
+      std::string dup( str );
+      str = dup;
+      return LC( LanguageCode( IdString(str.substr( 0, sep )) ), CountryCode( IdString(str.substr( sep+1 )) ) );
     }
-
-  private:
-    CodeMap _codeMap;
   };
 
   ///////////////////////////////////////////////////////////////////
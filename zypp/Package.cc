@@ -85,14 +85,17 @@ namespace zypp
   Package::~Package()
   {}
 
-  VendorSupportOption Package::vendorSupport() const
+  namespace
   {
-    static const IdString support_unsupported( "support_unsupported" );
-    static const IdString support_acc( "support_acc" );
-    static const IdString support_l1( "support_l1" );
-    static const IdString support_l2( "support_l2" );
-    static const IdString support_l3( "support_l3" );
+    const IdString support_unsupported( sat::detail::constStr2id( "support_unsupported" ) );
+    const IdString support_acc( sat::detail::constStr2id( "support_acc" ) );
+    const IdString support_l1( sat::detail::constStr2id( "support_l1" ) );
+    const IdString support_l2( sat::detail::constStr2id( "support_l2" ) );
+    const IdString support_l3( sat::detail::constStr2id( "support_l3" ) );
+  } // namespace
 
+  VendorSupportOption Package::vendorSupport() const
+  {
     VendorSupportOption ret( VendorSupportUnknown );
     // max over all identical packages
     for ( const auto & solv : sat::WhatProvides( (Capability(ident().id())) ) )
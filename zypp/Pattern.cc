@@ -24,9 +24,10 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace
   {
+    const Capability autopattern( sat::detail::constStr2id( "autopattern()" ) );
+
     inline Capability autoCapability( const Capabilities & provides_r )
     {
-      static const Capability autopattern( "autopattern()" );
       for ( const auto & cap : provides_r )
 	if ( cap.matches( autopattern ) == CapMatch::yes )
 	  return cap;
@@ -321,11 +322,12 @@ namespace zypp
       dependsSetDoCollect( depKeeper_r, Dep::SUGGESTS,	 collect_r.sug );
     }
 
+    const Capability patternIndicator( sat::detail::constStr2id( "pattern()" ) );
+
     // Whether this is a patterns depkeeper.
     inline bool isPatternsPackage( sat::Solvable depKeeper_r )
     {
-      static const Capability indicator( "pattern()" );
-      return depKeeper_r.provides().matches( indicator );
+      return depKeeper_r.provides().matches( patternIndicator );
     }
   } // namespace
   ///////////////////////////////////////////////////////////////////
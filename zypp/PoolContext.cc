@@ -0,0 +1,155 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/PoolContext.cc
+ */
+#include <iostream>
+#include <boost/enable_shared_from_this.hpp>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/pool/PoolImpl.h>
+#include <zypp/ResPool.h>
+#include <zypp/Resolver.h>
+#include <zypp/ZYppFactory.h>
+
+#include <zypp/PoolContext.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class PoolContext::Impl
+  /// \brief PoolContext implementation.
+  ///
+  /// The default context has neither a sat pool nor a ResPool of its
+  /// own; it refers to the global ones.
+  ///////////////////////////////////////////////////////////////////
+  class PoolContext::Impl : public boost::enable_shared_from_this<Impl>, private base::NonCopyable
+  {
+  public:
+    Impl()
+    {}
+
+    Impl( std::unique_ptr<sat::detail::PoolImpl> && satpool_r )
+    : _satpool( std::move(satpool_r) )
+    {}
+
+    ~Impl()
+    {
+      if ( ! _satpool )
+        return;
+      // Resolver and ResPool may still need their pool
+      sat::detail::PoolImpl * prev = sat::detail::PoolImpl::makeCurrent( _satpool.get() );
+      _resolver.reset();
+      _pool.reset();
+      sat::detail::PoolImpl::makeCurrent( prev );
+    }
+
+  public:
+    std::unique_ptr<sat::detail::PoolImpl> _satpool;	///< \c nullptr: the default pool
+    scoped_ptr<ResPool> _pool;				///< \c nullptr: the default pool
+    Resolver_Ptr _resolver;
+  };
+
+  namespace
+  {
+    /** The context current on this thread (\c nullptr: the default context). */
+    thread_local PoolContext::Impl * _currentContext = nullptr;
+  } // namespace
+
+  ///////////////////////////////////////////////////////////////////
+  //	class PoolContext
+  ///////////////////////////////////////////////////////////////////
+
+  PoolContext::PoolContext()
+  {
+    std::unique_ptr<sat::detail::PoolImpl> satpool( new sat::detail::PoolImpl );
+    satpool->adoptIds( sat::detail::PoolImpl::defaultPool() );
+    _pimpl.reset( new Impl( std::move(satpool) ) );
+    _pimpl->_pool.reset( new ResPool( pool::PoolTraits::Impl_Ptr( new pool::PoolImpl ) ) );
+    MIL << "New " << *this << endl;
+  }
+
+  PoolContext::PoolContext( const shared_ptr<Impl> & impl_r )
+  : _pimpl( impl_r )
+  {}
+
+  PoolContext::~PoolContext()
+  {}
+
+  bool PoolContext::isDefault() const
+  { return ! _pimpl->_satpool; }
+
+  bool PoolContext::isCurrent() const
+  { return isDefault() ? ! _currentContext : _currentContext == _pimpl.get(); }
+
+  ResPool PoolContext::pool() const
+  {
+    Scope scope( *this );
+    return ResPool::instance();
+  }
+
+  Resolver_Ptr PoolContext::resolver() const
+  {
+    if ( isDefault() )
+      return getZYpp()->resolver();
+    if ( ! _pimpl->_resolver )
+    {
+      Scope scope( *this );
+      _pimpl->_resolver = new Resolver( ResPool::instance() );
+    }
+    return _pimpl->_resolver;
+  }
+
+  PoolContext PoolContext::defaultContext()
+  {
+    static shared_ptr<Impl> _default( new Impl );
+    return PoolContext( _default );
+  }
+
+  PoolContext PoolContext::current()
+  {
+    if ( ! _currentContext )
+      return defaultContext();
+    // A current context is kept alive by its Scope.
+    return PoolContext( _currentContext->shared_from_this() );
+  }
+
+  const ResPool * PoolContext::currentPool()
+  { return _currentContext ? _currentContext->_pool.get() : nullptr; }
+
+  std::ostream & operator<<( std::ostream & str, const PoolContext & obj )
+  {
+    if ( obj.isDefault() )
+      return str << "PoolContext(default)";
+    return str << "PoolContext(" << obj._pimpl->_satpool.get() << ")";
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  //	class PoolContext::Scope
+  ///////////////////////////////////////////////////////////////////
+
+  PoolContext::Scope::Scope( const PoolContext & context_r )
+  : _context( context_r._pimpl )
+  , _prev( _currentContext )
+  {
+    _currentContext = _context->_satpool ? _context.get() : nullptr;
+    sat::detail::PoolImpl::makeCurrent( _context->_satpool.get() );
+  }
+
+  PoolContext::Scope::~Scope()
+  {
+    _currentContext = _prev;
+    sat::detail::PoolImpl::makeCurrent( _prev ? _prev->_satpool.get() : nullptr );
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/PoolContext.h
+ */
+#ifndef ZYPP_POOLCONTEXT_H
+#define ZYPP_POOLCONTEXT_H
+
+#include <iosfwd>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/base/PtrTypes.h>
+#include <zypp/ProblemTypes.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  class ResPool;
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class PoolContext
+  /// \brief An independent pool: its own \ref sat::Pool, \ref ResPool and \ref Resolver.
+  ///
+  /// Ids (\ref IdString, \ref sat::Solvable, \ref PoolItem, ...) refer to the
+  /// pool which is current on the thread using them. Per default this is the
+  /// global pool behind \ref sat::Pool::instance and \ref ResPool::instance.
+  /// A \ref Scope makes a context current on this thread, so all static pool
+  /// API (including \ref sat::Pool::instance, \ref ResPool::instance and
+  /// \ref ResPool::resolver) refers to the contexts pool.
+  ///
+  /// A thread works on one pool at a time. Ids must not be passed between
+  /// pools, except for the strings which were known to the global pool when
+  /// the context was created; the new pool starts with them, so constant
+  /// ids like the builtin \ref ResKind or \ref Arch stay valid. String
+  /// constants are kept in namespace scope statics initialized by
+  /// \ref sat::detail::constStr2id, not in function-local ones.
+  ///
+  /// \code
+  ///   PoolContext ctx;
+  ///   std::thread worker( [ctx]() {
+  ///     PoolContext::Scope scope( ctx );
+  ///     sat::Pool::instance().addRepoSolv( "image.solv" );
+  ///     ResPool::instance().resolver().resolvePool();
+  ///     ...
+  ///   } );
+  /// \endcode
+  ///
+  /// The context is shared by its copies and destroyed with the last one.
+  ///////////////////////////////////////////////////////////////////
+  class PoolContext
+  {
+    friend std::ostream & operator<<( std::ostream & str, const PoolContext & obj );
+
+  public:
+    /** Create a new, empty pool. */
+    PoolContext();
+
+    ~PoolContext();
+
+    /** Whether this is the global pool. */
+    bool isDefault() const;
+
+    /** Whether this context is current on this thread. */
+    bool isCurrent() const;
+
+    /** The contexts \ref ResPool (requires a \ref Scope). */
+    ResPool pool() const;
+
+    /** The contexts \ref Resolver (created on demand, requires a \ref Scope). */
+    Resolver_Ptr resolver() const;
+
+  public:
+    /** The global pool. */
+    static PoolContext defaultContext();
+
+    /** The context current on this thread. */
+    static PoolContext current();
+
+  public:
+    class Impl;
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class PoolContext::Scope
+    /// \brief Make a \ref PoolContext current on this thread until the Scope is left.
+    ///
+    /// Scopes may be nested; leaving a Scope restores the previous context.
+    ///////////////////////////////////////////////////////////////////
+    class Scope : private base::NonCopyable
+    {
+    public:
+      explicit Scope( const PoolContext & context_r );
+      ~Scope();
+    private:
+      shared_ptr<Impl> _context;
+      Impl * _prev;
+    };
+
+  private:
+    explicit PoolContext( const shared_ptr<Impl> & impl_r );
+    shared_ptr<Impl> _pimpl;
+
+    friend class ResPool;
+    /** The \ref ResPool of the context current on this thread (\c nullptr if it is the global pool). */
+    static const ResPool * currentPool();
+  };
+
+  /** \relates PoolContext Stream output */
+  std::ostream & operator<<( std::ostream & str, const PoolContext & obj );
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOLCONTEXT_H
@@ -17,6 +17,7 @@
 #include <zypp/ResPool.h>
 #include <zypp/Package.h>
 #include <zypp/VendorAttr.h>
+#include <zypp/pool/StatusStore.h>
 
 using std::endl;
 
@@ -33,20 +34,41 @@ namespace zypp
    * \li \c ==0 no buddy
    * \li \c >0 this uses \c _buddy status
    * \li \c <0 this status used by \c -_buddy
+   *
+   * The status is kept in the pools \ref pool::StatusStore. A PoolItem
+   * dropped from the pool takes its status to a detached slot.
    */
   struct PoolItem::Impl
   {
     public:
-      Impl() {}
+      Impl()
+      : _status( pool::StatusStore::detached() )
+      , _detached( true )
+      {}
 
       Impl( ResObject::constPtr res_r,
-            const ResStatus & status_r )
-      : _status( status_r )
-      , _resolvable( res_r )
+            ResStatus & status_r )
+      : _resolvable( res_r )
+      , _status( &status_r )
       {}
 
+      ~Impl()
+      {
+        if ( _detached )
+          pool::StatusStore::release( _status );
+      }
+
       ResStatus & status() const
-      { return _buddy > 0 ? PoolItem(buddy()).status() : _status; }
+      { return _buddy > 0 ? PoolItem(buddy()).status() : *_status; }
+
+      void detachStatus() const
+      {
+        if ( ! _detached )
+        {
+          _status = pool::StatusStore::detach( *_status );
+          _detached = true;
+        }
+      }
 
       sat::Solvable buddy() const
       {
@@ -64,9 +86,9 @@ namespace zypp
 
       ResStatus & statusReset() const
       {
-        _status.setLock( false, zypp::ResStatus::USER );
-        _status.resetTransact( zypp::ResStatus::USER );
-        return _status;
+        _status->setLock( false, zypp::ResStatus::USER );
+        _status->resetTransact( zypp::ResStatus::USER );
+        return *_status;
       }
 
     public:
@@ -101,9 +123,10 @@ namespace zypp
       }
 
     private:
-      mutable ResStatus     _status;
       ResObject::constPtr   _resolvable;
+      mutable ResStatus *   _status;	///< in the pools StatusStore unless _detached
       DefaultIntegral<sat::detail::IdType,sat::detail::noId> _buddy;
+      mutable DefaultIntegral<bool,false> _detached;
 
     /** \name Poor man's save/restore state.
        * \todo There may be better save/restore state strategies.
@@ -111,25 +134,11 @@ namespace zypp
     //@{
     public:
       void saveState() const
-      { _savedStatus = status(); }
+      { pool::StatusStore::saved( status() ) = status(); }
       void restoreState() const
-      { status() = _savedStatus; }
+      { status() = pool::StatusStore::saved( status() ); }
       bool sameState() const
-      {
-        if ( status() == _savedStatus )
-          return true;
-        // some bits changed...
-        if ( status().getTransactValue() != _savedStatus.getTransactValue()
-             && ( ! status().isBySolver() // ignore solver state changes
-                  // removing a user lock also goes to bySolver
-                  || _savedStatus.getTransactValue() == ResStatus::LOCKED ) )
-          return false;
-        if ( status().isLicenceConfirmed() != _savedStatus.isLicenceConfirmed() )
-          return false;
-        return true;
-      }
-    private:
-      mutable ResStatus _savedStatus;
+      { return pool::StatusStore::sameState( status(), pool::StatusStore::saved( status() ) ); }
     //@}
 
     public:
@@ -189,11 +198,17 @@ namespace zypp
   : _pimpl( implptr_r )
   {}
 
-  PoolItem PoolItem::makePoolItem( const sat::Solvable & solvable_r )
+  PoolItem PoolItem::makePoolItem( const sat::Solvable & solvable_r, ResStatus & status_r )
   {
-    return PoolItem( new Impl( makeResObject( solvable_r ), solvable_r.isSystem() ) );
+    return PoolItem( new Impl( makeResObject( solvable_r ), status_r ) );
   }
 
+  void PoolItem::detachStatus() const
+  { _pimpl->detachStatus(); }
+
+  bool PoolItem::isShared() const
+  { return _pimpl.use_count() > 1; }
+
   PoolItem::~PoolItem()
   {}
 
@@ -138,8 +138,12 @@ namespace zypp
 
     private:
       friend class pool::PoolImpl;
-      /** \ref PoolItem generator for \ref pool::PoolImpl. */
-      static PoolItem makePoolItem( const sat::Solvable & solvable_r );
+      /** \ref PoolItem generator for \ref pool::PoolImpl, keeping its status in the \ref pool::StatusStore slot \a status_r. */
+      static PoolItem makePoolItem( const sat::Solvable & solvable_r, ResStatus & status_r );
+      /** Keep the status of a PoolItem dropped from the pool outside the \ref pool::StatusStore. */
+      void detachStatus() const;
+      /** Whether other PoolItems refer to the same implementation. */
+      bool isShared() const;
       /** Buddies are set by \ref pool::PoolImpl.*/
       void setBuddy( const sat::Solvable & solv_r );
       /** internal ctor */
@@ -11,6 +11,13 @@
 */
 #include <iostream>
 #include <sstream>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+extern "C"
+{
+#include <solv/repo.h>
+}
 
 #include <zypp/base/Gettext.h>
 #include <zypp/base/LogTools.h>
@@ -21,6 +28,9 @@
 
 #include <zypp/sat/Pool.h>
 #include <zypp/sat/Solvable.h>
+#include <zypp/sat/FileIndex.h>
+#include <zypp/sat/TrigramIndex.h>
+#include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/base/StrMatcher.h>
 
 #include <zypp/PoolQuery.h>
@@ -454,6 +464,9 @@ namespace zypp
 
     /** Kinds to search */
     Kinds _kinds;
+
+    /** Scan the repos on worker threads (execution option, not part of the query). */
+    bool _parallel = false;
     //@}
 
   public:
@@ -960,6 +973,11 @@ namespace zypp
   { _pimpl->_flags = flags; }
 
 
+  void PoolQuery::setParallel( bool yesno_r )
+  { _pimpl->_parallel = yesno_r; }
+  bool PoolQuery::parallel() const
+  { return _pimpl->_parallel; }
+
   void PoolQuery::setInstalledOnly()
   { _pimpl->_status_flags = INSTALLED_ONLY; }
   void PoolQuery::setUninstalledOnly()
@@ -1518,6 +1536,9 @@ namespace zypp
 
 	bool advance( base_iterator & base_r ) const
 	{
+	  if ( _useHits )
+	    return advanceHits( base_r );
+
 	  if ( base_r == end() )
 	    base_r = startNewQyery(); // first candidate
 	  else
@@ -1619,14 +1640,33 @@ namespace zypp
 	  _status_flags = query_r->_status_flags;
           // StrMatcher
           _attrMatchList = query_r->_attrMatchList;
+
+	  if ( ! _neverMatchRepo )
+	  {
+	    // Unless some repo provides an index, the query is iterated lazily.
+	    bool useIndex = ( fileIndexLookup() || indexLiterals() ) && indexInScope();
+	    if ( ! useIndex )
+	    {
+	      _fileIndexMode = -1;
+	      _indexLiterals.clear();
+	    }
+	    if ( useIndex || query_r->_parallel )
+	    {
+	      _useHits = true;
+	      collectHits( useIndex, query_r->_parallel );
+	    }
+	  }
 	}
 
 	~PoolQueryMatcher()
 	{}
 
       private:
-	/** Initialize a new base query. */
-	base_iterator startNewQyery() const
+	/** Initialize a new base query.
+	 * Optionally restricted to a single \a repo_r or \a solv_r.
+	 */
+	base_iterator startNewQyery( Repository repo_r = Repository::noRepository,
+				     sat::Solvable solv_r = sat::Solvable::noSolvable ) const
 	{
 	  sat::LookupAttr q;
 
@@ -1634,7 +1674,11 @@ namespace zypp
 	    return q.end();
 
 	  // Repo restriction:
-	  if ( _repos.size() == 1 )
+	  if ( solv_r )
+	    q.setSolvable( solv_r );
+	  else if ( repo_r )
+	    q.setRepo( repo_r );
+	  else if ( _repos.size() == 1 )
 	    q.setRepo( *_repos.begin() );
 	  // else: handled in isAMatch.
 
@@ -1655,6 +1699,230 @@ namespace zypp
 	  return q.begin();
 	}
 
+	/** Whether this is a path or directory search in the filelist, which can be answered by the \ref sat::FileIndex. */
+	bool fileIndexLookup()
+	{
+	  if ( _attrMatchList.size() != 1 )
+	    return false;
+	  const AttrMatchData & matchData( _attrMatchList.front() );
+	  if ( matchData.attr != sat::SolvAttr::filelist || ! matchData.strMatcher || matchData.strMatcher.flags().test( Match::NOCASE ) )
+	    return false;
+
+	  const std::string & search( matchData.strMatcher.searchstring() );
+	  if ( search[0] != '/' )
+	    return false;
+	  switch ( matchData.strMatcher.flags().mode() )
+	  {
+	    case Match::STRING:
+	      _fileIndexMode = sat::FileIndex::PATH;
+	      break;
+	    case Match::STRINGSTART:
+	      if ( search.back() != '/' )
+		return false;
+	      _fileIndexMode = sat::FileIndex::DIR;
+	      break;
+	    default:
+	      return false;
+	  }
+	  return true;
+	}
+
+	/** Whether all attributes are searched for strings the \ref sat::TrigramIndex can look up.
+	 * Remembers the literals per \ref _attrMatchList entry.
+	 */
+	bool indexLiterals()
+	{
+	  if ( _attrMatchList.empty() )
+	    return false;
+	  for ( const AttrMatchData & matchData : _attrMatchList )
+	  {
+	    _indexLiterals.push_back( sat::TrigramIndex::Literals() );
+	    if ( ! sat::TrigramIndex::indexed( matchData.attr )
+	      || ! matchData.strMatcher	// an empty searchstring matches always
+	      || ! sat::TrigramIndex::literals( matchData.strMatcher, _indexLiterals.back() ) )
+	    {
+	      _indexLiterals.clear();
+	      return false;
+	    }
+	  }
+	  return true;
+	}
+
+	/** Whether some repo in scope provides the index \ref fileIndexLookup or \ref indexLiterals asks for.
+	 * A \ref sat::FileIndex is used if it was built already, but not built just for this query.
+	 */
+	bool indexInScope() const
+	{
+	  for ( const Repository & repo : sat::Pool::instance().repos() )
+	  {
+	    if ( ! _repos.empty() && ! _repos.count( repo ) )
+	      continue;
+	    if ( _fileIndexMode >= 0 ? bool(sat::FileIndex::cached( repo ) )
+				     : bool(sat::detail::PoolMember::myPool().trigramIndex( repo.get() )) )
+	      return true;
+	  }
+	  return false;
+	}
+
+	/** Candidate solvables of \a repo_r according to the repos \ref sat::FileIndex or \ref sat::TrigramIndex.
+	 * Returns \c false if the repo has no usable index and must be scanned.
+	 */
+	bool indexCandidates( const Repository & repo_r, std::vector<sat::detail::SolvableIdType> & hits_r ) const
+	{
+	  if ( _fileIndexMode >= 0 )
+	  {
+	    shared_ptr<const sat::FileIndex> idx( sat::FileIndex::cached( repo_r ) );
+	    if ( ! idx )
+	      return false;
+	    for ( const sat::Solvable & solv : idx->lookup( _attrMatchList.front().strMatcher.searchstring(),
+							     sat::FileIndex::Mode(int(_fileIndexMode)) ) )
+	      hits_r.push_back( solv.id() );
+	    return true;
+	  }
+
+	  shared_ptr<const sat::TrigramIndex> idx( sat::detail::PoolMember::myPool().trigramIndex( repo_r.get() ) );
+	  if ( ! idx )
+	    return false;
+
+	  // A solvable may match any of the attributes.
+	  std::vector<unsigned> offsets;
+	  std::vector<unsigned> tmp;
+	  auto lit = _indexLiterals.begin();
+	  for ( const AttrMatchData & matchData : _attrMatchList )
+	  {
+	    std::vector<unsigned> cand;
+	    if ( ! idx->candidates( matchData.attr, *(lit++), cand ) )
+	      return false;
+	    tmp.clear();
+	    std::set_union( offsets.begin(), offsets.end(), cand.begin(), cand.end(), std::back_inserter( tmp ) );
+	    offsets.swap( tmp );
+	  }
+
+	  sat::detail::SolvableIdType start = repo_r.get()->start;
+	  for ( unsigned off : offsets )
+	    hits_r.push_back( start + off );
+	  return true;
+	}
+
+	/** Whether the scan may compose file names in libsolvs shared temporary buffers.
+	 * These steps are serialized in a frozen pool, so scanning in parallel gains nothing.
+	 */
+	bool searchesFileLists() const
+	{
+	  for ( const AttrMatchData & matchData : _attrMatchList )
+	  {
+	    if ( matchData.attr == sat::SolvAttr::filelist || matchData.attr == sat::SolvAttr::allAttr
+	         || ( matchData.strMatcher && matchData.strMatcher.flags().test( Match::FILES ) ) )
+	      return true;
+	  }
+	  return false;
+	}
+
+	/** Collect the solvables which may match, in the order a sequential scan would find them.
+	 * If \a useIndex_r, repos providing a \ref sat::FileIndex or \ref sat::TrigramIndex are not scanned,
+	 * but the index candidates are taken. Remaining repos are scanned on worker
+	 * threads if \a parallel_r, unless the query \ref searchesFileLists. The pool
+	 * is frozen while the workers run.
+	 */
+	void collectHits( bool useIndex_r, bool parallel_r )
+	{
+	  if ( parallel_r && searchesFileLists() )
+	  {
+	    DBG << "Searching file lists: scan serially" << endl;
+	    parallel_r = false;
+	  }
+
+	  sat::Pool satpool( sat::Pool::instance() );
+	  std::vector<Repository> repos;
+	  for ( const Repository & repo : satpool.repos() )
+	  {
+	    if ( _repos.empty() || _repos.count( repo ) )
+	      repos.push_back( repo );
+	  }
+	  if ( repos.empty() )
+	    return;
+
+	  std::vector<std::vector<sat::detail::SolvableIdType>> repoHits( repos.size() );
+	  std::vector<unsigned> order;	// repos to scan
+	  for ( unsigned i = 0; i < repos.size(); ++i )
+	  {
+	    if ( useIndex_r && indexCandidates( repos[i], repoHits[i] ) )
+	      continue;
+	    order.push_back( i );
+	  }
+
+	  // Largest repos first, so the threads are evenly loaded.
+	  std::stable_sort( order.begin(), order.end(), [&repos]( unsigned lhs, unsigned rhs ) {
+	    return repos[lhs].solvablesSize() > repos[rhs].solvablesSize();
+	  } );
+
+	  std::atomic<unsigned> next { 0 };
+	  auto worker = [&]() {
+	    for ( unsigned i = next++; i < order.size(); i = next++ )
+	    {
+	      std::vector<sat::detail::SolvableIdType> & hits( repoHits[order[i]] );
+	      base_iterator base( startNewQyery( repos[order[i]] ) );
+	      while ( base != end() )
+	      {
+		if ( isAMatch( base ) )
+		{
+		  hits.push_back( base.inSolvable().id() );
+		  base.nextSkipSolvable();
+		}
+		++base;
+	      }
+	    }
+	  };
+
+	  unsigned nthreads = 1;
+	  if ( parallel_r )
+	  {
+	    nthreads = std::min<unsigned>( std::max( std::thread::hardware_concurrency(), 1U ), 8U );
+	    nthreads = std::min<unsigned>( nthreads, order.size() );
+	  }
+	  // Data computed on demand (paged repodata, whatprovides, string
+	  // hashes, ...) is prepared by freezing the pool. It also makes
+	  // the remaining shared libsolv buffers used under the pool lock.
+	  sat::Pool::Frozen frozen;
+	  if ( nthreads > 1 )
+	    frozen = satpool.freeze();
+	  std::vector<std::thread> threads;
+	  for ( unsigned i = 1; i < nthreads; ++i )
+	    threads.push_back( std::thread( worker ) );
+	  worker();
+	  for ( std::thread & t : threads )
+	    t.join();
+	  frozen.reset();
+
+	  for ( const auto & hits : repoHits )
+	    _hits.insert( _hits.end(), hits.begin(), hits.end() );
+	  for ( unsigned i = 0; i < _hits.size(); ++i )
+	    _hitPos[_hits[i]] = i;
+	}
+
+	/** Hits mode: Move to the first match in the next hit solvable. */
+	bool advanceHits( base_iterator & base_r ) const
+	{
+	  unsigned idx = 0;
+	  if ( base_r != end() )
+	  {
+	    auto it = _hitPos.find( base_r.inSolvable().id() );
+	    idx = ( it == _hitPos.end() ? _hits.size() : it->second + 1 );
+	  }
+
+	  for ( ; idx < _hits.size(); ++idx )
+	  {
+	    base_r = startNewQyery( Repository::noRepository, sat::Solvable( _hits[idx] ) );
+	    while ( base_r != end() )
+	    {
+	      if ( isAMatch( base_r ) )
+		return true;
+	      ++base_r;
+	    }
+	  }
+	  return false;
+	}
+
 
 	/** Check whether we are on a match.
 	 *
@@ -1773,6 +2041,14 @@ namespace zypp
         int _status_flags;
         /** StrMatcher per attribtue. */
         AttrMatchList _attrMatchList;
+        /** The \ref sat::FileIndex::Mode to use, or \c -1. */
+        DefaultIntegral<int,-1> _fileIndexMode;
+        /** Per \ref _attrMatchList entry: the literals to look up in a \ref sat::TrigramIndex. */
+        std::vector<sat::TrigramIndex::Literals> _indexLiterals;
+        /** Hits mode (parallel scan or index lookup): candidate solvables in sequential scan order. */
+        DefaultIntegral<bool,false> _useHits;
+        std::vector<sat::detail::SolvableIdType> _hits;
+        std::unordered_map<sat::detail::SolvableIdType,unsigned> _hitPos;
     };
     ///////////////////////////////////////////////////////////////////
 
@@ -179,6 +179,15 @@ namespace zypp
     /** Set status filter directly \see StatusFilter */
     void setStatusFilterFlags( StatusFilter flags );
 
+    /** Scan the repositories in parallel on worker threads.
+     * Worth it for expensive queries (substring or regex search in
+     * descriptions or filelists) over many repos. The whole query is
+     * evaluated when \ref begin is called. The results are returned in
+     * the same order as by a sequential query.
+     * \note The paged data of the searched repos (e.g. filelists) is
+     * loaded into memory beforehand.
+     */
+    void setParallel( bool yesno_r = true );
     //@}
 
     /**
@@ -419,6 +428,9 @@ namespace zypp
     { return flags().mode(); }
 
     StatusFilter statusFilterFlags() const;
+
+    /** Whether the repositories are scanned in parallel. \see \ref setParallel */
+    bool parallel() const;
     //@}
 
     /**
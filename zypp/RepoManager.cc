@@ -53,6 +53,7 @@
 #include <zypp/ZYppCallbacks.h>
 
 #include "sat/Pool.h"
+#include <zypp/sat/TrigramIndex.h>
 
 using std::endl;
 using std::string;
@@ -1295,6 +1296,9 @@ namespace zypp
 	  const Pathname & base = solv_path_for_repoinfo( _options, info);
 	  if ( ! PathInfo(base/"solv.idx").isExist() )
 	    sat::updateSolvFileIndex( base/"solv" );
+	  // Likewise a missing or unusable (e.g. old format) trigram index, if enabled.
+	  if ( ZConfig::instance().repo_trigramIndex() && ! sat::TrigramIndex( base/"solv" ) )
+	    sat::TrigramIndex::build( base/"solv" );
 
 	  return;
         }
@@ -1402,6 +1406,10 @@ namespace zypp
         // We keep it.
         guard.resetDispose();
 	sat::updateSolvFileIndex( solvfile );	// content digest for zypper bash completion
+	if ( ZConfig::instance().repo_trigramIndex() )
+	  sat::TrigramIndex::build( solvfile );	// PoolQuery string search prefilter
+	else
+	  filesystem::unlink( sat::TrigramIndex::indexFile( solvfile ) );
       }
       break;
       default:
@@ -1600,6 +1608,21 @@ namespace zypp
     if ( ! PathInfo(solvfile).isExist() )
       ZYPP_THROW(RepoNotCachedException(info));
 
+    // Callers usually load the known repos in order; warm the page cache for
+    // the next enabled one while we are busy with this one.
+    RepoConstIterator it( findAlias( info.alias(), repos() ) );
+    if ( it != repos().end() )
+    {
+      for ( ++it; it != repos().end(); ++it )
+      {
+        if ( it->enabled() )
+        {
+          sat::Pool::prefetchRepoSolv( solv_path_for_repoinfo( _options, *it ) / "solv" );
+          break;
+        }
+      }
+    }
+
     sat::Pool::instance().reposErase( info.alias() );
     try
     {
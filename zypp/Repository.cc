@@ -10,6 +10,8 @@
  *
 */
 #include <climits>
+#include <fcntl.h>
+#include <chrono>
 #include <iostream>
 
 #include <zypp/base/Logger.h>
@@ -327,13 +329,25 @@ namespace zypp
         file.resetDispose();
         ZYPP_THROW( Exception( "Can't open solv-file: "+file_r.asString() ) );
       }
+      // repo_add_solv reads the file front to back; let the kernel read ahead aggressively.
+      ::posix_fadvise( ::fileno( file ), 0, 0, POSIX_FADV_SEQUENTIAL );
 
+      auto start = std::chrono::steady_clock::now();
       if ( myPool()._addSolv( _repo, file ) != 0 )
       {
         ZYPP_THROW( Exception( "Error reading solv-file: "+file_r.asString() ) );
       }
+      unsigned ms = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+      myPool().setSolvLoadTime( _repo, ms );
+      myPool().setSolvFile( _repo, file_r );
 
-      MIL << *this << " after adding " << file_r << endl;
+      MIL << *this << " after adding " << file_r << " (" << ms << "ms)" << endl;
+    }
+
+    unsigned Repository::solvLoadTime() const
+    {
+      NO_REPOSITORY_RETURN( 0 );
+      return myPool().solvLoadTime( _repo );
     }
 
     void Repository::addHelix( const Pathname & file_r )
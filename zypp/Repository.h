@@ -270,6 +270,9 @@ namespace zypp
         /** Return next Repository in \ref Pool (or \ref noRepository). */
         Repository nextInPool() const;
 
+        /** Time spent in the last \ref addSolv for this repository (in ms, \c 0 if not loaded from a solv-file). */
+        unsigned solvLoadTime() const;
+
    public:
         /** \name Repository content manipulating methods.
          * \todo maybe a separate Repository/Solvable content manip interface
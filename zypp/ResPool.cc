@@ -16,6 +16,7 @@
 
 #include <zypp/ZYppFactory.h>
 #include <zypp/ResPool.h>
+#include <zypp/PoolContext.h>
 #include <zypp/pool/PoolImpl.h>
 #include <zypp/pool/PoolStats.h>
 
@@ -36,6 +37,8 @@ namespace zypp
   //
   ResPool ResPool::instance()
   {
+    if ( const ResPool * ctx = PoolContext::currentPool() )
+      return *ctx;
     static ResPool _val( pool::PoolTraits::Impl_Ptr( new pool::PoolImpl ) );
     return _val;
   }
@@ -59,7 +62,14 @@ namespace zypp
   { return _pimpl->proxy( *this ); }
 
   Resolver & ResPool::resolver() const
-  { return *getZYpp()->resolver(); }
+  {
+    if ( PoolContext::currentPool() )
+      return *PoolContext::current().resolver();
+    return *getZYpp()->resolver();
+  }
+
+  pool::StatusStore & ResPool::statusStore() const
+  { return _pimpl->statusStore(); }
 
   const SerialNumber & ResPool::serial() const
   { return _pimpl->serial(); }
@@ -69,15 +69,24 @@ namespace zypp
       typedef pool::PoolTraits::repository_iterator      repository_iterator;
 
     public:
-      /** Singleton ctor. */
+      /** Singleton ctor.
+       * The pool of the \ref PoolContext current on this thread.
+       */
       static ResPool instance();
 
       /** preliminary */
       ResPoolProxy proxy() const;
 
-      /** The Resolver */
+      /** The Resolver (of the \ref PoolContext current on this thread). */
       Resolver & resolver() const;
 
+      /** The status of all items, indexed by solvable id.
+       * Allows pool-wide status operations (bitmap views, bulk resets,
+       * save/restore) without visiting the PoolItems.
+       * \see \ref pool::StatusStore
+       */
+      pool::StatusStore & statusStore() const;
+
     public:
       /** The pools serial number. Changing whenever the
        * whenever the content changes. (Resolvables or
@@ -165,8 +174,7 @@ namespace zypp
 
       byIdent_iterator byIdentBegin( const ByIdent & ident_r ) const
       {
-	return make_transform_iterator( id2item().equal_range( ident_r.get() ).first,
-                                        pool::PoolTraits::Id2ItemValueSelector() );
+	return id2item().equal_range( ident_r.get() ).first;
       }
 
       byIdent_iterator byIdentBegin( ResKind kind_r, IdString name_r ) const
@@ -196,8 +204,7 @@ namespace zypp
 
       byIdent_iterator byIdentEnd( const ByIdent & ident_r ) const
       {
-	return make_transform_iterator( id2item().equal_range( ident_r.get() ).second,
-                                        pool::PoolTraits::Id2ItemValueSelector() );
+	return id2item().equal_range( ident_r.get() ).second;
       }
 
       byIdent_iterator byIdentEnd( ResKind kind_r, IdString name_r ) const
@@ -463,6 +470,7 @@ namespace zypp
       const pool::PoolTraits::Id2ItemT & id2item() const;
 
     private:
+      friend class PoolContext;
       /** Ctor */
       ResPool( pool::PoolTraits::Impl_Ptr impl_r );
       /** Access to implementation. */
@@ -30,10 +30,7 @@ namespace zypp
   struct PoolItemSaver
   {
     void saveState( ResPool pool_r )
-    {
-      std::for_each( pool_r.begin(), pool_r.end(),
-                     std::mem_fun_ref(&PoolItem::saveState) );
-    }
+    { pool_r.statusStore().saveState(); }
 
     void saveState( ResPool pool_r, const ResKind & kind_r )
     {
@@ -42,10 +39,7 @@ namespace zypp
     }
 
     void restoreState( ResPool pool_r )
-    {
-      std::for_each( pool_r.begin(), pool_r.end(),
-                     std::mem_fun_ref(&PoolItem::restoreState) );
-    }
+    { pool_r.statusStore().restoreState(); }
 
     void restoreState( ResPool pool_r, const ResKind & kind_r )
     {
@@ -54,11 +48,7 @@ namespace zypp
     }
 
     bool diffState( ResPool pool_r ) const
-    {
-      // return whether some PoolItem::sameState reported \c false.
-      return( invokeOnEach( pool_r.begin(), pool_r.end(),
-                            std::mem_fun_ref(&PoolItem::sameState) ) < 0 );
-    }
+    { return pool_r.statusStore().diffState(); }
 
     bool diffState( ResPool pool_r, const ResKind & kind_r ) const
     {
@@ -70,14 +60,12 @@ namespace zypp
 
   namespace
   {
-    ui::Selectable::Ptr makeSelectablePtr( pool::PoolImpl::Id2ItemT::const_iterator begin_r,
-                                           pool::PoolImpl::Id2ItemT::const_iterator end_r )
+    ui::Selectable::Ptr makeSelectablePtr( pool::PoolTraits::byIdent_iterator begin_r,
+                                           pool::PoolTraits::byIdent_iterator end_r )
     {
-      pool::PoolTraits::byIdent_iterator begin( begin_r, pool::PoolTraits::Id2ItemValueSelector() );
-      pool::PoolTraits::byIdent_iterator end( end_r, pool::PoolTraits::Id2ItemValueSelector() );
-      sat::Solvable solv( begin->satSolvable() );
+      sat::Solvable solv( begin_r->satSolvable() );
 
-      return new ui::Selectable( ui::Selectable::Impl_Ptr( new ui::Selectable::Impl( solv.kind(), solv.name(), begin, end ) ) );
+      return new ui::Selectable( ui::Selectable::Impl_Ptr( new ui::Selectable::Impl( solv.kind(), solv.name(), begin_r, end_r ) ) );
     }
   } // namespace
 
@@ -86,83 +74,140 @@ namespace zypp
   //	CLASS NAME : ResPoolProxy::Impl
   //
   /** ResPoolProxy implementation.
-   * \todo Seedup as it is still using old index
+   * Selectables are created on demand from the pools ident index,
+   * when looked up or when iterating them (all or per kind). Selectables
+   * of the previous proxy are reused if their items did not change.
+   * Iteration follows the order of the ident index, no matter which
+   * Selectables were looked up before.
   */
   struct ResPoolProxy::Impl
   {
     friend std::ostream & operator<<( std::ostream & str, const Impl & obj );
     friend std::ostream & dumpOn( std::ostream & str, const Impl & obj );
 
-    typedef std::unordered_map<sat::detail::IdType,ui::Selectable::Ptr> SelectableIndex;
+    typedef pool::PoolImpl::Id2ItemT IdentIndex;
     typedef ResPoolProxy::const_iterator const_iterator;
 
   public:
     Impl()
-    :_pool( ResPool::instance() )
+    : _pool( ResPool::instance() )
+    , _index( new IdentIndex )
     {}
 
     Impl( ResPool pool_r, const pool::PoolImpl & poolImpl_r )
     : _pool( pool_r )
+    , _index( poolImpl_r.id2itemPtr() )
+    , _selectables( _index->identsSize() )
     {
-      const pool::PoolImpl::Id2ItemT & id2item( poolImpl_r.id2item() );
-      if ( ! id2item.empty() )
+      if ( poolImpl_r.previousProxy() )
       {
-        // set startpoint
-        pool::PoolImpl::Id2ItemT::const_iterator cbegin = id2item.begin();
-
-        for_( it, id2item.begin(), id2item.end() )
-        {
-          if ( it->first != cbegin->first )
-          {
-            // starting a new Selectable, create the previous one
-            ui::Selectable::Ptr p( makeSelectablePtr( cbegin, it ) );
-            _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
-            _selIndex[cbegin->first] = p;
-            // remember new startpoint
-            cbegin = it;
-          }
-        }
-        // create the final one
-        ui::Selectable::Ptr p( makeSelectablePtr( cbegin, id2item.end() ) );
-        _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
-        _selIndex[cbegin->first] = p;
+        const Impl & prev( *poolImpl_r.previousProxy()->_pimpl );
+        _prevIndex = prev._index;
+        _prevSelectables = prev._selectables;
+        _prevChangedRanges = poolImpl_r.proxyChangedRanges();
       }
     }
 
   public:
     ui::Selectable::Ptr lookup( const pool::ByIdent & ident_r ) const
     {
-      SelectableIndex::const_iterator it( _selIndex.find( ident_r.get() ) );
-      if ( it != _selIndex.end() )
-        return it->second;
-      return ui::Selectable::Ptr();
+      IdentIndex::size_type idx = _index->identIndex( ident_r.get() );
+      if ( idx == _index->identsSize() )
+        return ui::Selectable::Ptr();
+      return selectable( idx );
     }
 
   public:
     bool empty() const
-    { return _selPool.empty(); }
+    { return _index->identsSize() == 0; }
 
     size_type size() const
-    { return _selPool.size(); }
+    { return _index->identsSize(); }
 
     const_iterator begin() const
-    { return make_map_value_begin( _selPool ); }
+    { materializeAll(); return make_map_value_begin( _selPool ); }
 
     const_iterator end() const
-    { return make_map_value_end( _selPool ); }
+    { materializeAll(); return make_map_value_end( _selPool ); }
 
   public:
     bool empty( const ResKind & kind_r ) const
-    { return( _selPool.count( kind_r ) == 0 );  }
+    { return _index->kindIdents( kind_r ).empty(); }
 
     size_type size( const ResKind & kind_r ) const
-    { return _selPool.count( kind_r ); }
+    { return _index->kindIdents( kind_r ).size(); }
 
     const_iterator byKindBegin( const ResKind & kind_r ) const
-    { return make_map_value_lower_bound( _selPool, kind_r ); }
+    { materialize( kind_r ); return make_map_value_lower_bound( _selPool, kind_r ); }
 
     const_iterator byKindEnd( const ResKind & kind_r ) const
-    { return make_map_value_upper_bound( _selPool, kind_r ); }
+    { materialize( kind_r ); return make_map_value_upper_bound( _selPool, kind_r ); }
+
+  private:
+    /** The Selectable for the \a idx_r th ident in the index (created on demand). */
+    const ui::Selectable::Ptr & selectable( IdentIndex::size_type idx_r ) const
+    {
+      ui::Selectable::Ptr & ret( _selectables[idx_r] );
+      if ( ! ret )
+      {
+        IdentIndex::Range items( _index->identItems( idx_r ) );
+        ret = reusableSelectable( _index->identKey( idx_r ), items );
+        if ( ! ret )
+          ret = makeSelectablePtr( items.first, items.second );
+      }
+      return ret;
+    }
+
+    /** The previous proxies Selectable for \a key_r, if it has exactly the same, unchanged items. */
+    ui::Selectable::Ptr reusableSelectable( IdentIndex::KeyType key_r, const IdentIndex::Range & items_r ) const
+    {
+      if ( ! _prevIndex )
+        return ui::Selectable::Ptr();
+
+      IdentIndex::size_type pidx = _prevIndex->identIndex( key_r );
+      if ( pidx == _prevIndex->identsSize() || ! _prevSelectables[pidx] )
+        return ui::Selectable::Ptr();
+
+      IdentIndex::Range pitems( _prevIndex->identItems( pidx ) );
+      if ( ! std::equal( items_r.first, items_r.second, pitems.first, pitems.second ) )
+        return ui::Selectable::Ptr();
+
+      for ( IdentIndex::const_iterator it = items_r.first; it != items_r.second; ++it )
+      {
+        for ( const auto & range : _prevChangedRanges )
+        {
+          if ( range.first <= it->id() && it->id() < range.second )
+            return ui::Selectable::Ptr();
+        }
+      }
+      return _prevSelectables[pidx];
+    }
+
+    /** Add the kinds Selectables to _selPool, in index order. */
+    void materialize( const ResKind & kind_r ) const
+    {
+      if ( _allDone || ! _kindsDone.insert( kind_r ).second )
+        return;
+      for ( unsigned idx : _index->kindIdents( kind_r ) )
+        _selPool.insert( SelectablePool::value_type( kind_r, selectable( idx ) ) );
+    }
+
+    /** Add the Selectables of all kinds not yet done to _selPool, in index order. */
+    void materializeAll() const
+    {
+      if ( _allDone )
+        return;
+      for ( IdentIndex::size_type idx = 0; idx < _selectables.size(); ++idx )
+      {
+        const ui::Selectable::Ptr & sel( selectable( idx ) );
+        if ( ! _kindsDone.count( sel->kind() ) )
+          _selPool.insert( SelectablePool::value_type( sel->kind(), sel ) );
+      }
+      _allDone = true;
+      // nothing left to reuse
+      _prevIndex.reset();
+      _prevSelectables.clear();
+    }
 
   public:
     size_type knownRepositoriesSize() const
@@ -196,8 +241,15 @@ namespace zypp
 
   private:
     ResPool _pool;
-    mutable SelectablePool _selPool;
-    mutable SelectableIndex _selIndex;
+    shared_ptr<const IdentIndex> _index;
+    mutable std::vector<ui::Selectable::Ptr> _selectables;	///< per ident in _index
+    mutable SelectablePool _selPool;				///< the Selectables of the kinds iterated so far
+    mutable std::set<ResKind> _kindsDone;
+    mutable DefaultIntegral<bool,false> _allDone;
+
+    mutable shared_ptr<const IdentIndex> _prevIndex;
+    mutable std::vector<ui::Selectable::Ptr> _prevSelectables;
+    std::vector<std::pair<sat::detail::SolvableIdType,sat::detail::SolvableIdType>> _prevChangedRanges;
 
   public:
     /** Offer default Impl. */
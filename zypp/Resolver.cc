@@ -14,6 +14,7 @@
 #define ZYPP_USE_RESOLVER_INTERNALS
 
 #include <zypp/Resolver.h>
+#include <zypp/ZConfig.h>
 #include <zypp/solver/detail/Resolver.h>
 #include <zypp/solver/detail/Testcase.h>
 #include <zypp/solver/detail/ItemCapKind.h>
@@ -59,6 +60,9 @@ namespace zypp
   bool Resolver::resolvePool ()
   { return _pimpl->resolvePool(); }
 
+  const ResolverStatistics & Resolver::statistics() const
+  { return _pimpl->statistics(); }
+
   bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
   { return _pimpl->resolveQueue(queue); }
 
@@ -111,6 +115,14 @@ namespace zypp
   void Resolver::setDefaultCleandepsOnRemove()		{ _pimpl->setCleandepsOnRemove( indeterminate ); }
   bool Resolver::cleandepsOnRemove() const		{ return _pimpl->cleandepsOnRemove(); }
 
+  void Resolver::setIncrementalSolve( bool yesno_r )	{ _pimpl->setIncrementalSolve( yesno_r ); }
+  void Resolver::setDefaultIncrementalSolve()		{ _pimpl->setIncrementalSolve( indeterminate ); }
+  bool Resolver::incrementalSolve() const		{ return _pimpl->incrementalSolve(); }
+
+  void Resolver::setResultCachePath( const Pathname & path_r )	{ _pimpl->setResultCachePath( path_r ); }
+  void Resolver::setDefaultResultCachePath()		{ _pimpl->setResultCachePath( ZConfig::instance().solver_resultCachePath() ); }
+  const Pathname & Resolver::resultCachePath() const	{ return _pimpl->resultCachePath(); }
+
 #define ZOLV_FLAG_BOOL( ZSETTER, ZGETTER )					\
   void Resolver::ZSETTER( bool yesno_r ){ _pimpl->ZSETTER( yesno_r ); }		\
   bool Resolver::ZGETTER() const	{ return _pimpl->ZGETTER(); }		\
@@ -146,6 +158,11 @@ namespace zypp
   CapabilitySet Resolver::getRequire() const	{ return _pimpl->extraRequires(); }
   CapabilitySet Resolver::getConflict() const	{ return _pimpl->extraConflicts(); }
 
+  std::vector<std::string> Resolver::addInstallSpecs( const std::vector<std::string> & specs_r )
+  { return _pimpl->addExtraInstallSpecs( specs_r ); }
+  IdStringSet Resolver::getInstallNames() const	{ return _pimpl->extraInstallIdents(); }
+  void Resolver::removeInstallNames()		{ _pimpl->removeExtraInstallIdents(); }
+
   std::list<PoolItem> Resolver::problematicUpdateItems() const
   { return _pimpl->problematicUpdateItems(); }
 
@@ -155,6 +172,12 @@ namespace zypp
     return testcase.createTestcase(*_pimpl, true, runSolver);
   }
 
+  bool Resolver::createSolverTestcaseArchive( const std::string & dumpPath, bool runSolver )
+  {
+    solver::detail::Testcase testcase (dumpPath);
+    return testcase.createArchive(*_pimpl, runSolver);
+  }
+
   solver::detail::ItemCapKindList Resolver::isInstalledBy( const PoolItem & item )
   { return _pimpl->isInstalledBy (item); }
 
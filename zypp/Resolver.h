@@ -14,7 +14,9 @@
 
 #include <iosfwd>
 #include <functional>
+#include <vector>
 
+#include <zypp/Pathname.h>
 #include <zypp/base/ReferenceCounted.h>
 
 #include <zypp/solver/Types.h>
@@ -28,6 +30,9 @@ namespace zypp
   {
     class Transaction;
   }
+  struct WhatIfJobs;
+  struct WhatIfResult;
+  struct ResolverStatistics;
 
   ///////////////////////////////////////////////////////////////////
   //
@@ -163,6 +168,30 @@ namespace zypp
      */
     sat::Transaction getTransaction();
 
+    /**
+     * Phase timings and counters of the last \ref resolvePool or
+     * \ref resolveQueue run (\see zypp/ResolverStatistics.h).
+     * The statistics are also written into solver testcases.
+     */
+    const ResolverStatistics & statistics() const;
+
+    /**
+     * Evaluate independent alternative requests without touching the
+     * \ref ResPool.
+     *
+     * Each \ref WhatIfJobs is added to the current pool state and solved
+     * using this resolvers settings. The pool is frozen meanwhile. Worker
+     * threads (\a threads_r, \c 0 for one per core, at most 8) each solve on a private
+     * clone of the pool (see \ref PoolContext), so libsolv never shares a
+     * pool between threads. Cloning serializes the repos once and loads them
+     * into each worker, so this pays off for more than a few alternatives.
+     *
+     * \note Upgrade repos (\ref addUpgradeRepo) are not regarded.
+     * \see zypp/ResolverWhatIf.h
+     * \throws Exception if the pool can't be cloned or a solver run fails.
+     */
+    std::vector<WhatIfResult> whatIf( const std::vector<WhatIfJobs> & jobs_r, unsigned threads_r = 0 );
+
     /**
      * Define the resolvers general attitude when resolving jobs.
      * \see \ref ResolverFocus
@@ -268,6 +297,34 @@ namespace zypp
     void setDefaultCleandepsOnRemove(); // set back to default (in zypp.conf)
     bool cleandepsOnRemove() const;
 
+    /**
+     * Incremental re-solve for interactive front-ends calling \ref resolvePool
+     * after each change. The libsolv solver is kept alive between runs as
+     * long as the pool content is unchanged. If neither the resulting solver
+     * jobs nor the solver flags changed since the last run, its result is
+     * reused without solving again.
+     * \note libsolv recreates its rules on each solver run, so a changed
+     * request is solved from scratch. Default is \c false.
+     */
+    void setIncrementalSolve( bool yesno_r );
+    void setDefaultIncrementalSolve();
+    bool incrementalSolve() const;
+
+    /**
+     * Directory where results of successful solver runs are cached.
+     * If the repos content, the request and the solver flags are the
+     * same as in a cached run, the PoolItem status is restored from
+     * the cache instead of solving again.
+     * \note Information only the solver can provide is not available
+     * for a cached result (e.g. \ref isInstalledBy). An empty path
+     * disables the cache. Default is \ref ZConfig::solver_resultCachePath
+     * (disabled unless set in zypp.conf).
+     * \see \ref ResolverStatistics::cached
+     */
+    void setResultCachePath( const Pathname & path_r );
+    void setDefaultResultCachePath();
+    const Pathname & resultCachePath() const;
+
     /** \name  Solver flags for DUP mode.
      * DUP mode default settings differ from 'ordinary' ones. Default for
      * all DUP flags is \c true unless overwritten by zypp.conf.
@@ -364,6 +421,41 @@ namespace zypp
      */
     CapabilitySet getConflict() const;
 
+    /**
+     * Request to install a batch of packages given by name or capability.
+     *
+     * Each spec is either an \c IDENT (install a solvable with this name)
+     * or \c provides:CAPABILITY (like \ref addRequire), as in
+     * \ref sat::SolvableSpec. The names are looked up in a single pass
+     * over the pool and passed to the solver as install jobs. Unlike
+     * selecting each candidate via \ref ui::Selectable, no status in the
+     * \ref ResPool is touched; the solver picks the best candidate.
+     *
+     * The requests persist until removed by \ref removeInstallNames
+     * (resp. \ref removeRequire for capabilities).
+     *
+     * \code
+     *   std::vector<std::string> unknown( resolver.addInstallSpecs( imagePackages ) );
+     *   if ( ! unknown.empty() )
+     *     ...
+     *   resolver.resolvePool();
+     * \endcode
+     *
+     * \return The specs which do not match any solvable in the pool, in
+     * the order given. They are not added.
+     */
+    std::vector<std::string> addInstallSpecs( const std::vector<std::string> & specs_r );
+
+    /**
+     * Get all names requested by \ref addInstallSpecs.
+     */
+    IdStringSet getInstallNames() const;
+
+    /**
+     * Remove all names requested by \ref addInstallSpecs.
+     */
+    void removeInstallNames();
+
     /**
      * Generates a solver Testcase of the current state
      *
@@ -372,6 +464,22 @@ namespace zypp
      */
     bool createSolverTestcase( const std::string & dumpPath = "/var/log/YaST2/solverTestcase", bool runSolver = true );
 
+    /**
+     * Generates a solver Testcase of the current state as single
+     * compressed file \c zypp-testcase.ztc in \a dumpPath.
+     *
+     * The repos are stored as solv files, which makes it fast to write
+     * and to load. \ref misc::testcase::LoadTestcase accepts the file or
+     * the directory containing it.
+     *
+     * If \c ZYPP_SOLVER_FAILURE_TESTCASE is set in the environment, such an
+     * archive is written to the directory it names whenever the solver fails.
+     *
+     * \param dumpPath destination directory of the created archive
+     * \return true if it was successful
+     */
+    bool createSolverTestcaseArchive( const std::string & dumpPath = "/var/log/YaST2/solverTestcase", bool runSolver = true );
+
     /**
      * Gives information about WHO has pused an installation of an given item.
      *
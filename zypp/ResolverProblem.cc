@@ -76,10 +76,15 @@ namespace zypp
           , _completeProblemInfo ( std::move(completeProblemInfo) )
     {}
 
+    Impl( LazyRender && lazyRender )
+    : _lazyRender( std::move(lazyRender) )
+    {}
+
     std::string		_description;
     std::string		_details;
     ProblemSolutionList	_solutions;
     std::vector<std::string> _completeProblemInfo;
+    LazyRender		_lazyRender;	///< Data not yet rendered
 
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
@@ -105,30 +110,63 @@ namespace zypp
       : _pimpl( new Impl( std::move(description), std::move(details), std::move(completeProblemInfo) ) )
   {}
 
+  ResolverProblem::ResolverProblem( LazyRender lazyRender_r )
+  : _pimpl( new Impl( std::move(lazyRender_r) ) )
+  {}
+
   ResolverProblem::~ResolverProblem()
   {}
 
 
   const std::string & ResolverProblem::description() const
-  { return _pimpl->_description; }
+  { renderOnce( &LazyRender::description ); return _pimpl->_description; }
 
   const std::string & ResolverProblem::details() const
-  { return _pimpl->_details; }
+  { renderOnce( &LazyRender::description ); return _pimpl->_details; }
 
   const ProblemSolutionList & ResolverProblem::solutions() const
-  { return _pimpl->_solutions; }
+  { renderOnce( &LazyRender::solutions ); return _pimpl->_solutions; }
 
   const std::vector<std::string> & ResolverProblem::completeProblemInfo() const
-  { return _pimpl->_completeProblemInfo; }
+  { renderOnce( &LazyRender::completeProblemInfo ); return _pimpl->_completeProblemInfo; }
 
   void ResolverProblem::setDescription( std::string description )
-  { _pimpl->_description = std::move(description); }
+  { renderOnce( &LazyRender::description ); _pimpl->_description = std::move(description); }
 
   void ResolverProblem::setDetails( std::string details )
-  { _pimpl->_details = std::move(details); }
+  { renderOnce( &LazyRender::description ); _pimpl->_details = std::move(details); }
+
+  void ResolverProblem::setCompleteProblemInfo( std::vector<std::string> completeProblemInfo )
+  { _pimpl->_lazyRender.completeProblemInfo = nullptr; _pimpl->_completeProblemInfo = std::move(completeProblemInfo); }
+
+  bool ResolverProblem::rendered() const
+  {
+    const LazyRender & lazy( _pimpl->_lazyRender );
+    return ! ( lazy.description || lazy.completeProblemInfo || lazy.solutions );
+  }
+
+  void ResolverProblem::render() const
+  {
+    renderOnce( &LazyRender::description );
+    renderOnce( &LazyRender::completeProblemInfo );
+    renderOnce( &LazyRender::solutions );
+  }
+
+  void ResolverProblem::renderOnce( std::function<void(ResolverProblem &)> LazyRender::* fnc_r ) const
+  {
+    if ( _pimpl->_lazyRender.*fnc_r )
+    {
+      // Render into our own data, a copy sharing them renders on its own.
+      ResolverProblem & self( const_cast<ResolverProblem &>( *this ) );
+      std::function<void(ResolverProblem &)> fnc;
+      fnc.swap( self._pimpl->_lazyRender.*fnc_r );	// clear it first, the setters render pending data
+      fnc( self );
+    }
+  }
 
   void ResolverProblem::addSolution( ProblemSolution_Ptr solution, bool inFront )
   {
+    renderOnce( &LazyRender::solutions );
     if ( ! solutionInList( _pimpl->_solutions, solution ) )	// bsc#985674: filter duplicate solutions
     {
       if (inFront)
@@ -9,6 +9,7 @@
 #ifndef ZYPP_RESOLVERPROBLEM_H
 #define ZYPP_RESOLVERPROBLEM_H
 
+#include <functional>
 #include <list>
 #include <string>
 #include <vector>
@@ -25,6 +26,24 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////////
   class ResolverProblem : public base::ReferenceCounted
   {
+  public:
+    ///////////////////////////////////////////////////////////////////
+    /// \class ResolverProblem::LazyRender
+    /// \brief Problem data rendered on first access.
+    ///
+    /// The solver may leave formatting the (translated) strings and
+    /// building the solutions to the first access of the data. Each
+    /// function is called at most once and is passed the problem to
+    /// fill in via the setters. An empty function means there is
+    /// nothing to render.
+    ///////////////////////////////////////////////////////////////////
+    struct LazyRender
+    {
+      std::function<void(ResolverProblem &)> description;		///< Set \ref description and \ref details.
+      std::function<void(ResolverProblem &)> completeProblemInfo;	///< Set \ref completeProblemInfo.
+      std::function<void(ResolverProblem &)> solutions;		///< Add the \ref solutions.
+    };
+
   public:
     /** Constructor. */
     ResolverProblem();
@@ -34,6 +53,8 @@ namespace zypp
     ResolverProblem( std::string description, std::string details );
     /** Constructor. */
     ResolverProblem( std::string description, std::string details, std::vector<std::string> &&completeProblemInfo );
+    /** Constructor: data are rendered on first access. */
+    ResolverProblem( LazyRender lazyRender_r );
 
     /** Destructor. */
     ~ResolverProblem();
@@ -82,12 +103,31 @@ namespace zypp
      **/
     void setDetails( std::string details );
 
+    /**
+     * Set the one-line descriptions of the problematic rules.
+     **/
+    void setCompleteProblemInfo( std::vector<std::string> completeProblemInfo );
+
     /**
      * Add a solution to this problem. This class takes over ownership of
      * the problem and will delete it when neccessary.
      **/
     void addSolution( ProblemSolution_Ptr solution, bool inFront = false );
 
+    /**
+     * Whether all data are rendered (nothing is left to \ref LazyRender).
+     **/
+    bool rendered() const;
+
+    /**
+     * Render all data not yet rendered.
+     **/
+    void render() const;
+
+  private:
+    /** Call a pending \ref LazyRender function once. */
+    void renderOnce( std::function<void(ResolverProblem &)> LazyRender::* fnc_r ) const;
+
   private:
     struct Impl;
     RWCOW_pointer<Impl> _pimpl;
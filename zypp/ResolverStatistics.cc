@@ -0,0 +1,46 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverStatistics.cc
+ */
+#include <iostream>
+#include <zypp/ResolverStatistics.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  std::ostream & operator<<( std::ostream & str, const ResolverStatistics & obj )
+  {
+    auto ms = []( ResolverStatistics::Duration d ) {
+      return std::chrono::duration_cast<std::chrono::microseconds>( d ).count() / 1000.0;
+    };
+    str << "ResolverStatistics {" << std::endl;
+#define OUTS(V) str << "  " << #V << ":\t" << ms( obj.V ) << " ms" << std::endl
+    OUTS( jobs );
+    OUTS( prepare );
+    OUTS( solve );
+    OUTS( droplist );
+    OUTS( copyBack );
+    OUTS( problems );
+    OUTS( total() );
+#undef OUTS
+#define OUTS(V) str << "  " << #V << ":\t" << obj.V << std::endl
+    OUTS( solverRuns );
+    OUTS( reused );
+    OUTS( cached );
+    OUTS( jobCount );
+    OUTS( ruleCount );
+    OUTS( learntRules );
+    OUTS( decisions );
+    OUTS( problemCount );
+#undef OUTS
+    return str << "}";
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
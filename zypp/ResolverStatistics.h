@@ -0,0 +1,61 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverStatistics.h
+ */
+#ifndef ZYPP_RESOLVERSTATISTICS_H
+#define ZYPP_RESOLVERSTATISTICS_H
+
+#include <iosfwd>
+#include <chrono>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class ResolverStatistics
+  /// \brief Phase timings and counters of the last solver run.
+  /// \see \ref Resolver::statistics
+  ///////////////////////////////////////////////////////////////////
+  struct ResolverStatistics
+  {
+    typedef std::chrono::steady_clock::duration Duration;
+
+    /** \name Timings */
+    //@{
+    Duration jobs     = Duration::zero();	///< Building the solver job queue from the pool.
+    Duration prepare  = Duration::zero();	///< Preparing the pool (whatprovides).
+    Duration solve    = Duration::zero();	///< The solver run.
+    Duration droplist = Duration::zero();	///< Droplist processing incl. the 2nd solver run (DUP).
+    Duration copyBack = Duration::zero();	///< Mapping the result into the PoolItem status.
+    Duration problems = Duration::zero();	///< Building \ref ResolverProblem descriptions (summed up over \ref Resolver::problems calls).
+
+    /** Sum of all phases. */
+    Duration total() const
+    { return jobs + prepare + solve + droplist + copyBack + problems; }
+    //@}
+
+    /** \name Counters */
+    //@{
+    unsigned solverRuns   = 0;	///< Number of solver runs (2 if a droplist was processed).
+    bool     reused       = false;	///< Whether an unchanged result was reused (\ref Resolver::setIncrementalSolve).
+    bool     cached       = false;	///< Whether the result was restored from the result cache (\ref Resolver::setResultCachePath).
+    unsigned jobCount     = 0;	///< Number of solver jobs.
+    unsigned ruleCount    = 0;	///< Number of solver rules.
+    unsigned learntRules  = 0;	///< Number of rules learnt while solving.
+    unsigned decisions    = 0;	///< Number of solver decisions.
+    unsigned problemCount = 0;	///< Number of solver problems.
+    //@}
+  };
+
+  /** \relates ResolverStatistics Stream output */
+  std::ostream & operator<<( std::ostream & str, const ResolverStatistics & obj );
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_RESOLVERSTATISTICS_H
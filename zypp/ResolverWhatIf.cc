@@ -0,0 +1,355 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverWhatIf.cc
+ */
+extern "C"
+{
+#include <solv/repo_write.h>
+#include <solv/solver.h>
+}
+#include <iostream>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/Measure.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/TmpPath.h>
+#include <zypp/DiskUsageCounter.h>
+#include <zypp/PoolContext.h>
+#include <zypp/ResPool.h>
+#include <zypp/Resolver.h>
+#include <zypp/sat/Pool.h>
+
+#include <zypp/ResolverWhatIf.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  namespace
+  {
+    typedef sat::detail::SolvableIdType SolvableIdType;
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class WhatIfSetup
+    /// \brief What the workers need to know about the (frozen) global pool.
+    ///
+    /// Collected by the calling thread, so the workers never access the
+    /// global pool.
+    ///////////////////////////////////////////////////////////////////
+    struct WhatIfSetup
+    {
+      struct RepoDump
+      {
+        std::string _alias;
+        RepoInfo _info;
+        int _priority;
+        int _subpriority;
+        filesystem::TmpFile _solv;
+        std::vector<SolvableIdType> _solvables;	// in repo order
+      };
+
+      WhatIfSetup( Resolver & resolver_r )
+      {
+        sat::Pool satpool( sat::Pool::instance() );
+        for ( const Repository & repo : satpool.repos() )
+        {
+          _repos.push_back( RepoDump{ repo.alias(), repo.info(), repo.get()->priority, repo.get()->subpriority, filesystem::TmpFile(), {} } );
+          RepoDump & dump( _repos.back() );
+          {
+            AutoFILE file( ::fopen( dump._solv.path().c_str(), "we" ) );
+            if ( ! file || ::repo_write( repo.get(), file ) != 0 )
+              ZYPP_THROW( Exception( "Can't write solv-file for " + repo.alias() ) );
+          }
+          for_( it, repo.solvablesBegin(), repo.solvablesEnd() )
+            dump._solvables.push_back( it->id() );
+        }
+        _requestedLocales = satpool.getRequestedLocales();
+        _autoInstalled = satpool.autoInstalled();
+
+        for ( const PoolItem & pi : ResPool::instance() )
+          _status.push_back( std::make_pair( pi.id(), pi.status() ) );
+
+        _focus                    = resolver_r.focus();
+        _forceResolve             = resolver_r.forceResolve();
+        _ignoreAlreadyRecommended = resolver_r.ignoreAlreadyRecommended();
+        _onlyRequires             = resolver_r.onlyRequires();
+        _upgradeMode              = resolver_r.upgradeMode();
+        _updateMode               = resolver_r.updateMode();
+        _allowDowngrade           = resolver_r.allowDowngrade();
+        _allowNameChange          = resolver_r.allowNameChange();
+        _allowArchChange          = resolver_r.allowArchChange();
+        _allowVendorChange        = resolver_r.allowVendorChange();
+        _systemVerification       = resolver_r.systemVerification();
+        _solveSrcPackages         = resolver_r.solveSrcPackages();
+        _cleandepsOnRemove        = resolver_r.cleandepsOnRemove();
+        _dupAllowDowngrade        = resolver_r.dupAllowDowngrade();
+        _dupAllowNameChange       = resolver_r.dupAllowNameChange();
+        _dupAllowArchChange       = resolver_r.dupAllowArchChange();
+        _dupAllowVendorChange     = resolver_r.dupAllowVendorChange();
+        _requires                 = resolver_r.getRequire();
+        _conflicts                = resolver_r.getConflict();
+        for ( IdString ident : resolver_r.getInstallNames() )
+          _installNames.push_back( ident.asString() );
+      }
+
+      /** Apply the resolver settings to a workers resolver. */
+      void setup( Resolver & resolver_r ) const
+      {
+        resolver_r.setFocus( _focus );
+        resolver_r.setForceResolve( _forceResolve );
+        resolver_r.setIgnoreAlreadyRecommended( _ignoreAlreadyRecommended );
+        resolver_r.setOnlyRequires( _onlyRequires );
+        resolver_r.setUpgradeMode( _upgradeMode );
+        resolver_r.setUpdateMode( _updateMode );
+        resolver_r.setAllowDowngrade( _allowDowngrade );
+        resolver_r.setAllowNameChange( _allowNameChange );
+        resolver_r.setAllowArchChange( _allowArchChange );
+        resolver_r.setAllowVendorChange( _allowVendorChange );
+        resolver_r.setSystemVerification( _systemVerification );
+        resolver_r.setSolveSrcPackages( _solveSrcPackages );
+        resolver_r.setCleandepsOnRemove( _cleandepsOnRemove );
+        resolver_r.dupSetAllowDowngrade( _dupAllowDowngrade );
+        resolver_r.dupSetAllowNameChange( _dupAllowNameChange );
+        resolver_r.dupSetAllowArchChange( _dupAllowArchChange );
+        resolver_r.dupSetAllowVendorChange( _dupAllowVendorChange );
+        resolver_r.addInstallSpecs( _installNames );
+      }
+
+      std::vector<RepoDump> _repos;
+      LocaleSet _requestedLocales;
+      sat::Queue _autoInstalled;
+      std::vector<std::pair<SolvableIdType,ResStatus>> _status;
+
+      ResolverFocus _focus;
+      bool _forceResolve;
+      bool _ignoreAlreadyRecommended;
+      bool _onlyRequires;
+      bool _upgradeMode;
+      bool _updateMode;
+      bool _allowDowngrade;
+      bool _allowNameChange;
+      bool _allowArchChange;
+      bool _allowVendorChange;
+      bool _systemVerification;
+      bool _solveSrcPackages;
+      bool _cleandepsOnRemove;
+      bool _dupAllowDowngrade;
+      bool _dupAllowNameChange;
+      bool _dupAllowArchChange;
+      bool _dupAllowVendorChange;
+      CapabilitySet _requires;
+      CapabilitySet _conflicts;
+      std::vector<std::string> _installNames;
+    };
+
+    /** A workers result in terms of global pool ids (turned into PoolItems by the caller). */
+    struct WhatIfRawResult
+    {
+      bool _solved = false;
+      unsigned _problems = 0;
+      std::vector<SolvableIdType> _toInstall;
+      std::vector<SolvableIdType> _toRemove;
+      ByteCount _diskUsageDelta;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class WhatIfWorker
+    /// \brief A private clone of the global pool solving \ref WhatIfJobs.
+    ///
+    /// Must be created and used within the workers thread. Repos are loaded
+    /// in the global pools order, so the n-th solvable of each clone repo
+    /// corresponds to the n-th solvable of the original one.
+    ///////////////////////////////////////////////////////////////////
+    class WhatIfWorker
+    {
+    public:
+      WhatIfWorker( const WhatIfSetup & setup_r )
+      : _setup( setup_r )
+      , _scope( _context )
+      {
+        sat::Pool satpool( sat::Pool::instance() );
+        for ( const WhatIfSetup::RepoDump & dump : _setup._repos )
+        {
+          Repository repo( satpool.addRepoSolv( dump._solv.path(), dump._alias ) );
+          if ( dump._info.alias() == dump._alias )
+            repo.setInfo( dump._info );
+          repo.get()->priority = dump._priority;
+          repo.get()->subpriority = dump._subpriority;
+
+          unsigned idx = 0;
+          for_( it, repo.solvablesBegin(), repo.solvablesEnd() )
+          {
+            if ( idx == dump._solvables.size() )
+              break;
+            map( dump._solvables[idx++], it->id() );
+          }
+          if ( idx != dump._solvables.size() || repo.solvablesSize() != dump._solvables.size() )
+            ZYPP_THROW( Exception( "Cloned repo differs from the original: " + dump._alias ) );
+        }
+        satpool.setRequestedLocales( _setup._requestedLocales );
+        satpool.setAutoInstalled( _setup._autoInstalled );
+
+        _resolver = _context.resolver();
+        _setup.setup( *_resolver );
+      }
+
+      WhatIfRawResult solve( const WhatIfJobs & jobs_r )
+      {
+        ResPool pool( ResPool::instance() );
+        for ( const auto & el : _setup._status )
+          toClone( el.first ).status() = el.second;
+
+        for ( const PoolItem & pi : jobs_r.install )
+          toClone( pi.id() ).status().setTransact( true, ResStatus::USER );
+        for ( const PoolItem & pi : jobs_r.remove )
+          toClone( pi.id() ).status().setToBeUninstalled( ResStatus::USER );
+
+        CapabilitySet requires( _setup._requires );
+        requires.insert( jobs_r.requires.begin(), jobs_r.requires.end() );
+        CapabilitySet conflicts( _setup._conflicts );
+        conflicts.insert( jobs_r.conflicts.begin(), jobs_r.conflicts.end() );
+        for ( const Capability & cap : requires )
+          _resolver->addRequire( cap );
+        for ( const Capability & cap : conflicts )
+          _resolver->addConflict( cap );
+
+        WhatIfRawResult ret;
+        ret._solved = _resolver->resolvePool();
+        ret._problems = ::solver_problem_count( _resolver->get() );
+        for ( const PoolItem & pi : pool )
+        {
+          if ( pi.status().isToBeInstalled() )
+            ret._toInstall.push_back( fromClone( pi.id() ) );
+          else if ( pi.status().isToBeUninstalled() )
+            ret._toRemove.push_back( fromClone( pi.id() ) );
+        }
+        DiskUsageCounter::MountPointSet du( DiskUsageCounter( DiskUsageCounter::justRootPartition() ).disk_usage( pool ) );
+        if ( ! du.empty() )
+          ret._diskUsageDelta = du.begin()->commitDiff();
+
+        for ( const Capability & cap : requires )
+          _resolver->removeRequire( cap );
+        for ( const Capability & cap : conflicts )
+          _resolver->removeConflict( cap );
+        return ret;
+      }
+
+    private:
+      void map( SolvableIdType orig_r, SolvableIdType clone_r )
+      {
+        if ( _toClone.size() <= orig_r )
+          _toClone.resize( orig_r+1 );
+        _toClone[orig_r] = clone_r;
+        if ( _fromClone.size() <= clone_r )
+          _fromClone.resize( clone_r+1 );
+        _fromClone[clone_r] = orig_r;
+      }
+
+      PoolItem toClone( SolvableIdType orig_r ) const
+      {
+        if ( orig_r >= _toClone.size() || ! _toClone[orig_r] )
+          ZYPP_THROW( Exception( str::Str() << "Solvable " << orig_r << " is not in the pool clone" ) );
+        return PoolItem( sat::Solvable( _toClone[orig_r] ) );
+      }
+
+      SolvableIdType fromClone( SolvableIdType clone_r ) const
+      { return clone_r < _fromClone.size() ? _fromClone[clone_r] : 0; }
+
+    private:
+      const WhatIfSetup & _setup;
+      PoolContext _context;
+      PoolContext::Scope _scope;
+      Resolver_Ptr _resolver;
+      std::vector<SolvableIdType> _toClone;
+      std::vector<SolvableIdType> _fromClone;
+    };
+
+    inline std::vector<PoolItem> asPoolItems( const std::vector<SolvableIdType> & ids_r )
+    {
+      std::vector<PoolItem> ret;
+      ret.reserve( ids_r.size() );
+      for ( SolvableIdType id : ids_r )
+        ret.push_back( PoolItem( sat::Solvable( id ) ) );
+      return ret;
+    }
+  } // namespace
+
+  ///////////////////////////////////////////////////////////////////
+  //	class Resolver
+  ///////////////////////////////////////////////////////////////////
+
+  std::vector<WhatIfResult> Resolver::whatIf( const std::vector<WhatIfJobs> & jobs_r, unsigned threads_r )
+  {
+    std::vector<WhatIfResult> ret( jobs_r.size() );
+    if ( jobs_r.empty() )
+      return ret;
+    if ( ! PoolContext::current().isDefault() )
+      ZYPP_THROW( Exception( "Resolver::whatIf: requires the global pool" ) );
+
+    debug::Measure m( "whatIf" );
+    sat::Pool::Frozen frozen( sat::Pool::instance().freeze() );
+    WhatIfSetup setup( *this );
+
+    unsigned nthreads = threads_r ? threads_r : std::min( std::max( std::thread::hardware_concurrency(), 1U ), 8U );
+    nthreads = std::min<unsigned>( nthreads, jobs_r.size() );
+    MIL << "Evaluating " << jobs_r.size() << " alternatives using " << nthreads << " threads" << endl;
+
+    std::vector<WhatIfRawResult> raw( jobs_r.size() );
+    std::atomic<unsigned> next( 0 );
+    std::vector<std::exception_ptr> errors( nthreads );
+    std::vector<std::thread> threads;
+    for ( unsigned t = 0; t < nthreads; ++t )
+    {
+      threads.push_back( std::thread( [&,t]() {
+        try
+        {
+          WhatIfWorker worker( setup );
+          for ( unsigned idx = next++; idx < jobs_r.size(); idx = next++ )
+            raw[idx] = worker.solve( jobs_r[idx] );
+        }
+        catch ( ... )
+        {
+          errors[t] = std::current_exception();
+          next = jobs_r.size();	// let the others stop
+        }
+      } ) );
+    }
+    for ( std::thread & thread : threads )
+      thread.join();
+    for ( const std::exception_ptr & error : errors )
+    {
+      if ( error )
+        std::rethrow_exception( error );
+    }
+
+    for ( unsigned idx = 0; idx < raw.size(); ++idx )
+    {
+      ret[idx].solved = raw[idx]._solved;
+      ret[idx].problems = raw[idx]._problems;
+      ret[idx].toInstall = asPoolItems( raw[idx]._toInstall );
+      ret[idx].toRemove = asPoolItems( raw[idx]._toRemove );
+      ret[idx].diskUsageDelta = raw[idx]._diskUsageDelta;
+    }
+    return ret;
+  }
+
+  std::ostream & operator<<( std::ostream & str, const WhatIfResult & obj )
+  {
+    return str << "WhatIfResult(" << ( obj.solved ? "solved" : "failed" )
+               << ", " << obj.problems << " problems"
+               << ", +" << obj.toInstall.size() << "/-" << obj.toRemove.size()
+               << ", " << obj.diskUsageDelta << ")";
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,58 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverWhatIf.h
+ */
+#ifndef ZYPP_RESOLVERWHATIF_H
+#define ZYPP_RESOLVERWHATIF_H
+
+#include <iosfwd>
+#include <vector>
+
+#include <zypp/ByteCount.h>
+#include <zypp/Capability.h>
+#include <zypp/PoolItem.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class WhatIfJobs
+  /// \brief One alternative request evaluated by \ref Resolver::whatIf.
+  ///
+  /// The jobs are added to the current state of the \ref ResPool
+  /// (the transactions and locks set in the pool plus the resolvers
+  /// additional requires and conflicts).
+  ///////////////////////////////////////////////////////////////////
+  struct WhatIfJobs
+  {
+    std::vector<PoolItem> install;	///< Items to install.
+    std::vector<PoolItem> remove;	///< Installed items to remove.
+    CapabilitySet requires;		///< Additional requirements.
+    CapabilitySet conflicts;		///< Additional conflicts.
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class WhatIfResult
+  /// \brief The outcome of one \ref WhatIfJobs.
+  ///////////////////////////////////////////////////////////////////
+  struct WhatIfResult
+  {
+    bool solved = false;		///< Whether the solver run succeeded.
+    unsigned problems = 0;		///< Number of solver problems.
+    std::vector<PoolItem> toInstall;	///< Items the transaction would install.
+    std::vector<PoolItem> toRemove;	///< Installed items the transaction would remove.
+    ByteCount diskUsageDelta;		///< Change of the used disk space after commit.
+  };
+
+  /** \relates WhatIfResult Stream output */
+  std::ostream & operator<<( std::ostream & str, const WhatIfResult & obj );
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_RESOLVERWHATIF_H
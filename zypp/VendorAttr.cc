@@ -12,6 +12,8 @@
 #include <fstream>
 #include <set>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <zypp/base/LogTools.h>
@@ -50,6 +52,12 @@ namespace zypp
     Impl()
     { _vendorGroupMap["suse"] = ++_vendorGroupId; }
 
+    /** Copy the vendor groups, but not the match cache (nor its mutex). */
+    Impl( const Impl & rhs )
+    : _vendorGroupMap( rhs._vendorGroupMap )
+    , _vendorGroupId( rhs._vendorGroupId )
+    {}
+
   public:
     /** Add a new equivalent vendor set. */
     void addVendorList( VendorList && vendorList_r );
@@ -83,13 +91,15 @@ namespace zypp
 
   private:
     typedef DefaultIntegral<unsigned,0>				VendorMatchEntry;
-    typedef std::unordered_map<IdString, VendorMatchEntry>	VendorMatch;
-    mutable VendorMatch _vendorMatch;	///< Cache mapping vendor strings to equivalence class ID
+    typedef std::unordered_map<std::string, VendorMatchEntry>	VendorMatch;
+    mutable VendorMatch _vendorMatch;	///< Cache mapping vendor strings to equivalence class ID (not ids, they differ per \ref PoolContext)
     mutable unsigned _nextId = 0;	///< Least equivalence class ID in use (decremented).
+    mutable std::mutex _vendorMatchMutex;	///< Guards the match cache, filled by const lookups from any thread.
 
     /** Reset vendor match cache if _vendorGroupMap was changed. */
     void vendorMatchIdReset()
     {
+      std::lock_guard<std::mutex> guard( _vendorMatchMutex );
       _nextId = 0;
       _vendorMatch.clear();
     }
@@ -112,10 +122,11 @@ namespace zypp
 
   unsigned VendorAttr::Impl::vendorMatchId( IdString vendor ) const
   {
-    VendorMatchEntry & ent { _vendorMatch[vendor] };
+    std::lock_guard<std::mutex> guard( _vendorMatchMutex );
+    VendorMatchEntry & ent { _vendorMatch[vendor.asString()] };
     if ( ! ent )
     {
-      IdString lcvendor { str::toLower( vendor.asString() ) };
+      std::string lcvendor { str::toLower( vendor.asString() ) };
       VendorMatchEntry & lcent( _vendorMatch[lcvendor] );
       if ( ! lcent )
       {
@@ -313,6 +313,7 @@ namespace zypp
         , repo_add_probe          	( false )
         , repo_refresh_delay      	( 10 )
         , repoLabelIsAlias              ( false )
+        , repo_trigramIndex		( false )
         , download_use_deltarpm   	( true )
         , download_use_deltarpm_always  ( false )
         , download_media_prefer_download( true )
@@ -433,6 +434,10 @@ namespace zypp
 		  repoRefreshLocales.insert( make_transform_iterator( tmp.begin(), transform ),
 					     make_transform_iterator( tmp.end(), transform ) );
 		}
+                else if ( entry == "repo.trigramindex" )
+                {
+                  repo_trigramIndex = str::strToBool( value, repo_trigramIndex );
+                }
                 else if ( entry == "download.use_deltarpm" )
                 {
                   download_use_deltarpm = str::strToBool( value, download_use_deltarpm );
@@ -549,6 +554,10 @@ namespace zypp
                 {
                   solver_checkSystemFileDir = Pathname(value);
                 }
+                else if ( entry == "solver.resultCachePath" )
+                {
+                  solver_resultCachePath = Pathname(value);
+                }
                 else if ( entry == "multiversion" )
                 {
 		  MultiversionSpec & defSpec( _multiversionMap.getDefaultSpec() );
@@ -655,6 +664,7 @@ namespace zypp
     unsigned	repo_refresh_delay;
     LocaleSet	repoRefreshLocales;
     bool	repoLabelIsAlias;
+    bool	repo_trigramIndex;
 
     bool download_use_deltarpm;
     bool download_use_deltarpm_always;
@@ -686,6 +696,7 @@ namespace zypp
 
     Pathname solver_checkSystemFile;
     Pathname solver_checkSystemFileDir;
+    Pathname solver_resultCachePath;
 
     MultiversionSpec &		multiversion()		{ return getMultiversion(); }
     const MultiversionSpec &	multiversion() const	{ return getMultiversion(); }
@@ -1022,6 +1033,9 @@ namespace zypp
   void ZConfig::repoLabelIsAlias( bool yesno_r )
   { _pimpl->repoLabelIsAlias = yesno_r; }
 
+  bool ZConfig::repo_trigramIndex() const
+  { return _pimpl->repo_trigramIndex; }
+
   bool ZConfig::download_use_deltarpm() const
   { return _pimpl->download_use_deltarpm; }
 
@@ -1099,6 +1113,9 @@ namespace zypp
   unsigned ZConfig::solver_upgradeTestcasesToKeep() const
   { return _pimpl->solver_upgradeTestcasesToKeep; }
 
+  Pathname ZConfig::solver_resultCachePath() const
+  { return _pimpl->solver_resultCachePath; }
+
   bool ZConfig::solverUpgradeRemoveDroppedPackages() const		{ return _pimpl->solverUpgradeRemoveDroppedPackages; }
   void ZConfig::setSolverUpgradeRemoveDroppedPackages( bool val_r )	{ _pimpl->solverUpgradeRemoveDroppedPackages.set( val_r ); }
   void ZConfig::resetSolverUpgradeRemoveDroppedPackages()		{ _pimpl->solverUpgradeRemoveDroppedPackages.restoreToDefault(); }
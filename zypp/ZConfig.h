@@ -258,6 +258,14 @@ namespace zypp
        */
       void repoLabelIsAlias( bool yesno_r );
 
+      /**
+       * Whether to build a trigram index for each repos solv file.
+       * \ref PoolQuery uses it to speed up substring, glob and regex
+       * searches in names, summaries, descriptions and filelists.
+       * Config option <tt>repo.trigramindex (false)</tt>
+       */
+      bool repo_trigramIndex() const;
+
       /**
        * Maximum number of concurrent connections for a single transfer
        */
@@ -414,6 +422,13 @@ namespace zypp
        */
       unsigned solver_upgradeTestcasesToKeep() const;
 
+      /**
+       * Directory where the results of successful solver runs are cached
+       * (empty: no caching).
+       * \see \ref Resolver::setResultCachePath
+       */
+      Pathname solver_resultCachePath() const;
+
       /** Whether dist upgrade should remove a products dropped packages (true).
        *
        * A new product may suggest a list of old and no longer supported
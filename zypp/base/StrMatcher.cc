@@ -14,12 +14,17 @@ extern "C"
 #include <solv/repo.h>
 }
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include <zypp/base/LogTools.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/String.h>
+#include <zypp/base/NonCopyable.h>
 
 #include <zypp/base/StrMatcher.h>
 #include <zypp/sat/detail/PoolMember.h>
@@ -158,12 +163,332 @@ namespace zypp
                               : str::form(_("Invalid regular expression '%s'"), regex_r.c_str() ) )
   {}
 
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    inline unsigned char fold( unsigned char ch_r )
+    { return ( ch_r >= 'A' && ch_r <= 'Z' ) ? ch_r + ( 'a' - 'A' ) : ch_r; }
+
+    inline unsigned char unfold( unsigned char ch_r )
+    { return ( ch_r >= 'a' && ch_r <= 'z' ) ? ch_r - ( 'a' - 'A' ) : ch_r; }
+
+    /** Compare \a len_r bytes of \a str_r to the lowercased \a lower_r, ignoring case. */
+    inline bool equalNocase( const char * str_r, const char * lower_r, size_t len_r )
+    {
+      for ( size_t i = 0; i < len_r; ++i )
+      {
+        if ( fold( str_r[i] ) != (unsigned char)lower_r[i] )
+          return false;
+      }
+      return true;
+    }
+
+    /** Whether the lowercased \a needle_r occurs in \a hay_r (of length \a len_r), ignoring case.
+     * The SSE2 kernel compares 16 positions at once against the needles
+     * first and last byte (either case), and verifies the remaining bytes
+     * of the candidates only.
+     */
+    bool findNocase( const char * hay_r, size_t len_r, const std::string & needle_r )
+    {
+      size_t k = needle_r.size();
+      if ( k == 0 )
+        return true;
+      if ( len_r < k )
+        return false;
+
+      size_t i = 0;
+#ifdef __SSE2__
+      const unsigned char first = needle_r[0];
+      const unsigned char last  = needle_r[k-1];
+      const __m128i f1 = _mm_set1_epi8( first );
+      const __m128i f2 = _mm_set1_epi8( unfold( first ) );
+      const __m128i l1 = _mm_set1_epi8( last );
+      const __m128i l2 = _mm_set1_epi8( unfold( last ) );
+      for ( ; i + k + 15 <= len_r; i += 16 )
+      {
+        const __m128i bf = _mm_loadu_si128( (const __m128i *)( hay_r + i ) );
+        const __m128i bl = _mm_loadu_si128( (const __m128i *)( hay_r + i + k - 1 ) );
+        const __m128i ef = _mm_or_si128( _mm_cmpeq_epi8( bf, f1 ), _mm_cmpeq_epi8( bf, f2 ) );
+        const __m128i el = _mm_or_si128( _mm_cmpeq_epi8( bl, l1 ), _mm_cmpeq_epi8( bl, l2 ) );
+        unsigned mask = _mm_movemask_epi8( _mm_and_si128( ef, el ) );
+        while ( mask )
+        {
+          unsigned bit = __builtin_ctz( mask );
+          if ( k <= 2 || equalNocase( hay_r + i + bit + 1, needle_r.data() + 1, k - 2 ) )
+            return true;
+          mask &= mask - 1;
+        }
+      }
+#endif
+      for ( ; i + k <= len_r; ++i )
+      {
+        if ( equalNocase( hay_r + i, needle_r.data(), k ) )
+          return true;
+      }
+      return false;
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class GlobAutomaton
+    /// \brief A glob pattern compiled into a token sequence.
+    ///
+    /// Matches like \c fnmatch(3) without flags: \c * and \c ? match any
+    /// char (including \c /), bracket expressions and backslash escapes are
+    /// supported. Patterns using character classes (\c [:alpha:]), case
+    /// insensitive bracket expressions or a dangling \c [ or \c \\ are not
+    /// compiled and left to libsolv.
+    ///////////////////////////////////////////////////////////////////
+    class GlobAutomaton
+    {
+      enum TokenType { T_CHAR, T_ANY, T_STAR, T_SET };
+      struct Token
+      {
+        TokenType	_type;
+        unsigned char	_ch;
+        unsigned	_set;
+      };
+
+    public:
+      /** Compile \a glob_r; \c false if the pattern is not supported. */
+      bool compile( const std::string & glob_r, bool nocase_r )
+      {
+        _nocase = nocase_r;
+        for ( std::string::size_type i = 0; i < glob_r.size(); ++i )
+        {
+          unsigned char ch = glob_r[i];
+          switch ( ch )
+          {
+            case '*':
+              if ( _tokens.empty() || _tokens.back()._type != T_STAR )
+                _tokens.push_back( { T_STAR, 0, 0 } );
+              break;
+
+            case '?':
+              _tokens.push_back( { T_ANY, 0, 0 } );
+              break;
+
+            case '\\':
+              if ( ++i == glob_r.size() )
+                return false;
+              _tokens.push_back( { T_CHAR, foldIf( glob_r[i] ), 0 } );
+              break;
+
+            case '[':
+            {
+              if ( _nocase )
+                return false;
+              std::vector<bool> set( 256, false );
+              std::string::size_type e = i+1;
+              bool negate = ( e < glob_r.size() && ( glob_r[e] == '!' || glob_r[e] == '^' ) );
+              if ( negate )
+                ++e;
+              bool first = true;
+              for ( ; e < glob_r.size() && ( first || glob_r[e] != ']' ); ++e, first = false )
+              {
+                unsigned char lo = glob_r[e];
+                if ( lo == '\\' || ( lo == '[' && e+1 < glob_r.size() && ::strchr( ":.=", glob_r[e+1] ) ) )
+                  return false;	// escapes and classes inside brackets: leave them to fnmatch
+                unsigned char hi = lo;
+                if ( e+2 < glob_r.size() && glob_r[e+1] == '-' && glob_r[e+2] != ']' )
+                {
+                  hi = glob_r[e+2];
+                  e += 2;
+                }
+                for ( unsigned c = lo; c <= hi; ++c )
+                  set[c] = true;
+              }
+              if ( e == glob_r.size() )
+                return false;	// no closing ']'
+              if ( negate )
+                set.flip();
+              _sets.push_back( std::move(set) );
+              _tokens.push_back( { T_SET, 0, unsigned(_sets.size()-1) } );
+              i = e;
+              break;
+            }
+
+            default:
+              _tokens.push_back( { T_CHAR, foldIf( ch ), 0 } );
+              break;
+          }
+        }
+        return true;
+      }
+
+      /** Whether \a str_r matches. Iterative, backtracking to the last \c * only. */
+      bool match( const char * str_r ) const
+      {
+        size_t ntok = _tokens.size();
+        size_t t = 0;
+        size_t starT = std::string::npos;
+        const char * starS = nullptr;
+        const char * s = str_r;
+        while ( *s )
+        {
+          if ( t < ntok && _tokens[t]._type == T_STAR )
+          {
+            starT = t++;
+            starS = s;
+          }
+          else if ( t < ntok && matches( _tokens[t], *s ) )
+          {
+            ++t;
+            ++s;
+          }
+          else if ( starT != std::string::npos )
+          {
+            t = starT + 1;
+            s = ++starS;
+          }
+          else
+            return false;
+        }
+        while ( t < ntok && _tokens[t]._type == T_STAR )
+          ++t;
+        return t == ntok;
+      }
+
+    private:
+      unsigned char foldIf( unsigned char ch_r ) const
+      { return _nocase ? fold( ch_r ) : ch_r; }
+
+      bool matches( const Token & tok_r, unsigned char ch_r ) const
+      {
+        switch ( tok_r._type )
+        {
+          case T_CHAR:	return tok_r._ch == foldIf( ch_r );
+          case T_ANY:	return true;
+          case T_SET:	return _sets[tok_r._set][ch_r];
+          case T_STAR:	break;
+        }
+        return false;
+      }
+
+    private:
+      bool _nocase = false;
+      std::vector<Token> _tokens;
+      std::vector<std::vector<bool>> _sets;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class CompiledMatcher
+    /// \brief A compiled pattern.
+    ///
+    /// String modes and most globs are matched by our own kernels.
+    /// Regex (and anything else) uses libsolvs datamatcher. Matching
+    /// does not modify the object, so it may be used concurrently.
+    ///////////////////////////////////////////////////////////////////
+    class CompiledMatcher : private base::NonCopyable
+    {
+      enum Kernel { K_DATAMATCHER, K_STRING, K_STRINGSTART, K_STRINGEND, K_SUBSTRING, K_GLOB };
+
+    public:
+      /** \throw MatchException if the pattern does not compile. */
+      CompiledMatcher( const std::string & search_r, const Match & flags_r )
+      : _nocase( flags_r.test( Match::NOCASE ) )
+      {
+        switch ( flags_r.mode() )
+        {
+          case Match::STRING:		_kernel = K_STRING;		break;
+          case Match::STRINGSTART:	_kernel = K_STRINGSTART;	break;
+          case Match::STRINGEND:	_kernel = K_STRINGEND;		break;
+          case Match::SUBSTRING:	_kernel = K_SUBSTRING;		break;
+          case Match::GLOB:
+            if ( search_r.find_first_of( "*?[\\" ) == std::string::npos )
+              _kernel = K_STRING;	// no wildcards
+            else if ( _glob.compile( search_r, _nocase ) )
+              _kernel = K_GLOB;
+            break;
+          case Match::OTHER:
+            ZYPP_THROW( MatchUnknownModeException( flags_r, search_r ) );
+            break;
+          case Match::NOTHING:
+          case Match::REGEX:
+            break;
+        }
+
+        if ( _kernel == K_DATAMATCHER )
+        {
+          _matcher.reset( new sat::detail::CDatamatcher );
+          int res = ::datamatcher_init( _matcher.get(), search_r.c_str(), flags_r.get() );
+          if ( res )
+          {
+            _matcher.reset();
+            ZYPP_THROW( MatchInvalidRegexException( search_r, res ) );
+          }
+        }
+        else
+        {
+          _needle = search_r;
+          if ( _nocase )
+          {
+            for ( char & ch : _needle )
+              ch = fold( ch );
+          }
+        }
+      }
+
+      ~CompiledMatcher()
+      {
+        if ( _matcher )
+          ::datamatcher_free( _matcher.get() );
+      }
+
+      bool match( const char * string_r ) const
+      {
+        switch ( _kernel )
+        {
+          case K_STRING:
+            return _nocase ? ( ::strlen( string_r ) == _needle.size() && equalNocase( string_r, _needle.c_str(), _needle.size() ) )
+                           : ( _needle == string_r );
+
+          case K_STRINGSTART:
+            return _nocase ? ( ::strnlen( string_r, _needle.size() ) == _needle.size() && equalNocase( string_r, _needle.c_str(), _needle.size() ) )
+                           : ( ::strncmp( string_r, _needle.c_str(), _needle.size() ) == 0 );
+
+          case K_STRINGEND:
+          {
+            size_t len = ::strlen( string_r );
+            if ( len < _needle.size() )
+              return false;
+            const char * tail = string_r + len - _needle.size();
+            return _nocase ? equalNocase( tail, _needle.c_str(), _needle.size() )
+                           : ( ::memcmp( tail, _needle.c_str(), _needle.size() ) == 0 );
+          }
+
+          case K_SUBSTRING:
+          {
+            size_t len = ::strlen( string_r );
+            return _nocase ? findNocase( string_r, len, _needle )
+                           : ( ::memmem( string_r, len, _needle.c_str(), _needle.size() ) != nullptr );
+          }
+
+          case K_GLOB:
+            return _glob.match( string_r );
+
+          case K_DATAMATCHER:
+            break;
+        }
+        return ::datamatcher_match( _matcher.get(), string_r );
+      }
+
+    private:
+      Kernel _kernel = K_DATAMATCHER;
+      bool _nocase;
+      std::string _needle;	// lowercased if _nocase
+      GlobAutomaton _glob;
+      scoped_ptr<sat::detail::CDatamatcher> _matcher;
+    };
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
   ///////////////////////////////////////////////////////////////////
   /// \class StrMatcher::Impl
   /// \brief StrMatcher implementation.
   ///
-  /// \note Take care to release any allocated regex by calling
-  /// \c ::datamatcher_free.
+  /// \note \ref sat::LookupAttr (and so \ref PoolQuery) pass the pattern
+  /// to libsolvs dataiterator, which compiles its own matcher. There the
+  /// \ref CompiledMatcher just validates the pattern.
   ///////////////////////////////////////////////////////////////////
   struct StrMatcher::Impl
   {
@@ -175,9 +500,6 @@ namespace zypp
     , _flags( flags_r )
     {}
 
-    ~Impl()
-    { invalidate(); }
-
     /** Compile the pattern. */
     void compile() const
     {
@@ -186,13 +508,7 @@ namespace zypp
 	if ( _flags.mode() == Match::OTHER )
 	  ZYPP_THROW( MatchUnknownModeException( _flags, _search ) );
 
-	_matcher.reset( new sat::detail::CDatamatcher );
-	int res = ::datamatcher_init( _matcher.get(), _search.c_str(), _flags.get() );
-	if ( res )
-	{
-	  _matcher.reset();
-	  ZYPP_THROW( MatchInvalidRegexException( _search, res ) );
-	}
+	_matcher.reset( new CompiledMatcher( _search, _flags ) );
       }
     }
 
@@ -207,7 +523,7 @@ namespace zypp
 
       if ( ! string_r )
 	return false; // NULL never matches
-      return ::datamatcher_match( _matcher.get(), string_r );
+      return _matcher->match( string_r );
     }
 
     /** The current searchstring. */
@@ -229,16 +545,12 @@ namespace zypp
   private:
     /** Has to be called if _search or _flags change. */
     void invalidate()
-    {
-      if ( _matcher )
-	::datamatcher_free( _matcher.get() );
-      _matcher.reset();
-    }
+    { _matcher.reset(); }
 
   private:
     std::string _search;
     Match       _flags;
-    mutable scoped_ptr< sat::detail::CDatamatcher> _matcher;
+    mutable scoped_ptr<const CompiledMatcher> _matcher;
 
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
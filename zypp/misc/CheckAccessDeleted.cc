@@ -13,7 +13,17 @@
 #include <fstream>
 #include <unordered_set>
 #include <iterator>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <stdio.h>
+#include <unistd.h>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <zypp/base/LogTools.h>
 #include <zypp/base/String.h>
 #include <zypp/base/Gettext.h>
@@ -24,7 +34,6 @@
 #include <zypp/base/Regex.h>
 #include <zypp/base/IOStream.h>
 #include <zypp/base/InputStream.h>
-#include <zypp/target/rpm/librpmDb.h>
 
 #include <zypp/misc/CheckAccessDeleted.h>
 
@@ -163,28 +172,201 @@ namespace zypp
     };
 
 
-    /** bsc#1099847: Check for lsof version < 4.90 which does not support '-K i'
-     * Just a quick check to allow code15 libzypp runnig in a code12 environment.
-     * bsc#1036304: '-K i' was backported to older lsof versions, indicated by
-     * lsof providing 'backported-option-Ki'.
-     */
-    bool lsofNoOptKi()
+    /////////////////////////////////////////////////////////////////
+    /// \class ProcScanner
+    /// \brief Native replacement for 'lsof -n -FpcuLRftkn0 -K i'.
+    ///
+    /// Collects the deleted executables and memory mapped files of
+    /// all processes by reading /proc/<pid>/exe and /proc/<pid>/maps.
+    /// PIDs are scanned in parallel worker threads.
+    ///
+    /// The result is produced in lsof's NUL separated field format, so
+    /// it passes the same filters and a debug output file written from
+    /// it can be replayed by \ref CheckAccessDeleted::check(const Pathname &, bool).
+    ///
+    /// \note The workers use plain syscalls only (no logging, no
+    /// exceptions). Everything else happens on the calling thread.
+    /////////////////////////////////////////////////////////////////
+    struct ProcScanner
+    {
+      /** lsof style lines for one PID (the 'p' line first) */
+      typedef std::vector<std::string> PidLines;
+
+      /** Scan all PIDs below \c /proc. Only PIDs accessing deleted files are reported. */
+      std::vector<PidLines> operator()() const
+      {
+        std::vector<pid_t> pids;
+        filesystem::dirForEach( "/proc", [&pids]( const Pathname & dir_r, const char *const & name_r ) {
+          if ( *name_r >= '1' && *name_r <= '9' )
+            pids.push_back( str::strtonum<pid_t>( name_r ) );
+          return true;
+        } );
+        if ( pids.empty() )
+          ZYPP_THROW( Exception( "Unable to read the process list from /proc." ) );
+
+        std::vector<PidLines> result( pids.size() );
+        std::atomic<size_t> next( 0 );
+        auto worker = [&]() {
+          for ( size_t idx = next++; idx < pids.size(); idx = next++ )
+            scanPid( pids[idx], result[idx] );
+        };
+
+        unsigned nthreads = std::min<unsigned>( std::max( std::thread::hardware_concurrency(), 1U ), 8U );
+        nthreads = std::min<size_t>( nthreads, ( pids.size() + 63 ) / 64 );	// not worth it for a few pids
+        std::vector<std::thread> threads;
+        for ( unsigned i = 1; i < nthreads; ++i )
+          threads.emplace_back( worker );
+        worker();
+        for ( auto & t : threads )
+          t.join();
+
+        DBG << "Scanned " << pids.size() << " pids using " << std::max( nthreads, 1U ) << " threads" << endl;
+        result.erase( std::remove_if( result.begin(), result.end(), []( const PidLines & l ) { return l.empty(); } ), result.end() );
+        return result;
+      }
+
+    private:
+      static constexpr const char * deletedSuffix = " (deleted)";
+      static constexpr size_t deletedSuffixLen = 10;
+
+      static bool stripDeleted( std::string & path_r )
+      {
+        if ( ! str::hasSuffix( path_r, deletedSuffix ) )
+          return false;
+        path_r.erase( path_r.size() - deletedSuffixLen );
+        return true;
+      }
+
+      /** Whether a path tagged ' (deleted)' still names the file \a dev_r/\a ino_r.
+       * Which is the case if a file's name actually ends in ' (deleted)'.
+       */
+      static bool stillExists( const std::string & path_r, dev_t dev_r, ino_t ino_r )
+      {
+        struct stat st;
+        return( ::stat( path_r.c_str(), &st ) == 0 && st.st_ino == ino_r && st.st_dev == dev_r );
+      }
+
+      static std::string fileLine( const char * fd_r, const char * type_r, const std::string & path_r )
+      {
+        std::string ret;
+        ret.reserve( path_r.size() + 16 );
+        ret += 'f'; ret += fd_r; ret += '\0';
+        ret += 't'; ret += type_r; ret += '\0';
+        ret += "k0"; ret += '\0';
+        ret += 'n'; ret += path_r; ret += '\0';
+        ret += '\n';
+        return ret;
+      }
+
+      static std::string procLine( pid_t pid_r, const std::string & status_r )
+      {
+        // /proc/<pid>/status: "Name:\t<cmd>\n...PPid:\t<ppid>\n...Uid:\t<ruid>\t<euid>..."
+        auto field = [&status_r]( const char * tag_r ) -> std::string {
+          std::string::size_type pos = status_r.find( tag_r );
+          if ( pos == std::string::npos )
+            return std::string();
+          pos += ::strlen( tag_r );
+          std::string::size_type eol = status_r.find_first_of( "\t\n", pos );
+          return status_r.substr( pos, eol == std::string::npos ? eol : eol - pos );
+        };
+        std::string ret;
+        ret += 'p'; ret += str::numstring( pid_r ); ret += '\0';
+        ret += 'R'; ret += field( "\nPPid:\t" ); ret += '\0';
+        ret += 'c'; ret += field( "Name:\t" ); ret += '\0';
+        ret += 'u'; ret += field( "\nUid:\t" ); ret += '\0';
+        ret += '\n';
+        return ret;
+      }
+
+      static bool readFile( const std::string & path_r, std::string & content_r )
+      {
+        std::ifstream in( path_r );
+        if ( ! in )
+          return false;
+        content_r.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+        return true;
+      }
+
+      static void scanPid( pid_t pid_r, PidLines & lines_r )
+      {
+        const std::string pidDir( "/proc/" + str::numstring( pid_r ) );
+        // deleted files already seen (by device/inode)
+        std::set<std::pair<dev_t,ino_t>> seen;
+
+        char buf[PATH_MAX+1];
+        ssize_t len = ::readlink( (pidDir+"/exe").c_str(), buf, PATH_MAX );
+        if ( len > 0 )
+        {
+          std::string exe( buf, len );
+          if ( stripDeleted( exe ) )
+            lines_r.push_back( fileLine( "txt", "REG", exe ) );
+        }
+
+        // address perms offset dev inode pathname
+        std::ifstream maps( pidDir+"/maps" );
+        for ( std::string line; std::getline( maps, line ); )
+        {
+          if ( ! str::hasSuffix( line, deletedSuffix ) )
+            continue;
+
+          const char * ch = line.c_str();
+          for ( unsigned i = 0; i < 3; ++i )	// skip to dev
+          {
+            while ( *ch && *ch != ' ' ) ++ch;
+            while ( *ch == ' ' ) ++ch;
+          }
+          char * end = nullptr;
+          unsigned long maj = ::strtoul( ch, &end, 16 );
+          if ( *end != ':' )
+            continue;
+          unsigned long min = ::strtoul( end+1, &end, 16 );
+          ino_t ino = ::strtoull( end, &end, 10 );
+          while ( *end == ' ' ) ++end;
+          if ( *end != '/' || ino == 0 )
+            continue;	// [heap], [stack], anon mappings, ...
+
+          dev_t dev = makedev( maj, min );
+          if ( ! seen.insert( std::make_pair( dev, ino ) ).second )
+            continue;
+
+          std::string path( end );
+          stripDeleted( path );
+          if ( stillExists( path, dev, ino ) )
+            continue;
+          lines_r.push_back( fileLine( "DEL", "DEL", path ) );
+        }
+
+        if ( lines_r.empty() )
+          return;
+
+        std::string status;
+        if ( ! readFile( pidDir+"/status", status ) )
+        {
+          lines_r.clear();	// process is gone
+          return;
+        }
+        lines_r.insert( lines_r.begin(), procLine( pid_r, status ) );
+      }
+    };
+
+    /** Login name for \a uid_r (cached). */
+    const std::string & loginName( const std::string & uid_r )
     {
-      using target::rpm::librpmDb;
-      // RpmDb access is blocked while the Target is not initialized.
-      // Launching the Target just for this query would be an overkill.
-      struct TmpUnblock {
-	TmpUnblock()
-	: _wasBlocked( librpmDb::isBlocked() )
-	{ if ( _wasBlocked ) librpmDb::unblockAccess(); }
-	~TmpUnblock()
-	{ if ( _wasBlocked ) librpmDb::blockAccess(); }
-      private:
-	bool _wasBlocked;
-      } tmpUnblock;
-
-      librpmDb::db_const_iterator it;
-      return( it.findPackage( "lsof" ) && it->tag_edition() < Edition("4.90") && !it->tag_provides().count( Capability("backported-option-Ki") ) );
+      static std::map<std::string,std::string> _cache;
+      auto it = _cache.find( uid_r );
+      if ( it == _cache.end() )
+      {
+        std::string & login( _cache[uid_r] );
+        struct passwd pwd;
+        struct passwd * result = nullptr;
+        std::vector<char> buf( 4096 );
+        if ( ::getpwuid_r( str::strtonum<uid_t>( uid_r ), &pwd, buf.data(), buf.size(), &result ) == 0 && result )
+          login = pwd.pw_name;
+        else
+          login = uid_r;
+        return login;
+      }
+      return it->second;
     }
 
   } //namespace
@@ -199,6 +381,7 @@ namespace zypp
     void addCacheIf( CacheEntry & cache_r, const std::string & line_r, std::vector<std::string> *debMap = nullptr );
 
     std::map<pid_t,CacheEntry> filterInput( externalprogram::ExternalDataSource &source );
+    std::map<pid_t,CacheEntry> filterInput( const function<std::string()> & nextLine_r, bool checkContainer_r );
     CheckAccessDeleted::size_type createProcInfo( const std::map<pid_t,CacheEntry> &in );
 
     std::vector<CheckAccessDeleted::ProcInfo> _data;
@@ -387,6 +570,11 @@ namespace zypp
   }
 
   std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::filterInput( externalprogram::ExternalDataSource &source )
+  {
+    return filterInput( [&source]() { return source.receiveLine( 30 * 1000 ); }, !_fromLsofFileMode );
+  }
+
+  std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::filterInput( const function<std::string()> & nextLine_r, bool checkContainer_r )
   {
     // cachemap: PID => (deleted files)
     // NOTE: omit PIDs running in a (lxc/docker) container
@@ -396,13 +584,13 @@ namespace zypp
 
     pid_t cachepid = 0;
     FilterRunsInContainer runsInLXC;
-    for( std::string line = source.receiveLine( 30 * 1000 ); ! line.empty(); line = source.receiveLine(  30 * 1000  ) )
+    for( std::string line = nextLine_r(); ! line.empty(); line = nextLine_r() )
     {
       // NOTE: line contains '\0' separeated fields!
       if ( line[0] == 'p' )
       {
         str::strtonum( line.c_str()+1, cachepid );	// line is "p<PID>\0...."
-        if ( _fromLsofFileMode || !runsInLXC( cachepid ) ) {
+        if ( !checkContainer_r || !runsInLXC( cachepid ) ) {
           if ( debugEnabled ) {
             auto &pidMad = debugMap[cachepid];
             if ( pidMad.empty() )
@@ -426,37 +614,39 @@ namespace zypp
 
   CheckAccessDeleted::size_type CheckAccessDeleted::check( bool verbose_r  )
   {
-    static const char* argv[] = { "lsof", "-n", "-FpcuLRftkn0", "-K", "i", NULL };
-    if ( lsofNoOptKi() )
-      argv[3] = NULL;
-
     _pimpl->_verbose = verbose_r;
     _pimpl->_fromLsofFileMode = false;
 
-    ExternalProgram prog( argv, ExternalProgram::Discard_Stderr );
-    std::map<pid_t,CacheEntry> cachemap;
+    ProcScanner scanner;
+    std::vector<ProcScanner::PidLines> scanned( scanner() );
 
-    try {
-      cachemap = _pimpl->filterInput( prog );
-    } catch ( const io::TimeoutException &e ) {
-      ZYPP_CAUGHT( e );
-      prog.close();
-      ZYPP_THROW ( Exception( "Reading data from 'lsof' timed out.") );
-    }
-
-    int ret = prog.close();
-    if ( ret != 0 )
+    // complete the 'p' lines with the login name
+    for ( auto & pidlines : scanned )
     {
-      if ( ret == 129 )
+      std::string & pline( pidlines.front() );
+      std::string::size_type pos = pline.find( std::string( "\0u", 2 ) );
+      if ( pos != std::string::npos )
       {
-        ZYPP_THROW( Exception(_("Please install package 'lsof' first.") ) );
+        pos += 2;
+        const std::string & login( loginName( pline.substr( pos, pline.find( '\0', pos ) - pos ) ) );
+        pline.insert( pline.size()-1, ( "L" + login ).append( 1, '\0' ) );
       }
-      Exception err( str::Format("Executing 'lsof' failed (%1%).") % ret );
-      err.remember( prog.execError() );
-      ZYPP_THROW( err );
     }
 
-    return _pimpl->createProcInfo( cachemap );
+    auto pidIt = scanned.begin();
+    auto lineIt = pidIt != scanned.end() ? pidIt->begin() : std::vector<std::string>::iterator();
+    auto nextLine = [&]() -> std::string {
+      while ( pidIt != scanned.end() )
+      {
+        if ( lineIt != pidIt->end() )
+          return std::move( *(lineIt++) );
+        if ( ++pidIt != scanned.end() )
+          lineIt = pidIt->begin();
+      }
+      return std::string();
+    };
+
+    return _pimpl->createProcInfo( _pimpl->filterInput( nextLine, true ) );
   }
 
   CheckAccessDeleted::size_type CheckAccessDeleted::Impl::createProcInfo(const std::map<pid_t,CacheEntry> &in)
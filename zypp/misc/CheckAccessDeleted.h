@@ -84,8 +84,12 @@ namespace zypp
        * A verbose check will omit this test and collect all processes using
        * any deleted file.
        *
+       * The data are collected from \c /proc/<pid>/exe and \c /proc/<pid>/maps,
+       * scanning the processes in parallel. No external tool like \c lsof
+       * is needed.
+       *
        * \return the number of processes found.
-       * \throws Exception On error collecting the data (e.g. no lsof installed)
+       * \throws Exception On error collecting the data (e.g. /proc not available)
        */
       size_type check( bool verbose_r = false );
 
@@ -93,6 +97,8 @@ namespace zypp
        * \overload
        * Performs the same checks but instead of investigating the current system it
        * uses information from \a lsofOutput_r to support debugging.
+       * The file is expected in lsof's \c -FpcuLRftkn0 format, which is also
+       * the format written by \ref setDebugOutputFile.
        *
        * \sa setDebugOutputFile
        */
@@ -12,7 +12,9 @@
 #include "LoadTestcase.h"
 #include "HelixHelpers.h"
 #include "YamlTestcaseHelpers.h"
+#include "TestcaseArchive.h"
 #include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
 #include <zypp/base/LogControl.h>
 
 namespace zypp::misc::testcase {
@@ -23,6 +25,7 @@ namespace zypp::misc::testcase {
   struct LoadTestcase::Impl {
     TestcaseSetup _setup;
     std::vector<TestcaseTrial> _trials;
+    filesystem::TmpPath _archiveDir;	///< Where an archive was extracted to.
 
     bool loadHelix (const Pathname &filename, std::string *err);
 
@@ -215,6 +218,20 @@ namespace zypp::misc::testcase {
         return _pimpl->loadHelix( path / helixControlFile, err );
       case LoadTestcase::Yaml:
         return _pimpl->loadYaml( path / yamlControlFile, err );
+      case LoadTestcase::Archive:
+      {
+        const Pathname archive { PathInfo( path ).isFile() ? path : path / TestcaseArchive::fileName };
+        _pimpl->_archiveDir = filesystem::TmpDir();
+        try {
+          TestcaseArchive::extract( archive, _pimpl->_archiveDir.path() );
+        } catch ( const Exception & excpt ) {
+          ZYPP_CAUGHT( excpt );
+          if ( err ) *err = excpt.asUserString();
+          return false;
+        }
+        _pimpl->_setup.data().globalPath = _pimpl->_archiveDir.path();
+        return _pimpl->loadYaml( _pimpl->_archiveDir.path() / yamlControlFile, err );
+      }
       default:
         return false;
     }
@@ -226,6 +243,8 @@ namespace zypp::misc::testcase {
       return LoadTestcase::Helix;
     } else if ( filesystem::PathInfo( path / yamlControlFile ).isFile() ) {
       return LoadTestcase::Yaml;
+    } else if ( TestcaseArchive::isArchive( path / TestcaseArchive::fileName ) || TestcaseArchive::isArchive( path ) ) {
+      return LoadTestcase::Archive;
     }
     return LoadTestcase::None;
   }
@@ -63,7 +63,8 @@ namespace zypp::misc::testcase {
     enum Type {
       None,
       Helix,
-      Yaml
+      Yaml,
+      Archive	///< A \ref TestcaseArchive (extracted to a temporary directory when loaded)
     };
 
     LoadTestcase();
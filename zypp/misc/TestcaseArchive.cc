@@ -0,0 +1,191 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file  zypp/misc/TestcaseArchive.cc
+ *
+*/
+extern "C"
+{
+#include <solv/repo_write.h>
+#include <solv/solv_xfopen.h>
+#include <solv/util.h>
+}
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/PathInfo.h>
+
+#include <zypp/misc/TestcaseArchive.h>
+
+using std::endl;
+
+namespace zypp::misc::testcase {
+
+  namespace
+  {
+    const std::string archiveHeader { "ZYPPTESTCASE 1\n" };
+
+    /** The compression used for new archives (as file name hint for solv_xfopen_fd). */
+    inline const char * compressionHint()
+    { return ::solv_xfopen_iscompressed( "x.zst" ) == 1 ? "x.zst" : "x.gz"; }
+
+    /** The compression of an existing archive (as file name hint for solv_xfopen_fd). */
+    inline const char * compressionHint( int fd_r )
+    {
+      unsigned char magic[4] = { 0, 0, 0, 0 };
+      ssize_t got = ::pread( fd_r, magic, sizeof(magic), 0 );
+      if ( got >= 2 && magic[0] == 0x1f && magic[1] == 0x8b )
+        return "x.gz";
+      if ( got == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd )
+        return "x.zst";
+      return nullptr;
+    }
+
+    /** Read a line without the trailing newline. */
+    bool readLine( FILE * in_r, std::string & line_r )
+    {
+      char * buf = nullptr;
+      size_t cap = 0;
+      ssize_t len = ::getline( &buf, &cap, in_r );
+      AutoDispose<char *> guard( buf, ::free );
+      if ( len <= 0 || buf[len-1] != '\n' )
+        return false;
+      line_r.assign( buf, len-1 );
+      return true;
+    }
+
+    /** Open the archive for reading and check the header. */
+    AutoDispose<FILE *> openArchive( const Pathname & file_r )
+    {
+      int fd = ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC );
+      if ( fd == -1 )
+        return AutoDispose<FILE *>();
+      const char * hint = compressionHint( fd );
+      FILE * in = hint ? ::solv_xfopen_fd( hint, fd, "r" ) : nullptr;
+      if ( ! in )
+      {
+        ::close( fd );
+        return AutoDispose<FILE *>();
+      }
+      AutoDispose<FILE *> ret( in, ::fclose );
+      std::string header;
+      if ( ! readLine( ret, header ) || header+"\n" != archiveHeader )
+        return AutoDispose<FILE *>();
+      return ret;
+    }
+  } // namespace
+
+  const std::string TestcaseArchive::fileName { "zypp-testcase.ztc" };
+
+  TestcaseArchive::TestcaseArchive( const Pathname & file_r )
+  : _file( file_r )
+  , _out( nullptr )
+  {
+    int fd = ::open( file_r.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0644 );
+    if ( fd == -1 )
+      ZYPP_THROW( Exception( "Can't create testcase archive " + file_r.asString() ) );
+    _out = ::solv_xfopen_fd( compressionHint(), fd, "w" );
+    if ( ! _out )
+    {
+      ::close( fd );
+      ZYPP_THROW( Exception( "Can't create testcase archive " + file_r.asString() ) );
+    }
+    ::fwrite( archiveHeader.data(), archiveHeader.size(), 1, _out );
+  }
+
+  TestcaseArchive::~TestcaseArchive()
+  {
+    if ( _out )
+    {
+      ::fclose( _out );
+      filesystem::unlink( _file );
+    }
+  }
+
+  void TestcaseArchive::add( const std::string & name_r, const std::string & data_r )
+  {
+    std::string head { name_r + "\n" + str::numstring( data_r.size() ) + "\n" };
+    ::fwrite( head.data(), head.size(), 1, _out );
+    if ( ! data_r.empty() )
+      ::fwrite( data_r.data(), data_r.size(), 1, _out );
+  }
+
+  void TestcaseArchive::addRepo( const std::string & name_r, const Repository & repo_r )
+  {
+    char * buf = nullptr;
+    size_t len = 0;
+    FILE * mem = ::solv_xfopen_buf( "", &buf, &len, "w" );
+    if ( ! mem )
+      ZYPP_THROW( Exception( "Can't write solv-file for " + repo_r.alias() ) );
+    int res = ::repo_write( repo_r.get(), mem );
+    ::fclose( mem );
+    AutoDispose<char *> guard( buf, ::solv_free );
+    if ( res != 0 )
+      ZYPP_THROW( Exception( "Can't write solv-file for " + repo_r.alias() ) );
+    add( name_r, std::string( buf, len ) );
+  }
+
+  void TestcaseArchive::close()
+  {
+    FILE * out = _out;
+    _out = nullptr;
+    if ( ::ferror( out ) | ::fclose( out ) )
+    {
+      filesystem::unlink( _file );
+      ZYPP_THROW( Exception( "Error writing testcase archive " + _file.asString() ) );
+    }
+    MIL << "Testcase archive " << _file << " (" << PathInfo( _file ).size() << " bytes)" << endl;
+  }
+
+  bool TestcaseArchive::isArchive( const Pathname & file_r )
+  { return PathInfo( file_r ).isFile() && openArchive( file_r ); }
+
+  std::vector<std::string> TestcaseArchive::extract( const Pathname & file_r, const Pathname & dir_r )
+  {
+    AutoDispose<FILE *> in { openArchive( file_r ) };
+    if ( ! in )
+      ZYPP_THROW( Exception( "Not a testcase archive: " + file_r.asString() ) );
+
+    std::vector<std::string> ret;
+    std::string name;
+    std::string size;
+    while ( readLine( in, name ) )
+    {
+      if ( name.empty() || name.find( '/' ) != std::string::npos || name == ".." || ! readLine( in, size ) )
+        ZYPP_THROW( Exception( "Corrupted testcase archive: " + file_r.asString() ) );
+
+      if ( size.empty() || size.find_first_not_of( "0123456789" ) != std::string::npos )
+        ZYPP_THROW( Exception( "Corrupted testcase archive: " + file_r.asString() ) );
+
+      // The size is not trusted: copy in chunks, so a size exceeding the
+      // remaining data fails instead of allocating it up front.
+      std::ofstream out( ( dir_r / name ).c_str(), std::ios::binary );
+      char buf[65536];
+      for ( size_t todo = str::strtonum<size_t>( size ); todo; )
+      {
+        size_t chunk = std::min( todo, sizeof(buf) );
+        if ( ::fread( buf, chunk, 1, in ) != 1 )
+          ZYPP_THROW( Exception( "Corrupted testcase archive: " + file_r.asString() ) );
+        out.write( buf, chunk );
+        todo -= chunk;
+      }
+      if ( ! out )
+        ZYPP_THROW( Exception( "Can't extract " + name + " from " + file_r.asString() ) );
+      ret.push_back( std::move(name) );
+    }
+    MIL << "Extracted " << ret.size() << " members of " << file_r << " to " << dir_r << endl;
+    return ret;
+  }
+
+} // namespace zypp::misc::testcase
@@ -0,0 +1,75 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file  zypp/misc/TestcaseArchive.h
+ *
+*/
+#ifndef ZYPP_MISC_TESTCASEARCHIVE_H
+#define ZYPP_MISC_TESTCASEARCHIVE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/Pathname.h>
+#include <zypp/Repository.h>
+
+namespace zypp::misc::testcase {
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class TestcaseArchive
+  /// \brief A solver testcase in a single compressed file.
+  ///
+  /// Instead of text dumps of the repos, the archive stores each repo
+  /// as solv file next to the (inline) \c zypp-control.yaml. The file
+  /// is a zstd (or gzip, if libsolv lacks zstd support) compressed
+  /// stream of members, each stored as \c "NAME\nSIZE\n" followed by
+  /// SIZE bytes of data, after a \c "ZYPPTESTCASE 1\n" header.
+  ///////////////////////////////////////////////////////////////////
+  class TestcaseArchive : private base::NonCopyable
+  {
+  public:
+    /** The archives file name within a testcase directory. */
+    static const std::string fileName;
+
+    /** Create a new archive \a file_r.
+     * \throws Exception if the file can't be created.
+     */
+    explicit TestcaseArchive( const Pathname & file_r );
+
+    /** Dtor discards an archive not \ref close d. */
+    ~TestcaseArchive();
+
+    /** Add a member. */
+    void add( const std::string & name_r, const std::string & data_r );
+
+    /** Add a member containing \a repo_r as solv file. */
+    void addRepo( const std::string & name_r, const Repository & repo_r );
+
+    /** Finish writing the archive.
+     * \throws Exception on write errors.
+     */
+    void close();
+
+  public:
+    /** Whether \a file_r is a testcase archive. */
+    static bool isArchive( const Pathname & file_r );
+
+    /** Extract all members of the archive \a file_r into directory \a dir_r.
+     * \throws Exception if the archive is not readable.
+     */
+    static std::vector<std::string> extract( const Pathname & file_r, const Pathname & dir_r );
+
+  private:
+    Pathname _file;
+    FILE * _out;
+  };
+
+} // namespace zypp::misc::testcase
+#endif // ZYPP_MISC_TESTCASEARCHIVE_H
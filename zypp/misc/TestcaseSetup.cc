@@ -234,6 +234,8 @@ namespace zypp::misc::testcase
         satRepo.setInfo (nrepo);
         if ( repoData.type == TrType::Helix )
           satRepo.addHelix( pathname );
+        else if ( repoData.type == TrType::Solv )
+          satRepo.addSolv( pathname );
         else
           satRepo.addTesttags( pathname );
         MIL << "Loaded " << satRepo.solvablesSize() << " resolvables from " << ( repoData.path.empty()?pathname.asString():repoData.path) << "." << std::endl;
@@ -36,7 +36,8 @@ namespace zypp::misc::testcase
   enum class TestcaseRepoType {
     Helix,
     Testtags,
-    Url
+    Url,
+    Solv	///< A solv file as written by \ref TestcaseArchive
   };
 
   struct RepoDataImpl;
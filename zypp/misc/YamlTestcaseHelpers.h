@@ -125,8 +125,13 @@ namespace yamltest::detail {
           if ( dataNode["priority"] )
             prio = dataNode["priority"].as<unsigned>();
 
+          // 'format: solv' is written by TestcaseArchive
+          zypp::misc::testcase::TestcaseRepoType repoType = zypp::misc::testcase::TestcaseRepoType::Testtags;
+          if ( dataNode["format"] && dataNode["format"].as<std::string>() == "solv" )
+            repoType = zypp::misc::testcase::TestcaseRepoType::Solv;
+
           target.repos.push_back( zypp::misc::testcase::RepoDataImpl{
-            zypp::misc::testcase::TestcaseRepoType::Testtags,
+            repoType,
             name,
             prio,
             file
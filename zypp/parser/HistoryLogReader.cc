@@ -11,10 +11,17 @@
  *
  */
 #include <iostream>
+#include <iterator>
+#include <thread>
+#include <cstring>
+#include <sys/mman.h>
 
 #include <zypp/base/InputStream.h>
 #include <zypp/base/IOStream.h>
 #include <zypp/base/Logger.h>
+#include <zypp/base/NonCopyable.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/PathInfo.h>
 #include <zypp/parser/ParseException.h>
 
 #include <zypp/parser/HistoryLogReader.h>
@@ -27,6 +34,150 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace parser
   {
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** Files larger than this are split into chunks parsed in parallel. */
+      constexpr size_t parallelChunkSize = 4 * 1024 * 1024;
+
+      ///////////////////////////////////////////////////////////////////
+      /// \class LogData
+      /// \brief The history files content.
+      ///
+      /// Plain files are memory mapped, compressed (rotated) files are
+      /// read into memory. Provides the primitives to navigate the lines
+      /// by byte offset, so we are able to seek a date via binary search,
+      /// and to iterate in both directions.
+      ///////////////////////////////////////////////////////////////////
+      class LogData : private base::NonCopyable
+      {
+      public:
+        LogData( const Pathname & file_r )
+        {
+          PathInfo pi( file_r );
+          if ( pi.isFile() && pi.size() > 2 )
+          {
+            AutoFD fd( ::open( file_r.c_str(), O_RDONLY | O_CLOEXEC ) );
+            unsigned char magic[2] = { 0, 0 };
+            if ( fd != -1 && ::pread( fd, magic, 2, 0 ) == 2 && ! ( magic[0] == 0x1f && magic[1] == 0x8b ) )
+            {
+              void * addr = ::mmap( nullptr, pi.size(), PROT_READ, MAP_PRIVATE, fd, 0 );
+              if ( addr != MAP_FAILED )
+              {
+                ::madvise( addr, pi.size(), MADV_RANDOM );
+                _data = static_cast<const char *>( addr );
+                _size = pi.size();
+                _map = AutoDispose<void*>( addr, [size=_size]( void * addr_r ) { ::munmap( addr_r, size ); } );
+                return;
+              }
+              WAR << "Failed to mmap " << file_r << " (" << Errno() << "). Reading it into memory." << endl;
+            }
+          }
+          // gzipped or not mappable
+          InputStream is( file_r );
+          _buffer.assign( std::istreambuf_iterator<char>( is.stream() ), std::istreambuf_iterator<char>() );
+          _data = _buffer.data();
+          _size = _buffer.size();
+        }
+
+        size_t size() const
+        { return _size; }
+
+        /** Offset of the end of the line starting at \a off_r (the '\n' or \ref size). */
+        size_t lineEnd( size_t off_r ) const
+        {
+          const void * nl = ( off_r < _size ? ::memchr( _data+off_r, '\n', _size-off_r ) : nullptr );
+          return nl ? static_cast<const char *>(nl) - _data : _size;
+        }
+
+        char at( size_t off_r ) const
+        { return _data[off_r]; }
+
+        /** Offset of the start of the line containing \a off_r. */
+        size_t lineBegin( size_t off_r ) const
+        {
+          const void * nl = ( off_r ? ::memrchr( _data, '\n', off_r ) : nullptr );
+          return nl ? static_cast<const char *>(nl) - _data + 1 : 0;
+        }
+
+        /** Offset of the first line starting at or behind \a off_r. */
+        size_t lineStartFrom( size_t off_r ) const
+        { return( off_r == 0 || off_r >= _size ? std::min( off_r, _size ) : lineEnd( off_r-1 ) + 1 ); }
+
+        /** Offset of the first data line (no comment, not empty) starting at or behind \a off_r. */
+        size_t dataLineStartFrom( size_t off_r ) const
+        {
+          for ( off_r = lineStartFrom( off_r ); off_r < _size && isSkipped( off_r ); off_r = lineEnd( off_r ) + 1 )
+          {;}
+          return std::min( off_r, _size );
+        }
+
+        /** Whether the line starting at \a off_r is a comment (or empty). */
+        bool isSkipped( size_t off_r ) const
+        { return _data[off_r] == '#' || _data[off_r] == '\n'; }
+
+        /** The line [\a begin_r, \a end_r) */
+        std::string line( size_t begin_r, size_t end_r ) const
+        { return std::string( _data+begin_r, end_r-begin_r ); }
+
+        /** The date of the data line starting at \a off_r (\c Date(0) if unparsable). */
+        Date lineDate( size_t off_r ) const
+        {
+          const void * sep = ::memchr( _data+off_r, '|', lineEnd( off_r ) - off_r );
+          if ( sep )
+          {
+            try { return Date( line( off_r, static_cast<const char *>(sep) - _data ), HISTORY_LOG_DATE_FORMAT ); }
+            catch ( const DateFormatException & ) {}
+          }
+          return Date( 0 );
+        }
+
+        /** Offset of the first data line whose date satisfies \a pred_r (or \ref size).
+         * Binary search assuming the dates in the log are ascending,
+         * i.e. \a pred_r is \c false for a (maybe empty) prefix of the lines only.
+         */
+        template <class TPred>
+        size_t findFirst( TPred pred_r ) const
+        {
+          size_t lo = 0;
+          size_t hi = _size;
+          // NOTE: invariant: the wanted line is dataLineStartFrom( X ) for some X in [lo,hi]
+          while ( lo < hi )
+          {
+            size_t mid = lo + ( hi - lo ) / 2;
+            size_t ls = dataLineStartFrom( mid );
+            if ( ls == _size || pred_r( lineDate( ls ) ) )
+              hi = mid;
+            else
+              lo = ls + 1;
+          }
+          return dataLineStartFrom( lo );
+        }
+
+      private:
+        const char * _data = nullptr;
+        size_t _size = 0;
+        AutoDispose<void*> _map;
+        std::string _buffer;
+      };
+
+      /** Position of a line for log messages.
+       * Line numbers are only known when reading from the start of the file.
+       */
+      struct LinePos
+      {
+        unsigned _lineNo;
+        size_t   _offset;
+      };
+
+      std::ostream & operator<<( std::ostream & str, const LinePos & obj )
+      {
+        if ( obj._lineNo )
+          return str << "line #" << obj._lineNo;
+        return str << "line at offset " << obj._offset;
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
 
   /////////////////////////////////////////////////////////////////////
   //
@@ -41,12 +192,20 @@ namespace zypp
     , _callback( callback_r )
     {}
 
-    bool parseLine( const std::string & line_r, unsigned int lineNr_r );
+    /** Split a line into fields; \c false if filtered by action. */
+    bool splitLine( const std::string & line_r, HistoryLogData::FieldVector & fields_r ) const;
+
+    bool parseLine( const std::string & line_r, const LinePos & pos_r );
+    bool parseFields( HistoryLogData::FieldVector & fields_r, const std::string & line_r, const LinePos & pos_r );
 
     void readAll( const ProgressData::ReceiverFnc & progress_r );
     void readFrom( const Date & date_r, const ProgressData::ReceiverFnc & progress_r );
     void readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r );
 
+    /** Read the lines in [\a begin_r, \a end_r) in the order requested by \ref Options. */
+    void readRange( const LogData & log_r, size_t begin_r, size_t end_r, const ProgressData::ReceiverFnc & progress_r );
+    void readRangeParallel( const LogData & log_r, size_t begin_r, size_t end_r, ProgressData & pd_r );
+
     void addActionFilter( const HistoryActionID & action_r )
     {
       if ( action_r == HistoryActionID::NONE )
@@ -61,20 +220,31 @@ namespace zypp
     std::set<std::string> _actionfilter;
   };
 
-  bool HistoryLogReader::Impl::parseLine( const std::string & line_r, unsigned lineNr_r )
+  bool HistoryLogReader::Impl::splitLine( const std::string & line_r, HistoryLogData::FieldVector & fields_r ) const
   {
     // parse into fields
+    str::splitEscaped( line_r, std::back_inserter(fields_r), "|", true );
+    if ( fields_r.size() < 2 )
+      return true;	// invalid, but reported by parseFields
+
+    fields_r[1] = str::trim( std::move(fields_r[1]) );	// for whatever reason writer is padding the action field
+    return( _actionfilter.empty() || _actionfilter.count( fields_r[1] ) );
+  }
+
+  bool HistoryLogReader::Impl::parseLine( const std::string & line_r, const LinePos & pos_r )
+  {
     HistoryLogData::FieldVector fields;
-    str::splitEscaped( line_r, std::back_inserter(fields), "|", true );
+    if ( ! splitLine( line_r, fields ) )
+      return true;
+    return parseFields( fields, line_r, pos_r );
+  }
 
+  bool HistoryLogReader::Impl::parseFields( HistoryLogData::FieldVector & fields, const std::string & line_r, const LinePos & pos_r )
+  {
     if ( fields.size() < 2 ) {
-      WAR << "Ignore invalid history log entry on line #" << lineNr_r << " '"<< line_r << "'" << endl;
+      WAR << "Ignore invalid history log entry on " << pos_r << " '"<< line_r << "'" << endl;
       return true;	// At least an action field[1] is needed!
     }
-    fields[1] = str::trim( std::move(fields[1]) );	// for whatever reason writer is padding the action field
-
-    if ( !_actionfilter.empty() && !_actionfilter.count( fields[1] ) )
-      return true;
 
     // move into data class
     HistoryLogData::Ptr data;
@@ -87,13 +257,13 @@ namespace zypp
       ZYPP_CAUGHT( excpt );
       if ( _options.testFlag( IGNORE_INVALID_ITEMS ) )
       {
-	WAR << "Ignore invalid history log entry on line #" << lineNr_r << " '"<< line_r << "'" << endl;
+	WAR << "Ignore invalid history log entry on " << pos_r << " '"<< line_r << "'" << endl;
 	return true;
       }
       else
       {
-	ERR << "Invalid history log entry on line #" << lineNr_r << " '"<< line_r << "'" << endl;
-	ParseException newexcpt( str::Str() << "Error in history log on line #" << lineNr_r );
+	ERR << "Invalid history log entry on " << pos_r << " '"<< line_r << "'" << endl;
+	ParseException newexcpt( str::Str() << "Error in history log on " << pos_r );
 	newexcpt.remember( excpt );
 	ZYPP_THROW( newexcpt );
       }
@@ -102,7 +272,7 @@ namespace zypp
     // consume data
     if ( _callback && !_callback( data ) )
     {
-      WAR << "Stop parsing requested by consumer callback on line #" << lineNr_r << endl;
+      WAR << "Stop parsing requested by consumer callback on " << pos_r << endl;
       return false;
     }
     return true;
@@ -110,100 +280,130 @@ namespace zypp
 
   void HistoryLogReader::Impl::readAll( const ProgressData::ReceiverFnc & progress_r )
   {
-    InputStream is( _filename );
-    iostr::EachLine line( is );
-
-    ProgressData pd;
-    pd.sendTo( progress_r );
-    pd.toMin();
-
-    for ( ; line; line.next(), pd.tick() )
-    {
-      // ignore comments
-      if ( (*line)[0] == '#' )
-        continue;
-
-      if ( ! parseLine( *line, line.lineNo() ) )
-	break;	// requested by consumer callback
-    }
-
-    pd.toMax();
+    LogData log( _filename );
+    readRange( log, 0, log.size(), progress_r );
   }
 
   void HistoryLogReader::Impl::readFrom( const Date & date_r, const ProgressData::ReceiverFnc & progress_r )
   {
-    InputStream is( _filename );
-    iostr::EachLine line( is );
+    LogData log( _filename );
+    size_t begin = log.findFirst( [&date_r]( const Date & logDate_r ) { return logDate_r > date_r; } );
+    readRange( log, begin, log.size(), progress_r );
+  }
 
+  void HistoryLogReader::Impl::readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r )
+  {
+    LogData log( _filename );
+    size_t begin = log.findFirst( [&fromDate_r]( const Date & logDate_r ) { return logDate_r > fromDate_r; } );
+    size_t end   = log.findFirst( [&toDate_r]( const Date & logDate_r ) { return logDate_r >= toDate_r; } );
+    readRange( log, begin, std::max( begin, end ), progress_r );
+  }
+
+  void HistoryLogReader::Impl::readRange( const LogData & log_r, size_t begin_r, size_t end_r, const ProgressData::ReceiverFnc & progress_r )
+  {
     ProgressData pd;
     pd.sendTo( progress_r );
     pd.toMin();
 
-    bool pastDate = false;
-    for ( ; line; line.next(), pd.tick() )
+    if ( _options.testFlag( REVERSE_ORDER ) )
     {
-      const std::string & s = *line;
-
-      // ignore comments
-      if ( s[0] == '#' )
-        continue;
-
-      if ( pastDate )
+      // end_r is a line start (or EOF)
+      for ( size_t end = end_r; end > begin_r; pd.tick() )
       {
-	if ( ! parseLine( s, line.lineNo() ) )
+	size_t lineEnd = ( log_r.at( end-1 ) == '\n' ? end-1 : end );
+	size_t lineBegin = std::max( begin_r, log_r.lineBegin( lineEnd ) );
+	end = lineBegin;
+
+	if ( lineBegin == lineEnd || log_r.isSkipped( lineBegin ) )
+	  continue;	// ignore comments
+	if ( ! parseLine( log_r.line( lineBegin, lineEnd ), LinePos{ 0, lineBegin } ) )
 	  break;	// requested by consumer callback
       }
-      else
+    }
+    else if ( end_r - begin_r > 2 * parallelChunkSize )
+    {
+      readRangeParallel( log_r, begin_r, end_r, pd );
+    }
+    else
+    {
+      unsigned lineNo = ( begin_r == 0 ? 1 : 0 );
+      for ( size_t lineBegin = begin_r; lineBegin < end_r; pd.tick() )
       {
-        Date logDate( s.substr( 0, s.find('|') ), HISTORY_LOG_DATE_FORMAT );
-        if ( logDate > date_r )
-        {
-          pastDate = true;
-          if ( ! parseLine( s, line.lineNo() ) )
+	size_t lineEnd = log_r.lineEnd( lineBegin );
+	size_t next = lineEnd + 1;
+	LinePos pos { lineNo, lineBegin };
+	if ( lineNo )
+	  ++lineNo;
+
+	if ( ! log_r.isSkipped( lineBegin ) )	// ignore comments
+	{
+	  if ( ! parseLine( log_r.line( lineBegin, lineEnd ), pos ) )
 	    break;	// requested by consumer callback
-        }
+	}
+	lineBegin = next;
       }
     }
 
     pd.toMax();
   }
 
-  void HistoryLogReader::Impl::readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r )
+  void HistoryLogReader::Impl::readRangeParallel( const LogData & log_r, size_t begin_r, size_t end_r, ProgressData & pd_r )
   {
-    InputStream is( _filename );
-    iostr::EachLine line( is );
-
-    ProgressData pd;
-    pd.sendTo( progress_r );
-    pd.toMin();
-
-    bool pastFromDate = false;
-    for ( ; line; line.next(), pd.tick() )
+    // Lines are split into fields by worker threads. Creating the
+    // HistoryLogData and invoking the callback happens here, in file order.
+    struct Entry
     {
-      const std::string & s = *line;
+      size_t _begin;
+      size_t _end;
+      HistoryLogData::FieldVector _fields;
+    };
+    typedef std::vector<Entry> Chunk;
 
-      // ignore comments
-      if ( s[0] == '#' )
-        continue;
+    unsigned nthreads = std::min( std::max( std::thread::hardware_concurrency(), 2U ), 8U );
+    DBG << "Parse " << (end_r-begin_r) << " bytes using " << nthreads << " threads" << endl;
 
-      Date logDate( s.substr( 0, s.find('|') ), HISTORY_LOG_DATE_FORMAT );
-
-      // past toDate - stop reading
-      if ( logDate >= toDate_r )
-        break;
-
-      // past fromDate - start reading
-      if ( !pastFromDate && logDate > fromDate_r )
-        pastFromDate = true;
+    for ( size_t wave = begin_r; wave < end_r; )
+    {
+      std::vector<std::pair<size_t,size_t>> ranges;
+      for ( unsigned i = 0; i < nthreads && wave < end_r; ++i )
+      {
+	size_t next = std::min( log_r.lineStartFrom( wave + parallelChunkSize ), end_r );
+	ranges.push_back( { wave, next } );
+	wave = next;
+      }
 
-      if ( pastFromDate )
+      std::vector<Chunk> chunks( ranges.size() );
+      auto worker = [&]( unsigned idx_r ) {
+	Chunk & chunk( chunks[idx_r] );
+	for ( size_t lineBegin = ranges[idx_r].first; lineBegin < ranges[idx_r].second; )
+	{
+	  size_t lineEnd = log_r.lineEnd( lineBegin );
+	  if ( ! log_r.isSkipped( lineBegin ) )	// ignore comments
+	  {
+	    Entry entry { lineBegin, lineEnd, HistoryLogData::FieldVector() };
+	    if ( splitLine( log_r.line( lineBegin, lineEnd ), entry._fields ) )
+	      chunk.push_back( std::move(entry) );
+	  }
+	  lineBegin = lineEnd + 1;
+	}
+      };
+      std::vector<std::thread> threads;
+      for ( unsigned i = 1; i < ranges.size(); ++i )
+	threads.emplace_back( worker, i );
+      worker( 0 );
+      for ( auto & t : threads )
+	t.join();
+
+      for ( Chunk & chunk : chunks )
       {
-	if ( ! parseLine( s, line.lineNo() ) )
-	  break;	// requested by consumer callback
+	for ( Entry & entry : chunk )
+	{
+	  pd_r.tick();
+	  if ( ! parseFields( entry._fields, log_r.line( entry._begin, entry._end ), LinePos{ 0, entry._begin } ) )
+	    return;	// requested by consumer callback
+	}
       }
     }
-
-    pd.toMax();
   }
 
   /////////////////////////////////////////////////////////////////////
@@ -225,6 +425,12 @@ namespace zypp
   bool HistoryLogReader::ignoreInvalidItems() const
   { return _pimpl->_options.testFlag( IGNORE_INVALID_ITEMS ); }
 
+  void HistoryLogReader::setReverseOrder( bool reverse_r )
+  { _pimpl->_options.setFlag( REVERSE_ORDER, reverse_r ); }
+
+  bool HistoryLogReader::reverseOrder() const
+  { return _pimpl->_options.testFlag( REVERSE_ORDER ); }
+
   void HistoryLogReader::readAll( const ProgressData::ReceiverFnc & progress_r )
   { _pimpl->readAll( progress_r ); }
 
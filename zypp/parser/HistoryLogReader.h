@@ -62,6 +62,14 @@ namespace zypp
   /// \endcode
   /// \see \ref HistoryLogData for how to access the individual data fields.
   ///
+  /// Plain (uncompressed) log files are memory mapped. As the log is
+  /// written in chronological order, \ref readFrom and \ref readFromTo
+  /// locate their starting point via binary search instead of parsing
+  /// the file from the beginning. Large ranges are split into fields by
+  /// parallel worker threads. The callback is always invoked on the
+  /// calling thread and in file order (or reverse file order if
+  /// \ref REVERSE_ORDER is set).
+  ///
   ///////////////////////////////////////////////////////////////////
   class HistoryLogReader
   {
@@ -69,7 +77,8 @@ namespace zypp
 
     enum OptionBits	///< Parser option flags
     {
-      IGNORE_INVALID_ITEMS	= (1 << 0)	///< ignore invalid items and continue parsing
+      IGNORE_INVALID_ITEMS	= (1 << 0),	///< ignore invalid items and continue parsing
+      REVERSE_ORDER		= (1 << 1)	///< process entries newest first
     };
     ZYPP_DECLARE_FLAGS( Options, OptionBits );
 
@@ -139,6 +148,20 @@ namespace zypp
      */
     bool ignoreInvalidItems() const;
 
+    /**
+     * Set the reader to process the log entries newest first.
+     *
+     * \param reverse <tt>true</tt> will cause the reader to process the log backwards
+     */
+    void setReverseOrder( bool reverse = false );
+
+    /**
+     * Whether the reader is set to process the log entries newest first.
+     *
+     * \see setReverseOrder()
+     */
+    bool reverseOrder() const;
+
 
     /** Process only specific HistoryActionIDs.
      * Call repeatedly to add multiple HistoryActionIDs to process.
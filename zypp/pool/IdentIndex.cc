@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/IdentIndex.cc
+ *
+*/
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+
+#include <zypp/pool/IdentIndex.h>
+#include <zypp/pool/ByIdent.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  {
+    namespace
+    {
+      /** Whether \a pi_r is (still) the item stored for its solvable id. */
+      inline bool inStore( const PoolItem & pi_r, const std::vector<PoolItem> & store_r )
+      { return pi_r.id() < store_r.size() && store_r[pi_r.id()] == pi_r; }
+    } // namespace
+
+    IdentIndex::IdentIndex( const std::vector<PoolItem> & store_r )
+    {
+      // (key, store index); the store is indexed by solvable id.
+      std::vector<Entry> entries;
+      entries.reserve( store_r.size() );
+      for ( unsigned i = 0; i < store_r.size(); ++i )
+      {
+        if ( store_r[i] )
+          entries.push_back( std::make_pair( ByIdent( store_r[i].satSolvable() ).get(), i ) );
+      }
+      std::sort( entries.begin(), entries.end() );
+      assign( entries, store_r );
+    }
+
+    IdentIndex::IdentIndex( const IdentIndex & prev_r, const std::vector<PoolItem> & store_r, const std::vector<PoolItem> & added_r )
+    {
+      // The previous items still in the store keep their order...
+      std::vector<Entry> kept;
+      kept.reserve( prev_r.size() );
+      for ( size_type idx = 0; idx < prev_r._keys.size(); ++idx )
+      {
+        for ( unsigned j = prev_r._offsets[idx]; j < prev_r._offsets[idx+1]; ++j )
+        {
+          const PoolItem & pi { prev_r._items[j] };
+          if ( inStore( pi, store_r ) )
+            kept.push_back( std::make_pair( prev_r._keys[idx], unsigned(pi.id()) ) );
+        }
+      }
+      // ...only the new ones need to be sorted and merged in.
+      std::vector<Entry> added;
+      added.reserve( added_r.size() );
+      for ( const PoolItem & pi : added_r )
+      {
+        if ( inStore( pi, store_r ) )
+          added.push_back( std::make_pair( ByIdent( pi.satSolvable() ).get(), unsigned(pi.id()) ) );
+      }
+      std::sort( added.begin(), added.end() );
+
+      std::vector<Entry> entries;
+      entries.reserve( kept.size() + added.size() );
+      std::merge( kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter( entries ) );
+      assign( entries, store_r );
+    }
+
+    void IdentIndex::assign( const std::vector<Entry> & entries_r, const std::vector<PoolItem> & store_r )
+    {
+      _items.reserve( entries_r.size() );
+      for ( const auto & entry : entries_r )
+      {
+        if ( _keys.empty() || _keys.back() != entry.first )
+        {
+          _kindIdents[store_r[entry.second].kind()].push_back( _keys.size() );
+          _keys.push_back( entry.first );
+          _offsets.push_back( _items.size() );
+        }
+        _items.push_back( store_r[entry.second] );
+      }
+      _offsets.push_back( _items.size() );
+    }
+
+    IdentIndex::size_type IdentIndex::identIndex( KeyType key_r ) const
+    {
+      auto it = std::lower_bound( _keys.begin(), _keys.end(), key_r );
+      if ( it == _keys.end() || *it != key_r )
+        return _keys.size();
+      return it - _keys.begin();
+    }
+
+    IdentIndex::Range IdentIndex::equal_range( KeyType key_r ) const
+    {
+      size_type idx = identIndex( key_r );
+      if ( idx == _keys.size() )
+        return Range( _items.end(), _items.end() );
+      return identItems( idx );
+    }
+
+    const std::vector<unsigned> & IdentIndex::kindIdents( const ResKind & kind_r ) const
+    {
+      static const std::vector<unsigned> _none;
+      auto it = _kindIdents.find( kind_r );
+      return it == _kindIdents.end() ? _none : it->second;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const IdentIndex & obj )
+    {
+      return str << "IdentIndex(" << obj.size() << " items, " << obj.identsSize() << " idents, " << obj._kindIdents.size() << " kinds)";
+    }
+
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
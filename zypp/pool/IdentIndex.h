@@ -0,0 +1,121 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/IdentIndex.h
+ *
+*/
+#ifndef ZYPP_POOL_IDENTINDEX_H
+#define ZYPP_POOL_IDENTINDEX_H
+
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+#include <zypp/PoolItem.h>
+#include <zypp/ResKind.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class IdentIndex
+    /// \brief Compact index of PoolItems by ident.
+    ///
+    /// All items are kept in one contiguous vector, sorted by their
+    /// \ref ByIdent key (the ident id, negative for srcpackages) and
+    /// solvable id. A sorted table of the distinct keys and their offsets
+    /// into the item vector (CSR layout) locates an ident by binary search.
+    /// The index is immutable once built. After a pool change a new index
+    /// is derived from the previous one by merging in the added items.
+    ///////////////////////////////////////////////////////////////////
+    class IdentIndex
+    {
+      friend std::ostream & operator<<( std::ostream & str, const IdentIndex & obj );
+
+    public:
+      typedef std::vector<PoolItem>::const_iterator	const_iterator;
+      typedef std::vector<PoolItem>::size_type		size_type;
+      typedef sat::detail::IdType			KeyType;
+      typedef std::pair<const_iterator,const_iterator>	Range;
+
+    public:
+      /** Default ctor: empty index */
+      IdentIndex()
+      {}
+
+      /** Build the index from the pools item store (empty PoolItems are skipped). */
+      explicit IdentIndex( const std::vector<PoolItem> & store_r );
+
+      /** Update \a prev_r for a changed store.
+       * Items no longer in \a store_r are dropped, \a added_r (the items
+       * added to the store since \a prev_r was built) are merged in. Only
+       * the added items are sorted.
+       */
+      IdentIndex( const IdentIndex & prev_r, const std::vector<PoolItem> & store_r, const std::vector<PoolItem> & added_r );
+
+    public:
+      /** Whether the index is empty. */
+      bool empty() const
+      { return _items.empty(); }
+
+      /** Number of items. */
+      size_type size() const
+      { return _items.size(); }
+
+      /** All items, grouped by ident. */
+      const_iterator begin() const
+      { return _items.begin(); }
+      /** \overload */
+      const_iterator end() const
+      { return _items.end(); }
+
+      /** The items of ident \a key_r (\ref ByIdent::get). */
+      Range equal_range( KeyType key_r ) const;
+
+    public:
+      /** Number of distinct idents. */
+      size_type identsSize() const
+      { return _keys.size(); }
+
+      /** The index of ident \a key_r or \ref identsSize if not present. */
+      size_type identIndex( KeyType key_r ) const;
+
+      /** The key of the \a idx_r th ident. */
+      KeyType identKey( size_type idx_r ) const
+      { return _keys[idx_r]; }
+
+      /** The items of the \a idx_r th ident. */
+      Range identItems( size_type idx_r ) const
+      { return Range( _items.begin() + _offsets[idx_r], _items.begin() + _offsets[idx_r+1] ); }
+
+      /** Indices of the idents of kind \a kind_r (sorted by key). */
+      const std::vector<unsigned> & kindIdents( const ResKind & kind_r ) const;
+
+    private:
+      typedef std::pair<KeyType,unsigned> Entry;	///< (key, solvable id)
+      /** Fill the index from \a entries_r sorted by (key, solvable id). */
+      void assign( const std::vector<Entry> & entries_r, const std::vector<PoolItem> & store_r );
+
+    private:
+      std::vector<PoolItem> _items;	///< items sorted by (key, solvable id)
+      std::vector<KeyType>  _keys;	///< sorted distinct keys
+      std::vector<unsigned> _offsets;	///< _items offset of each key, plus end offset
+      std::map<ResKind,std::vector<unsigned>> _kindIdents;
+    };
+
+    /** \relates IdentIndex Stream output */
+    std::ostream & operator<<( std::ostream & str, const IdentIndex & obj );
+
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOL_IDENTINDEX_H
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <zypp/base/LogTools.h>
 
+#include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/pool/PoolImpl.h>
 
 using std::endl;
@@ -50,7 +51,199 @@ namespace zypp
     //	METHOD TYPE : Dtor
     //
     PoolImpl::~PoolImpl()
-    {}
+    {
+      // PoolItems may outlive the pool and its StatusStore.
+      // The ones held by the store only are destroyed with it.
+      for ( const PoolItem & pi : _store )
+      {
+        if ( pi && pi.isShared() )
+          pi.detachStatus();
+      }
+    }
+
+    const PoolImpl::ContainerT & PoolImpl::store() const
+    {
+      checkSerial();
+      if ( _storeDirty )
+      {
+        sat::Pool pool( satpool() );
+        bool reusedIDs = _watcherIDs.remember( pool.serialIDs() );
+
+        std::map<sat::detail::RepoIdType,RepoRange> currentRepos;
+        for ( const Repository & repo : pool.repos() )
+        {
+          sat::detail::CRepo * crepo = repo.get();
+          currentRepos[crepo] = RepoRange{ SolvableIdType(crepo->start), SolvableIdType(crepo->end), crepo->nsolvables, crepo->priority, crepo->subpriority };
+        }
+
+        // Collect the id ranges to rescan and the repos which may hold new items.
+        std::vector<std::pair<SolvableIdType,SolvableIdType>> ranges;
+        std::set<std::string> changedRepos;
+        if ( reusedIDs )
+        {
+          // All PoolItems are stale; rebuild everything.
+          if ( pool.capacity() )
+            ranges.push_back( { 1, pool.capacity() } );
+        }
+        else
+        {
+          for ( const auto & old : _storeRepos )
+          {
+            auto it = currentRepos.find( old.first );
+            if ( it == currentRepos.end() || it->second != old.second )
+              ranges.push_back( { old.second._start, old.second._end } );
+          }
+          for ( const auto & cur : currentRepos )
+          {
+            auto it = _storeRepos.find( cur.first );
+            if ( it == _storeRepos.end() || it->second != cur.second )
+            {
+              ranges.push_back( { cur.second._start, cur.second._end } );
+              changedRepos.insert( Repository( cur.first ).alias() );
+            }
+          }
+        }
+        _storeRepos.swap( currentRepos );
+        if ( _poolProxyPrev )
+          _proxyChangedRanges.insert( _proxyChangedRanges.end(), ranges.begin(), ranges.end() );
+
+        // Without reused IDs the capacity never shrinks.
+        for ( SolvableIdType i = pool.capacity(); i < _store.size(); ++i )
+        {
+          if ( _store[i] )
+            _store[i].detachStatus();
+        }
+        _store.resize( pool.capacity() );
+        _statusStore.grow( pool.capacity() );
+
+        std::vector<PoolItem> addedItems;
+        bool changed = false;
+        for ( const auto & range : ranges )
+        {
+          if ( updateStoreRange( range.first, std::min( range.second, SolvableIdType(_store.size()) ), reusedIDs, addedItems ) )
+            changed = true;
+        }
+        _storeDirty = false;
+
+        if ( changed )
+        {
+          // id2item merges the changes into the existing index, unless all items were recreated.
+          if ( reusedIDs )
+            _id2itemRebuild = true;
+          else if ( _id2item && ! _id2itemRebuild )
+            _id2itemAdded.insert( _id2itemAdded.end(), addedItems.begin(), addedItems.end() );
+          _id2itemDirty = true;
+        }
+
+        DBG << "Store update: " << ranges.size() << " id ranges, " << addedItems.size() << " new items" << endl;
+
+        // Now, as the pool is adjusted, ....
+
+        // .... we check for product buddies.
+        for ( PoolItem & pi : addedItems )
+        {
+          if ( pi.isKind( ResKind::product ) )
+            pi.setBuddy( asKind<Product>(pi)->referencePackage() );
+        }
+
+        // .... we must reapply those query based hard locks.
+        if ( ! addedItems.empty() )
+          reapplyHardLocks( addedItems, reusedIDs ? std::set<std::string>() : changedRepos );
+
+        // Compute the initial status of Patches etc.
+        if ( !_establishedStates )
+          _establishedStates.reset( new EstablishedStatesImpl );
+      }
+      return _store;
+    }
+
+    bool PoolImpl::updateStoreRange( SolvableIdType begin_r, SolvableIdType end_r, bool reusedIDs_r,
+                                     std::vector<PoolItem> & added_r ) const
+    {
+      bool changed = false;
+      for ( SolvableIdType i = begin_r; i < end_r; ++i )
+      {
+        sat::Solvable s( i );
+        PoolItem & pi( _store[i] );
+        if ( pi && ( reusedIDs_r || ! s ) )
+        {
+          // the PoolItem got invalidated (e.g unloaded repo)
+          pi.detachStatus();
+          pi = PoolItem();
+          changed = true;
+        }
+        if ( s && ! pi )
+        {
+          // new PoolItem to add
+          pi = PoolItem::makePoolItem( s, _statusStore.init( i, s.isSystem() ) ); // the only way to create a new one!
+          added_r.push_back( pi );
+          changed = true;
+        }
+      }
+      return changed;
+    }
+
+    const PoolImpl::Id2ItemT & PoolImpl::id2item() const
+    {
+      store();
+      if ( _id2itemDirty )
+      {
+        // A new index, as the previous one may still be referenced (id2itemPtr).
+        if ( _id2item && ! _id2itemRebuild )
+          _id2item.reset( new Id2ItemT( *_id2item, _store, _id2itemAdded ) );
+        else
+          _id2item.reset( new Id2ItemT( _store ) );
+        _id2itemAdded.clear();
+        _id2itemRebuild = false;
+        _id2itemDirty = false;
+      }
+      return *_id2item;
+    }
+
+    void PoolImpl::reapplyHardLocks( const std::vector<PoolItem> & added_r, const std::set<std::string> & repos_r ) const
+    {
+      MIL << "Re-apply " << _hardLockQueries.size() << " HardLockQueries to " << added_r.size() << " new items" << endl;
+      if ( _hardLockQueries.empty() )
+        return;
+
+      PoolQueryResult locked;
+      for ( const PoolQuery & query : _hardLockQueries )
+      {
+        if ( repos_r.empty() )
+        {
+          locked += query;
+          continue;
+        }
+        // Restrict the query to the changed repos; skip it if it
+        // is limited to repos which did not change.
+        PoolQuery q( query );
+        if ( q.repos().empty() )
+        {
+          for ( const std::string & alias : repos_r )
+            q.addRepo( alias );
+        }
+        else
+        {
+          bool relevant = false;
+          for ( const std::string & alias : q.repos() )
+          {
+            if ( repos_r.count( alias ) )
+            {
+              relevant = true;
+              break;
+            }
+          }
+          if ( ! relevant )
+            continue;
+        }
+        locked += q;
+      }
+      MIL << "HardLockQueries match " << locked.size() << " Solvables." << endl;
+      for ( const PoolItem & pi : added_r )
+      {
+        resstatus::UserLockQueryManip::reapplyLock( pi.status(), locked.contains( pi ) );
+      }
+    }
 
     /////////////////////////////////////////////////////////////////
   } // namespace pool
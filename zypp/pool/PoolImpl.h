@@ -13,6 +13,9 @@
 #define ZYPP_POOL_POOLIMPL_H
 
 #include <iosfwd>
+#include <map>
+#include <set>
+#include <vector>
 
 #include <zypp/base/Easy.h>
 #include <zypp/base/LogTools.h>
@@ -20,6 +23,7 @@
 #include <zypp/APIConfig.h>
 
 #include <zypp/pool/PoolTraits.h>
+#include <zypp/pool/StatusStore.h>
 #include <zypp/ResPoolProxy.h>
 #include <zypp/PoolQueryResult.h>
 
@@ -246,11 +250,26 @@ namespace zypp
           checkSerial();
           if ( !_poolProxy )
           {
+            store();	// collect the changes since the previous proxy
             _poolProxy.reset( new ResPoolProxy( self, *this ) );
+            _poolProxyPrev.reset();
+            _proxyChangedRanges.clear();
           }
           return *_poolProxy;
         }
 
+        /** The proxy replaced by the pending one (if any).
+         * The new proxy may reuse its Selectables if their items did not change.
+         */
+        const shared_ptr<ResPoolProxy> & previousProxy() const
+        { return _poolProxyPrev; }
+
+        /** Solvable id ranges changed since the \ref previousProxy was built.
+         * Contains <tt>[1,capacity)</tt> if all PoolItems were recreated.
+         */
+        const std::vector<std::pair<SolvableIdType,SolvableIdType>> & proxyChangedRanges() const
+        { return _proxyChangedRanges; }
+
         /** True factory for \ref ResPool::EstablishedStates.
 	 * Internally we maintain the ResPool::EstablishedStates::Impl
 	 * reference shared_ptr. Updated whenever the pool content changes.
@@ -283,25 +302,6 @@ namespace zypp
         const HardLockQueries & hardLockQueries() const
         { return _hardLockQueries; }
 
-        void reapplyHardLocks() const
-        {
-          // It is assumed that reapplyHardLocks is called after new
-          // items were added to the pool, but the _hardLockQueries
-          // did not change since. Action is to be performed only on
-          // those items that gained the bit in the UserLockQueryField.
-          MIL << "Re-apply " << _hardLockQueries.size() << " HardLockQueries" << endl;
-          PoolQueryResult locked;
-          for_( it, _hardLockQueries.begin(), _hardLockQueries.end() )
-          {
-            locked += *it;
-          }
-          MIL << "HardLockQueries match " << locked.size() << " Solvables." << endl;
-          for_( it, begin(), end() )
-          {
-            resstatus::UserLockQueryManip::reapplyLock( it->status(), locked.contains( *it ) );
-          }
-        }
-
         void setHardLockQueries( const HardLockQueries & newLocks_r )
         {
           MIL << "Apply " << newLocks_r.size() << " HardLockQueries" << endl;
@@ -360,87 +360,27 @@ namespace zypp
        }
 
       public:
-        const ContainerT & store() const
-        {
-          checkSerial();
-          if ( _storeDirty )
-          {
-            sat::Pool pool( satpool() );
-            bool addedItems = false;
-	    bool reusedIDs = _watcherIDs.remember( pool.serialIDs() );
-            std::list<PoolItem> addedProducts;
-
-	    _store.resize( pool.capacity() );
-
-            if ( pool.capacity() )
-            {
-              for ( sat::detail::SolvableIdType i = pool.capacity()-1; i != 0; --i )
-              {
-                sat::Solvable s( i );
-                PoolItem & pi( _store[i] );
-                if ( ! s &&  pi )
-                {
-                  // the PoolItem got invalidated (e.g unloaded repo)
-                  pi = PoolItem();
-                }
-                else if ( reusedIDs || (s && ! pi) )
-                {
-                  // new PoolItem to add
-                  pi = PoolItem::makePoolItem( s ); // the only way to create a new one!
-                  // remember products for buddy processing (requires clean store)
-                  if ( s.isKind( ResKind::product ) )
-                    addedProducts.push_back( pi );
-                  if ( !addedItems )
-                    addedItems = true;
-                }
-              }
-            }
-            _storeDirty = false;
-
-            // Now, as the pool is adjusted, ....
+        /** The PoolItems indexed by solvable id.
+         * Whenever the sat pool changed, only the id ranges of repos
+         * added, erased or modified since the last call are rescanned
+         * (all of them if the pool reused IDs). The hard locks are
+         * re-applied to the new items only.
+         */
+        const ContainerT & store() const;
 
-            // .... we check for product buddies.
-            if ( ! addedProducts.empty() )
-            {
-              for_( it, addedProducts.begin(), addedProducts.end() )
-              {
-                it->setBuddy( asKind<Product>(*it)->referencePackage() );
-              }
-            }
+        /** Index of all PoolItems by ident (negative ident id for srcpackages).
+         * If the store changed, the items added since are merged into the
+         * previous index (rebuilt from scratch if all PoolItems were recreated).
+         */
+        const Id2ItemT & id2item() const;
 
-            // .... we must reapply those query based hard locks.
-            if ( addedItems )
-            {
-              reapplyHardLocks();
-            }
+        /** The status of all PoolItems, indexed by solvable id. */
+        StatusStore & statusStore() const
+        { store(); return _statusStore; }
 
-	    // Compute the initial status of Patches etc.
-            if ( !_establishedStates )
-	      _establishedStates.reset( new EstablishedStatesImpl );
-          }
-          return _store;
-        }
-
-	const Id2ItemT & id2item () const
-	{
-	  checkSerial();
-	  if ( _id2itemDirty )
-	  {
-	    store();
-	    _id2item = Id2ItemT( size() );
-            for_( it, begin(), end() )
-            {
-              const sat::Solvable &s = (*it)->satSolvable();
-              sat::detail::IdType id = s.ident().id();
-              if ( s.isKind( ResKind::srcpackage ) )
-                id = -id;
-              _id2item.insert( std::make_pair( id, *it ) );
-            }
-            //INT << _id2item << endl;
-	    _id2itemDirty = false;
-          }
-	  return _id2item;
-	}
+        /** \ref id2item as shared_ptr, allowing to keep it beyond the next pool change. */
+        shared_ptr<const Id2ItemT> id2itemPtr() const
+        { id2item(); return _id2item; }
 
         ///////////////////////////////////////////////////////////////////
         //
@@ -455,25 +395,66 @@ namespace zypp
 
         void invalidate() const
         {
+          // _id2item is kept unless store() actually changes
           _storeDirty = true;
-	  _id2itemDirty = true;
-	  _id2item.clear();
+          if ( _poolProxy )
+            _poolProxyPrev.swap( _poolProxy );
           _poolProxy.reset();
 	  _establishedStates.reset();
         }
 
+        /** Re-apply the hard locks to items newly added to the store.
+         * It is assumed that new items were added to the pool, but the
+         * _hardLockQueries did not change since. Action is to be performed
+         * only on those items that gained the bit in the UserLockQueryField.
+         * Unless \a repos_r is empty, the queries are restricted to these repos.
+         */
+        void reapplyHardLocks( const std::vector<PoolItem> & added_r, const std::set<std::string> & repos_r ) const;
+
+        /** Update \c _store for the solvable ids in [\a begin_r, \a end_r).
+         * Returns whether items were added or removed.
+         */
+        bool updateStoreRange( SolvableIdType begin_r, SolvableIdType end_r, bool reusedIDs_r,
+                               std::vector<PoolItem> & added_r ) const;
+
       private:
         /** Watch sat pools serial number. */
         SerialNumberWatcher                   _watcher;
 	/** Watch sat pools Serial number of IDs - changes whenever resusePoolIDs==true - ResPool must also invalidate it's PoolItems! */
         SerialNumberWatcher                   _watcherIDs;
         mutable ContainerT                    _store;
+        mutable StatusStore                   _statusStore;
         mutable DefaultIntegral<bool,true>    _storeDirty;
-	mutable Id2ItemT		      _id2item;
+	mutable shared_ptr<Id2ItemT>	      _id2item;
         mutable DefaultIntegral<bool,true>    _id2itemDirty;
+        /** Items added since \c _id2item was built; merged in on the next \ref id2item call. */
+        mutable std::vector<PoolItem>         _id2itemAdded;
+        /** \c _id2item must be rebuilt from scratch (all PoolItems were recreated). */
+        mutable DefaultIntegral<bool,false>   _id2itemRebuild;
+
+        /** Solvable id range, size and priority of a repo when the store was last updated. */
+        struct RepoRange
+        {
+          SolvableIdType _start = 0;
+          SolvableIdType _end = 0;
+          int _nsolvables = 0;
+          int _priority = 0;
+          int _subpriority = 0;
+          bool operator==( const RepoRange & rhs ) const
+          {
+            return _start == rhs._start && _end == rhs._end && _nsolvables == rhs._nsolvables
+                && _priority == rhs._priority && _subpriority == rhs._subpriority;
+          }
+          bool operator!=( const RepoRange & rhs ) const
+          { return ! ( *this == rhs ); }
+        };
+        /** The repos the store was last updated for. */
+        mutable std::map<sat::detail::RepoIdType,RepoRange> _storeRepos;
 
       private:
         mutable shared_ptr<ResPoolProxy>      _poolProxy;
+        mutable shared_ptr<ResPoolProxy>      _poolProxyPrev;
+        mutable std::vector<std::pair<SolvableIdType,SolvableIdType>> _proxyChangedRanges;
 	mutable shared_ptr<EstablishedStatesImpl> _establishedStates;
 
       private:
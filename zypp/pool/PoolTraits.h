@@ -22,6 +22,7 @@
 
 #include <zypp/PoolItem.h>
 #include <zypp/pool/ByIdent.h>
+#include <zypp/pool/IdentIndex.h>
 #include <zypp/sat/Pool.h>
 
 ///////////////////////////////////////////////////////////////////
@@ -35,6 +36,7 @@ namespace zypp
   { /////////////////////////////////////////////////////////////////
 
     class PoolImpl;
+    class StatusStore;
 
     /** Pool internal filter skiping invalid/unwanted PoolItems. */
     struct ByPoolItem
@@ -75,11 +77,8 @@ namespace zypp
       typedef ItemContainerT::size_type			size_type;
 
       /** ident index */
-      typedef std::unordered_multimap<sat::detail::IdType, PoolItem>
-                                                        Id2ItemT;
-      typedef P_Select2nd<Id2ItemT::value_type>         Id2ItemValueSelector;
-      typedef transform_iterator<Id2ItemValueSelector, Id2ItemT::const_iterator>
-                                                        byIdent_iterator;
+      typedef IdentIndex				Id2ItemT;
+      typedef Id2ItemT::const_iterator			byIdent_iterator;
 
       /** list of known Repositories */
       typedef sat::Pool::RepositoryIterator	        repository_iterator;
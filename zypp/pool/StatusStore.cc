@@ -0,0 +1,164 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/StatusStore.cc
+ *
+*/
+#include <algorithm>
+#include <mutex>
+
+#include <zypp/pool/StatusStore.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  {
+    namespace
+    {
+      /** The slots outside any store.
+       * Never destroyed, as PoolItems may be released after static
+       * destruction started. Shared by all threads (and \ref PoolContext
+       * pools), so access is serialized.
+       */
+      struct DetachedSlots
+      {
+        static DetachedSlots & instance()
+        {
+          static DetachedSlots & _instance { *new DetachedSlots };
+          return _instance;
+        }
+
+        ResStatus * get()
+        {
+          std::lock_guard<std::mutex> guard( _mutex );
+          if ( ! _free.empty() )
+          {
+            ResStatus * ret = _free.back();
+            _free.pop_back();
+            return ret;
+          }
+          _store.grow( _used+1 );
+          return &_store[_used++];
+        }
+
+        void release( ResStatus * status_r )
+        {
+          *status_r = StatusStore::saved( *status_r ) = ResStatus();
+          std::lock_guard<std::mutex> guard( _mutex );
+          _free.push_back( status_r );
+        }
+
+      private:
+        StatusStore _store;
+        StatusStore::IdType _used = 0;
+        std::vector<ResStatus *> _free;
+        std::mutex _mutex;
+      };
+    } // namespace
+
+    ///////////////////////////////////////////////////////////////////
+    //	class StatusStore
+    ///////////////////////////////////////////////////////////////////
+
+    StatusStore::StatusStore()
+    {}
+
+    StatusStore::~StatusStore()
+    {}
+
+    void StatusStore::grow( IdType size_r )
+    {
+      while ( size() < size_r )
+        _blocks.emplace_back( new ResStatus[2*blockSize] );	// current and saved values
+    }
+
+    ResStatus & StatusStore::init( IdType id_r, bool isInstalled_r )
+    {
+      ResStatus & ret { (*this)[id_r] };
+      ret = saved( ret ) = ResStatus( isInstalled_r );
+      return ret;
+    }
+
+    bool StatusStore::sameState( const ResStatus & status_r, const ResStatus & saved_r )
+    {
+      if ( status_r == saved_r )
+        return true;
+      // some bits changed...
+      if ( status_r.getTransactValue() != saved_r.getTransactValue()
+           && ( ! status_r.isBySolver() // ignore solver state changes
+                // removing a user lock also goes to bySolver
+                || saved_r.getTransactValue() == ResStatus::LOCKED ) )
+        return false;
+      if ( status_r.isLicenceConfirmed() != saved_r.isLicenceConfirmed() )
+        return false;
+      return true;
+    }
+
+    ResStatus * StatusStore::detached()
+    { return DetachedSlots::instance().get(); }
+
+    ResStatus * StatusStore::detach( ResStatus & status_r )
+    {
+      ResStatus * ret = detached();
+      *ret = status_r;
+      saved( *ret ) = saved( status_r );
+      status_r = saved( status_r ) = ResStatus();
+      return ret;
+    }
+
+    void StatusStore::release( ResStatus * status_r )
+    { DetachedSlots::instance().release( status_r ); }
+
+    sat::Map StatusStore::transacting() const
+    { return select( []( const ResStatus & status_r ) { return status_r.transacts(); } ); }
+
+    sat::Map StatusStore::locked() const
+    { return select( []( const ResStatus & status_r ) { return status_r.isLocked(); } ); }
+
+    sat::Map StatusStore::byUser() const
+    { return select( []( const ResStatus & status_r ) { return status_r.isByUser(); } ); }
+
+    void StatusStore::resetTransact( ResStatus::TransactByValue causer_r ) const
+    {
+      forEach( [causer_r]( IdType, ResStatus & status_r ) {
+        if ( status_r.transacts() )
+          status_r.resetTransact( causer_r );
+      } );
+    }
+
+    void StatusStore::saveState() const
+    {
+      for ( const auto & block : _blocks )
+        std::copy( block.get(), block.get() + blockSize, block.get() + blockSize );
+    }
+
+    void StatusStore::restoreState() const
+    {
+      for ( const auto & block : _blocks )
+        std::copy( block.get() + blockSize, block.get() + 2*blockSize, block.get() );
+    }
+
+    bool StatusStore::diffState() const
+    {
+      for ( const auto & block : _blocks )
+      {
+        for ( const ResStatus * it = block.get(), * end = it + blockSize; it != end; ++it )
+        {
+          if ( ! sameState( *it, it[blockSize] ) )
+            return true;
+        }
+      }
+      return false;
+    }
+
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/StatusStore.h
+ *
+*/
+#ifndef ZYPP_POOL_STATUSSTORE_H
+#define ZYPP_POOL_STATUSSTORE_H
+
+#include <memory>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/ResStatus.h>
+#include <zypp/sat/Map.h>
+#include <zypp/sat/detail/PoolMember.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class StatusStore
+    /// \brief The \ref ResStatus of all PoolItems, indexed by solvable id.
+    ///
+    /// A PoolItem refers to its slot in the store, so pool-wide status
+    /// operations iterate a plain array instead of chasing the pointers
+    /// to each PoolItems implementation.
+    ///
+    /// The slots are allocated in blocks of \ref blockSize, so they never
+    /// move when the store grows. Each block holds the current status
+    /// values followed by the saved ones (see \ref saved), so saving and
+    /// restoring the state of the whole pool is a plain block copy.
+    ///
+    /// A PoolItem dropped from the pool (e.g. its repo was unloaded)
+    /// \ref detach es its status to a slot outside the store. The freed
+    /// slot is reset to a default \ref ResStatus, which is neither
+    /// transacting nor locked. So are slots not backed by a PoolItem.
+    ///
+    /// \note Buddies (e.g. a product and its reference package) share the
+    /// buddy's slot. The bitmap views and bulk operations refer to the
+    /// status stored per id and report them at the buddy's id only.
+    ///////////////////////////////////////////////////////////////////
+    class StatusStore : private base::NonCopyable
+    {
+    public:
+      typedef sat::detail::SolvableIdType IdType;
+
+      /** Number of slots per block. */
+      static constexpr IdType blockSize = 4096;
+
+    public:
+      /** Default ctor: empty store */
+      StatusStore();
+
+      /** Dtor */
+      ~StatusStore();
+
+    public:
+      /** Ids <tt>[0,size)</tt> are backed by a slot. */
+      IdType size() const
+      { return _blocks.size() * blockSize; }
+
+      /** Make sure ids <tt>[0,size_r)</tt> are backed by a slot (never shrinks). */
+      void grow( IdType size_r );
+
+      /** The status of \a id_r (must be less than \ref size). */
+      ResStatus & operator[]( IdType id_r ) const
+      { return _blocks[id_r / blockSize][id_r % blockSize]; }
+
+      /** Initialize the slot of a new PoolItem and return it. */
+      ResStatus & init( IdType id_r, bool isInstalled_r );
+
+      /** The saved status belonging to the slot \a status_r. */
+      static ResStatus & saved( ResStatus & status_r )
+      { return (&status_r)[blockSize]; }
+
+      /** Whether \a status_r and its \a saved_r status differ in a relevant way.
+       * Changes done by the solver are ignored.
+       */
+      static bool sameState( const ResStatus & status_r, const ResStatus & saved_r );
+
+    public:
+      /** \name Slots outside the store.
+       * Used by PoolItems not (or no longer) in a pool.
+       */
+      //@{
+      /** A new default initialized slot. */
+      static ResStatus * detached();
+
+      /** Move the current and saved values of \a status_r to a new slot
+       * and reset \a status_r.
+       */
+      static ResStatus * detach( ResStatus & status_r );
+
+      /** Free a slot obtained by \ref detached or \ref detach. */
+      static void release( ResStatus * status_r );
+      //@}
+
+    public:
+      /** \name Bitmap views.
+       * A bit is set for each id whose status matches.
+       */
+      //@{
+      template <class TPred>
+      sat::Map select( TPred && pred_r ) const
+      {
+        sat::Map ret( size() );
+        forEach( [&]( IdType id_r, const ResStatus & status_r ) {
+          if ( pred_r( status_r ) )
+            ret.set( id_r );
+        } );
+        return ret;
+      }
+
+      /** Items to be installed or deleted. */
+      sat::Map transacting() const;
+
+      /** Locked items. */
+      sat::Map locked() const;
+
+      /** Items whose transact value was set by the user. */
+      sat::Map byUser() const;
+      //@}
+
+    public:
+      /** \name Bulk operations. */
+      //@{
+      /** Invoke <tt>fnc_r( IdType, ResStatus & )</tt> for each slot. */
+      template <class TFnc>
+      void forEach( TFnc && fnc_r ) const
+      {
+        IdType id = 0;
+        for ( const auto & block : _blocks )
+        {
+          for ( ResStatus * it = block.get(), * end = it + blockSize; it != end; ++it, ++id )
+            fnc_r( id, *it );
+        }
+      }
+
+      /** Number of slots whose status matches \a pred_r. */
+      template <class TPred>
+      IdType count( TPred && pred_r ) const
+      {
+        IdType ret = 0;
+        forEach( [&]( IdType, const ResStatus & status_r ) {
+          if ( pred_r( status_r ) )
+            ++ret;
+        } );
+        return ret;
+      }
+
+      /** \ref ResStatus::resetTransact all transacting items. */
+      void resetTransact( ResStatus::TransactByValue causer_r ) const;
+
+      /** Remember the current status of all items. */
+      void saveState() const;
+
+      /** Restore the status of all items saved by \ref saveState. */
+      void restoreState() const;
+
+      /** Whether some item is not in the \ref sameState it was saved in. */
+      bool diffState() const;
+      //@}
+
+    private:
+      std::vector<std::unique_ptr<ResStatus[]>> _blocks;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOL_STATUSSTORE_H
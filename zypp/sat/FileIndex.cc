@@ -0,0 +1,295 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/FileIndex.cc
+ */
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repodata.h>
+#include <solv/dataiterator.h>
+#include <solv/knownid.h>
+}
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/detail/PoolImpl.h>
+
+#include <zypp/sat/FileIndex.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  {
+    namespace
+    {
+      /** Sort \a strs_r and return each strings new position (indexed by the old one). */
+      std::vector<uint32_t> sortAndRank( std::vector<std::string> & strs_r )
+      {
+        std::vector<uint32_t> order( strs_r.size() );
+        for ( uint32_t i = 0; i < order.size(); ++i )
+          order[i] = i;
+        std::sort( order.begin(), order.end(), [&strs_r]( uint32_t lhs, uint32_t rhs ) {
+          return strs_r[lhs] < strs_r[rhs];
+        } );
+
+        std::vector<uint32_t> rank( strs_r.size() );
+        std::vector<std::string> sorted( strs_r.size() );
+        for ( uint32_t i = 0; i < order.size(); ++i )
+        {
+          rank[order[i]] = i;
+          sorted[i].swap( strs_r[order[i]] );
+        }
+        strs_r.swap( sorted );
+        return rank;
+      }
+
+      /** Position of \a str_r in the sorted \a strs_r, or \c -1. */
+      inline int findRank( const std::vector<std::string> & strs_r, const std::string & str_r )
+      {
+        auto it = std::lower_bound( strs_r.begin(), strs_r.end(), str_r );
+        return( it != strs_r.end() && *it == str_r ? it - strs_r.begin() : -1 );
+      }
+    } // namespace
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class FileIndex::Impl
+    /// \brief FileIndex implementation.
+    ///
+    /// Entries are sorted by (directory, basename, solvable). \c _dirStart
+    /// holds the first entry of each directory (plus the end), \c _byBase
+    /// the entries sorted by basename, delimited by \c _baseStart.
+    ///////////////////////////////////////////////////////////////////
+    class FileIndex::Impl
+    {
+      struct Entry
+      {
+        uint32_t _dir;
+        uint32_t _base;
+        detail::SolvableIdType _solv;
+
+        bool operator<( const Entry & rhs ) const
+        {
+          if ( _dir != rhs._dir )
+            return _dir < rhs._dir;
+          if ( _base != rhs._base )
+            return _base < rhs._base;
+          return _solv < rhs._solv;
+        }
+        bool operator==( const Entry & rhs ) const
+        { return _dir == rhs._dir && _base == rhs._base && _solv == rhs._solv; }
+      };
+
+    public:
+      Impl( Repository repo_r )
+      : _repo( repo_r )
+      {
+        if ( ! _repo )
+          return;
+
+        // Directories are interned by (repodata, dirid) first, to
+        // compute each directory string just once.
+        std::unordered_map<uint64_t,uint32_t> dirIds;
+        std::unordered_map<std::string,uint32_t> dirByStr;
+        std::unordered_map<std::string,uint32_t> baseByStr;
+
+        ::Dataiterator di;
+        ::dataiterator_init( &di, sat::Pool::instance().get(), _repo.get(), 0, SOLVABLE_FILELIST, 0, 0 );
+        while ( ::dataiterator_step( &di ) )
+        {
+          uint64_t key = ( uint64_t( di.data->repodataid ) << 32 ) | uint32_t( di.kv.id );
+          auto dit = dirIds.find( key );
+          if ( dit == dirIds.end() )
+          {
+            std::string path( ::repodata_dir2str( di.data, di.kv.id, di.kv.str ) );
+            std::string::size_type sep = path.rfind( '/' );
+            std::string dir( sep == std::string::npos ? std::string() : path.substr( 0, sep ) );
+            auto sit = dirByStr.find( dir );
+            if ( sit == dirByStr.end() )
+            {
+              sit = dirByStr.insert( std::make_pair( dir, uint32_t(_dirs.size()) ) ).first;
+              _dirs.push_back( dir );
+            }
+            dit = dirIds.insert( std::make_pair( key, sit->second ) ).first;
+          }
+
+          auto bit = baseByStr.find( di.kv.str );
+          if ( bit == baseByStr.end() )
+          {
+            bit = baseByStr.insert( std::make_pair( std::string( di.kv.str ), uint32_t(_bases.size()) ) ).first;
+            _bases.push_back( di.kv.str );
+          }
+
+          _entries.push_back( { dit->second, bit->second, detail::SolvableIdType(di.solvid) } );
+        }
+        ::dataiterator_free( &di );
+
+        // Use the ranks in sort order as ids, so ranges of directories
+        // are ranges of entries.
+        std::vector<uint32_t> dirRank( sortAndRank( _dirs ) );
+        std::vector<uint32_t> baseRank( sortAndRank( _bases ) );
+        for ( Entry & entry : _entries )
+        {
+          entry._dir = dirRank[entry._dir];
+          entry._base = baseRank[entry._base];
+        }
+        std::sort( _entries.begin(), _entries.end() );
+        _entries.erase( std::unique( _entries.begin(), _entries.end() ), _entries.end() );
+        _entries.shrink_to_fit();
+
+        _dirStart.assign( _dirs.size()+1, 0 );
+        for ( const Entry & entry : _entries )
+          ++_dirStart[entry._dir+1];
+        for ( unsigned i = 1; i < _dirStart.size(); ++i )
+          _dirStart[i] += _dirStart[i-1];
+
+        _baseStart.assign( _bases.size()+1, 0 );
+        for ( const Entry & entry : _entries )
+          ++_baseStart[entry._base+1];
+        for ( unsigned i = 1; i < _baseStart.size(); ++i )
+          _baseStart[i] += _baseStart[i-1];
+        _byBase.resize( _entries.size() );
+        {
+          std::vector<uint32_t> fill( _baseStart.begin(), _baseStart.end()-1 );
+          for ( uint32_t i = 0; i < _entries.size(); ++i )
+            _byBase[fill[_entries[i]._base]++] = i;
+        }
+
+        DBG << _repo << ": indexed " << _entries.size() << " files in " << _dirs.size() << " directories" << endl;
+      }
+
+    public:
+      Solvables lookup( const std::string & str_r, Mode mode_r ) const
+      {
+        std::vector<detail::SolvableIdType> ids;
+        switch ( mode_r )
+        {
+          case PATH:
+          {
+            std::string::size_type sep = str_r.rfind( '/' );
+            if ( sep == std::string::npos )
+              break;
+            int dir = findRank( _dirs, str_r.substr( 0, sep ) );
+            int base = findRank( _bases, str_r.substr( sep+1 ) );
+            if ( dir < 0 || base < 0 )
+              break;
+            auto b = _entries.begin() + _dirStart[dir];
+            auto e = _entries.begin() + _dirStart[dir+1];
+            auto r = std::equal_range( b, e, Entry{ uint32_t(dir), uint32_t(base), 0 },
+                                       []( const Entry & lhs, const Entry & rhs ) { return lhs._base < rhs._base; } );
+            for ( auto it = r.first; it != r.second; ++it )
+              ids.push_back( it->_solv );
+            break;
+          }
+
+          case DIR:
+          {
+            std::string dir( str_r );
+            while ( ! dir.empty() && dir.back() == '/' )
+              dir.pop_back();
+            int exact = findRank( _dirs, dir );
+            if ( exact >= 0 )
+              addEntries( _dirStart[exact], _dirStart[exact+1], ids );
+            // all subdirectories sort between "dir/" and "dir0" ('0' follows '/')
+            uint32_t lo = std::lower_bound( _dirs.begin(), _dirs.end(), dir+'/' ) - _dirs.begin();
+            uint32_t hi = std::lower_bound( _dirs.begin(), _dirs.end(), dir+'0' ) - _dirs.begin();
+            addEntries( _dirStart[lo], _dirStart[hi], ids );
+            break;
+          }
+
+          case BASENAME:
+          {
+            int base = findRank( _bases, str_r );
+            if ( base < 0 )
+              break;
+            for ( uint32_t i = _baseStart[base]; i < _baseStart[base+1]; ++i )
+              ids.push_back( _entries[_byBase[i]]._solv );
+            break;
+          }
+        }
+
+        std::sort( ids.begin(), ids.end() );
+        ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() );
+        return Solvables( ids.begin(), ids.end() );
+      }
+
+    private:
+      void addEntries( uint32_t begin_r, uint32_t end_r, std::vector<detail::SolvableIdType> & ids_r ) const
+      {
+        for ( uint32_t i = begin_r; i < end_r; ++i )
+          ids_r.push_back( _entries[i]._solv );
+      }
+
+    public:
+      Repository _repo;
+      std::vector<std::string> _dirs;	// sorted
+      std::vector<std::string> _bases;	// sorted
+      std::vector<Entry> _entries;
+      std::vector<uint32_t> _dirStart;
+      std::vector<uint32_t> _baseStart;
+      std::vector<uint32_t> _byBase;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    //	class FileIndex
+    ///////////////////////////////////////////////////////////////////
+
+    FileIndex::FileIndex( Repository repo_r )
+    : _pimpl( new Impl( repo_r ) )
+    {}
+
+    FileIndex::~FileIndex()
+    {}
+
+    Repository FileIndex::repository() const
+    { return _pimpl->_repo; }
+
+    FileIndex::size_type FileIndex::size() const
+    { return _pimpl->_entries.size(); }
+
+    FileIndex::Solvables FileIndex::lookup( const std::string & str_r, Mode mode_r ) const
+    { return _pimpl->lookup( str_r, mode_r ); }
+
+    shared_ptr<const FileIndex> FileIndex::get( Repository repo_r )
+    {
+      if ( ! repo_r )
+        return shared_ptr<const FileIndex>( new FileIndex( repo_r ) );
+      return detail::PoolMember::myPool().fileIndex( repo_r.get() );
+    }
+
+    shared_ptr<const FileIndex> FileIndex::cached( Repository repo_r )
+    { return repo_r ? detail::PoolMember::myPool().cachedFileIndex( repo_r.get() ) : nullptr; }
+
+    FileIndex::Solvables FileIndex::poolLookup( const std::string & str_r, Mode mode_r )
+    {
+      Solvables ret;
+      for ( const Repository & repo : sat::Pool::instance().repos() )
+      {
+        Solvables solvs( get( repo )->lookup( str_r, mode_r ) );
+        ret.insert( ret.end(), solvs.begin(), solvs.end() );
+      }
+      return ret;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const FileIndex & obj )
+    {
+      return str << "FileIndex(" << obj.repository().alias() << ":" << obj.size() << ")";
+    }
+
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/FileIndex.h
+ */
+#ifndef ZYPP_SAT_FILEINDEX_H
+#define ZYPP_SAT_FILEINDEX_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/base/PtrTypes.h>
+#include <zypp/Repository.h>
+#include <zypp/sat/Solvable.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class FileIndex
+    /// \brief Path to solvable index of a repos \ref SolvAttr::filelist.
+    ///
+    /// Answers "who ships this path" without scanning the filelists.
+    /// Lookups are supported for an exact path, for all files at or below
+    /// a directory and for a basename in any directory.
+    ///
+    /// Directories and basenames are stored once and referenced by their
+    /// rank in sort order, so an entry takes just 12 bytes.
+    ///
+    /// \code
+    ///   for ( const Repository & repo : sat::Pool::instance().repos() )
+    ///     for ( const sat::Solvable & solv : sat::FileIndex::get( repo )->path( "/usr/bin/zypper" ) )
+    ///       ...
+    ///   // or simply:
+    ///   sat::FileIndex::Solvables owners( sat::FileIndex::poolLookup( "/usr/bin/zypper" ) );
+    /// \endcode
+    ///
+    /// \ref get builds the index on first use and keeps it in the pool
+    /// until the repos content changes. \ref PoolQuery uses it for exact
+    /// path (\ref Match::STRING) and directory (\ref Match::STRINGSTART
+    /// with trailing \c /) searches in the filelist, once the index was
+    /// built by \ref get.
+    ///////////////////////////////////////////////////////////////////
+    class FileIndex : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const FileIndex & obj );
+
+    public:
+      typedef std::vector<Solvable> Solvables;
+      typedef unsigned size_type;
+
+      /** Lookup modes */
+      enum Mode
+      {
+        PATH,		///< The exact path.
+        DIR,		///< All files at or below the directory.
+        BASENAME,	///< The basename in any directory.
+      };
+
+    public:
+      /** Build the index of \a repo_r. */
+      explicit FileIndex( Repository repo_r );
+
+      ~FileIndex();
+
+      /** The indexed repo. */
+      Repository repository() const;
+
+      /** Number of indexed (path,solvable) entries. */
+      size_type size() const;
+
+      /** The solvables containing \a str_r according to \a mode_r (sorted by id, unique). */
+      Solvables lookup( const std::string & str_r, Mode mode_r = PATH ) const;
+
+      /** \overload PATH */
+      Solvables path( const std::string & path_r ) const
+      { return lookup( path_r, PATH ); }
+
+      /** \overload DIR */
+      Solvables dir( const std::string & dir_r ) const
+      { return lookup( dir_r, DIR ); }
+
+      /** \overload BASENAME */
+      Solvables basename( const std::string & name_r ) const
+      { return lookup( name_r, BASENAME ); }
+
+    public:
+      /** The (cached) index of \a repo_r, built on first use. */
+      static shared_ptr<const FileIndex> get( Repository repo_r );
+
+      /** The index of \a repo_r if it was already built (\c nullptr otherwise). */
+      static shared_ptr<const FileIndex> cached( Repository repo_r );
+
+      /** \ref lookup in all repos, in pool order. */
+      static Solvables poolLookup( const std::string & str_r, Mode mode_r = PATH );
+
+    public:
+      class Impl;
+    private:
+      scoped_ptr<Impl> _pimpl;
+    };
+
+    /** \relates FileIndex Stream output */
+    std::ostream & operator<<( std::ostream & str, const FileIndex & obj );
+
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_SAT_FILEINDEX_H
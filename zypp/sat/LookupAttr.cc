@@ -624,8 +624,16 @@ namespace zypp
             break;
 
           case REPOKEY_TYPE_STR:
+            {
+              const char * ret( c_str() );
+              return ret ? ret : "";
+            }
+            break;
+
           case REPOKEY_TYPE_DIRSTRARRAY:
             {
+              // composed in libsolvs temporary buffers
+              auto guard( detail::PoolMember::myPool().frozenLock() );
               const char * ret( c_str() );
               return ret ? ret : "";
             }
@@ -766,6 +774,12 @@ namespace zypp
     {
       if ( _dip )
       {
+	// Matching file names or checksums composes them in libsolvs temporary
+	// buffers. They are reused round robin, so the string must be copied
+	// before the lock is released.
+	std::unique_lock<std::mutex> guard;
+	if ( _dip->flags & ( SEARCH_FILES | SEARCH_CHECKSUMS ) )
+	  guard = detail::PoolMember::myPool().frozenLock();
 	if ( ! ::dataiterator_step( _dip.get() ) )
 	{
 	  _dip.reset();
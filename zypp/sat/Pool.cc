@@ -61,6 +61,17 @@ namespace zypp
     void Pool::prepare() const
     { return myPool().prepare(); }
 
+    Pool::Frozen Pool::freeze()
+    {
+      myPool().freeze();
+      Frozen ret;
+      ret._token.reset( &myPool(), []( detail::PoolImpl * pool_r ) { pool_r->thaw(); } );
+      return ret;
+    }
+
+    bool Pool::frozen() const
+    { return myPool().frozen(); }
+
     Pathname Pool::rootDir() const
     { return myPool().rootDir(); }
 
@@ -204,6 +215,15 @@ namespace zypp
       return ret;
     }
 
+    void Pool::prefetchRepoSolv( const Pathname & file_r )
+    {
+      AutoFD fd( ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC ) );
+      if ( fd == -1 )
+        return;
+      // WILLNEED starts asynchronous readahead of the whole file and returns.
+      ::posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+    }
+
     /////////////////////////////////////////////////////////////////
 
     Repository Pool::addRepoHelix( const Pathname & file_r, const std::string & alias_r )
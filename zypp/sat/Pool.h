@@ -72,6 +72,58 @@ namespace zypp
         /** Update housekeeping data if necessary (e.g. whatprovides). */
         void prepare() const;
 
+      public:
+        /** \name Frozen pool for concurrent readers.
+         *
+         * The pool computes lots of data on demand (e.g. whatprovides in \ref prepare),
+         * so even reading it may change it. \ref freeze does all of this in advance
+         * and turns the pool read-only: \ref PoolQuery, \ref LookupAttr, \ref WhatProvides
+         * and the \ref Solvable accessors may then be used by many threads concurrently.
+         *
+         * As long as the pool is frozen, any change (adding or removing repos or
+         * solvables, changing locales, ...) is rejected by throwing an \ref Exception.
+         * This includes creating an \ref IdString or \ref Capability not yet known
+         * to the pool. Build those before freezing. The pool is thawed when the last
+         * copy of the returned \ref Frozen is gone.
+         *
+         * \code
+         *   sat::Pool::Frozen frozen( sat::Pool::instance().freeze() );
+         *   // start the reader threads...
+         * \endcode
+         *
+         * \note Not covered are the \ref ResPool and \ref PoolItem status, which
+         * are per se meant to be changed, and the raw \c c_str of dependency
+         * expressions (see \ref Capability::c_str).
+         */
+        //@{
+        /** Keeps the pool frozen as long as a copy of it exists. */
+        class Frozen
+        {
+        public:
+          /** Default ctor: not freezing the pool. */
+          Frozen()
+          {}
+
+          /** Whether this keeps the pool frozen. */
+          explicit operator bool() const
+          { return bool(_token); }
+
+          /** Release this freeze (the pool is thawed if it was the last one). */
+          void reset()
+          { _token.reset(); }
+
+        private:
+          friend class Pool;
+          shared_ptr<void> _token;
+        };
+
+        /** Prepare the pool for concurrent readers and reject changes while frozen. */
+        Frozen freeze();
+
+        /** Whether the pool is frozen. */
+        bool frozen() const;
+        //@}
+
 	/** Get rootdir (for file conflicts check) */
 	Pathname rootDir() const;
 
@@ -143,6 +195,13 @@ namespace zypp
         */
         Repository addRepoSolv( const Pathname & file_r, const RepoInfo & info_r );
 
+        /** Hint the kernel to asynchronously read \a file_r into the page cache.
+         * Call this for the next solv-file while the current one is added via
+         * \ref addRepoSolv, so loading many repos does not wait for disk IO.
+         * Errors are silently ignored.
+         */
+        static void prefetchRepoSolv( const Pathname & file_r );
+
       public:
         /** Load \ref Solvables from a helix-file into a \ref Repository named \c name_r.
          * Supports loading of gzip compressed files (.gz). In case of an exception
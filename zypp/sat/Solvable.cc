@@ -40,6 +40,18 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     namespace
     {
+      /** Localized \a attr_r in \a lang_r, looked up like \c solvable_lookup_str_lang, but
+       * without using libsolvs temporary buffers (shared by all threads on a frozen pool).
+       */
+      inline const char * lookupStrLangFrozen( detail::CSolvable * solv_r, const SolvAttr & attr_r, const char * lang_r )
+      {
+        std::string key( attr_r.asString() );
+        key += ':';
+        key += lang_r;
+        detail::IdType id = ::pool_str2id( solv_r->repo->pool, key.c_str(), /*create*/false );
+        return id ? ::solvable_lookup_str( solv_r, id ) : 0;
+      }
+
       void _doSplit( IdString & _ident, ResKind & _kind, IdString & _name )
       {
         if ( ! _ident )
@@ -137,7 +149,24 @@ namespace zypp
     {
       NO_SOLVABLE_RETURN( std::string() );
       const char * s = 0;
-      if ( !lang_r )
+      if ( myPool().frozen() )
+      {
+        if ( !lang_r )
+        {
+          // pool languages
+          detail::CPool * pool = _solvable->repo->pool;
+          for ( int i = 0; i < pool->nlanguages && !s; ++i )
+            s = lookupStrLangFrozen( _solvable, attr, pool->languages[i] );
+        }
+        else
+        {
+          for ( Locale l( lang_r ); l && !s; l = l.fallback() )
+            s = lookupStrLangFrozen( _solvable, attr, l.c_str() );
+        }
+        if ( !s )
+          s = ::solvable_lookup_str( _solvable, attr.id() );
+      }
+      else if ( !lang_r )
       {
         s = ::solvable_lookup_str_poollang( _solvable, attr.id() );
       }
@@ -200,9 +229,10 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     namespace
     {
+      const SolvAttr susetagsDatadir( detail::constStr2id( "susetags:datadir" ) );
+
       inline Pathname lookupDatadirIn( Repository repor_r )
       {
-        static const SolvAttr susetagsDatadir( "susetags:datadir" );
         Pathname ret;
         // First look for repo attribute "susetags:datadir". If not found,
         // look into the solvables as Code11 libsolv placed it there.
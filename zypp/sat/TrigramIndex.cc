@@ -0,0 +1,684 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/TrigramIndex.cc
+ */
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+#include <solv/repodata.h>
+#include <solv/dataiterator.h>
+#include <solv/knownid.h>
+}
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/base/StrMatcher.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/PathInfo.h>
+
+#include <zypp/sat/TrigramIndex.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  {
+    namespace
+    {
+      const char     _magic[8]	= { 'Z','Y','P','P','T','R','I','2' };
+      const uint32_t _byteorder	= 0x01020304;
+
+      /** The indexed attributes (also the order in the file). */
+      enum { A_NAME, A_SUMMARY, A_DESCRIPTION, A_FILELIST, A_COUNT };
+
+      inline int attrSlot( const SolvAttr & attr_r )
+      {
+        if ( attr_r == SolvAttr::name )		return A_NAME;
+        if ( attr_r == SolvAttr::summary )	return A_SUMMARY;
+        if ( attr_r == SolvAttr::description )	return A_DESCRIPTION;
+        if ( attr_r == SolvAttr::filelist )	return A_FILELIST;
+        return -1;
+      }
+
+      inline unsigned char lower( unsigned char ch_r )
+      { return ( ch_r >= 'A' && ch_r <= 'Z' ) ? ch_r + ( 'a' - 'A' ) : ch_r; }
+
+      /** Append the trigrams of \a str_r to \a tris_r. */
+      inline void addTrigrams( const char * str_r, std::vector<uint32_t> & tris_r )
+      {
+        if ( ! str_r )
+          return;
+        size_t len = ::strlen( str_r );
+        for ( size_t i = 2; i < len; ++i )
+        {
+          tris_r.push_back( ( uint32_t(lower(str_r[i-2])) << 16 )
+                          | ( uint32_t(lower(str_r[i-1])) << 8 )
+                          |   uint32_t(lower(str_r[i])) );
+        }
+      }
+
+      /** Bytes to add after \a len_r bytes to reach a 4 byte boundary. */
+      inline unsigned padding( uint32_t len_r )
+      { return ( 4 - len_r % 4 ) % 4; }
+
+      inline void putVarint( uint32_t val_r, std::vector<uint8_t> & data_r )
+      {
+        while ( val_r >= 0x80 )
+        {
+          data_r.push_back( uint8_t(val_r) | 0x80 );
+          val_r >>= 7;
+        }
+        data_r.push_back( uint8_t(val_r) );
+      }
+
+      inline uint32_t getVarint( const uint8_t *& data_r )
+      {
+        uint32_t ret = 0;
+        for ( unsigned shift = 0; ; shift += 7 )
+        {
+          uint8_t b = *data_r++;
+          ret |= uint32_t( b & 0x7f ) << shift;
+          if ( ! ( b & 0x80 ) )
+            break;
+        }
+        return ret;
+      }
+
+      /** Trigram postings of one attribute in CSR layout (delta varint encoded offsets).
+       * Points into the mapped index file.
+       */
+      struct Postings
+      {
+        uint32_t         _nkeys = 0;
+        const uint32_t * _keys = nullptr;	// sorted trigrams
+        const uint32_t * _offs = nullptr;	// _data offset per trigram, plus end offset
+        const uint8_t *  _data = nullptr;
+
+        /** Decode the solvables containing trigram \a tri_r; \c false if there are none. */
+        bool get( uint32_t tri_r, std::vector<unsigned> & ret_r ) const
+        {
+          ret_r.clear();
+          const uint32_t * kend = _keys + _nkeys;
+          const uint32_t * it = std::lower_bound( _keys, kend, tri_r );
+          if ( it == kend || *it != tri_r )
+            return false;
+          size_t idx = it - _keys;
+          const uint8_t * p = _data + _offs[idx];
+          const uint8_t * e = _data + _offs[idx+1];
+          unsigned val = 0;
+          while ( p < e )
+          {
+            val += getVarint( p );
+            ret_r.push_back( val );
+          }
+          return true;
+        }
+      };
+
+      /** Collects the postings of one attribute while building. */
+      struct PostingsBuilder
+      {
+        std::unordered_map<uint32_t,std::vector<uint8_t>> _data;
+        std::unordered_map<uint32_t,unsigned> _last;
+
+        /** Add solvable \a off_r for \a tris_r (which gets sorted and uniqued). Offsets must be added in ascending order. */
+        void add( unsigned off_r, std::vector<uint32_t> & tris_r )
+        {
+          std::sort( tris_r.begin(), tris_r.end() );
+          tris_r.erase( std::unique( tris_r.begin(), tris_r.end() ), tris_r.end() );
+          for ( uint32_t tri : tris_r )
+          {
+            auto last = _last.find( tri );
+            unsigned delta = ( last == _last.end() ? off_r : off_r - last->second );
+            putVarint( delta, _data[tri] );
+            _last[tri] = off_r;
+          }
+          tris_r.clear();
+        }
+
+        void write( std::ostream & str_r ) const
+        {
+          std::vector<uint32_t> keys;
+          keys.reserve( _data.size() );
+          for ( const auto & el : _data )
+            keys.push_back( el.first );
+          std::sort( keys.begin(), keys.end() );
+
+          uint32_t nkeys = keys.size();
+          uint32_t off = 0;
+          std::vector<uint32_t> offs;
+          offs.reserve( nkeys+1 );
+          for ( uint32_t key : keys )
+          {
+            offs.push_back( off );
+            off += _data.at( key ).size();
+          }
+          offs.push_back( off );
+
+          str_r.write( (const char *)&nkeys, sizeof(nkeys) );
+          str_r.write( (const char *)&off, sizeof(off) );
+          str_r.write( (const char *)keys.data(), nkeys * sizeof(uint32_t) );
+          str_r.write( (const char *)offs.data(), offs.size() * sizeof(uint32_t) );
+          for ( uint32_t key : keys )
+          {
+            const std::vector<uint8_t> & data( _data.at( key ) );
+            str_r.write( (const char *)data.data(), data.size() );
+          }
+          // keep the next postings keys aligned
+          static const char pad[4] = { 0, 0, 0, 0 };
+          str_r.write( pad, padding( off ) );
+        }
+      };
+
+      /** Remember size and mtime of the solv file the index belongs to. */
+      struct SolvStamp
+      {
+        uint64_t _size = 0;
+        int64_t  _mtime = 0;
+
+        SolvStamp() {}
+        SolvStamp( const Pathname & solvfile_r )
+        {
+          PathInfo pi( solvfile_r );
+          _size = pi.size();
+          _mtime = pi.mtime();
+        }
+        bool operator==( const SolvStamp & rhs ) const
+        { return _size == rhs._size && _mtime == rhs._mtime; }
+      };
+
+      /** Position of the \c ']' closing the bracket expression starting at \a pos_r (or \c npos). */
+      std::string::size_type bracketEnd( const std::string & str_r, std::string::size_type pos_r )
+      {
+        std::string::size_type e = pos_r+1;
+        if ( e < str_r.size() && ( str_r[e] == '^' || str_r[e] == '!' ) )
+          ++e;
+        if ( e < str_r.size() && str_r[e] == ']' )
+          ++e;
+        return str_r.find( ']', e );
+      }
+
+      /** Append the literal runs of a glob or regex \a str_r to \a lits_r.
+       * Returns \c false if the pattern is too complex.
+       */
+      bool patternLiterals( const std::string & str_r, bool regex_r, std::vector<std::string> & lits_r )
+      {
+        std::string run;
+        auto flush = [&]() {
+          if ( ! run.empty() )
+          {
+            lits_r.push_back( run );
+            run.clear();
+          }
+        };
+
+        for ( std::string::size_type i = 0; i < str_r.size(); ++i )
+        {
+          char ch = str_r[i];
+          if ( ch == '\\' )
+          {
+            if ( i+1 == str_r.size() )
+              return false;
+            char next = str_r[++i];
+            if ( regex_r && ::strchr( "bB<>`'", next ) )
+            {
+              flush();	// anchors
+              continue;
+            }
+            if ( ::isalnum( (unsigned char)next ) )
+              return false;	// character class or backreference
+            run += next;
+            continue;
+          }
+
+          if ( ch == '[' )
+          {
+            // skip the bracket expression
+            std::string::size_type e = bracketEnd( str_r, i );
+            if ( e == std::string::npos )
+              return false;
+            i = e;
+            flush();
+            continue;
+          }
+
+          if ( regex_r )
+          {
+            if ( ::strchr( "(){}|", ch ) )
+              return false;
+            if ( ch == '?' || ch == '*' )
+            {
+              // previous char is optional
+              if ( ! run.empty() )
+                run.erase( run.size()-1 );
+              flush();
+              continue;
+            }
+            if ( ::strchr( ".+^$", ch ) )
+            {
+              flush();	// '+': the previous char may repeat
+              continue;
+            }
+          }
+          else if ( ch == '*' || ch == '?' )
+          {
+            flush();
+            continue;
+          }
+          run += ch;
+        }
+        flush();
+        return true;
+      }
+
+      /** Split a regex into its top level alternatives.
+       * Handles a single enclosing group with optional anchors, as
+       * \ref PoolQuery creates when joining multiple search strings.
+       * Other groups are rejected later by \ref patternLiterals.
+       */
+      bool regexAlternatives( std::string str_r, std::vector<std::string> & alternatives_r )
+      {
+        // strip anchors
+        if ( str::startsWith( str_r, "^" ) )
+          str_r.erase( 0, 1 );
+        else if ( str::startsWith( str_r, "\\b" ) )
+          str_r.erase( 0, 2 );
+        if ( str::endsWith( str_r, "\\b" ) )
+          str_r.erase( str_r.size()-2 );
+        else if ( str::endsWith( str_r, "$" ) && ! str::endsWith( str_r, "\\$" ) )
+          str_r.erase( str_r.size()-1 );
+
+        bool group = ( str::startsWith( str_r, "(" ) && str::endsWith( str_r, ")" ) && ! str::endsWith( str_r, "\\)" ) );
+        if ( group )
+          str_r = str_r.substr( 1, str_r.size()-2 );
+
+        std::string::size_type b = 0;
+        for ( std::string::size_type i = 0; i <= str_r.size(); ++i )
+        {
+          if ( i == str_r.size() || str_r[i] == '|' )
+          {
+            alternatives_r.push_back( str_r.substr( b, i-b ) );
+            b = i+1;
+          }
+          else if ( str_r[i] == '\\' )
+            ++i;
+          else if ( str_r[i] == '[' )
+          {
+            i = bracketEnd( str_r, i );
+            if ( i == std::string::npos )
+              return false;
+          }
+        }
+        return true;
+      }
+    } // namespace
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class TrigramIndex::Impl
+    /// \brief TrigramIndex implementation.
+    ///////////////////////////////////////////////////////////////////
+    class TrigramIndex::Impl
+    {
+    public:
+      Impl()
+      {}
+
+      /** Map the index read-only and shared, so all processes using the
+       * same repos share a single copy of it in the page cache.
+       */
+      Impl( const Pathname & solvfile_r )
+      {
+        Pathname idxfile( indexFile( solvfile_r ) );
+        AutoFD fd( ::open( idxfile.c_str(), O_RDONLY|O_CLOEXEC ) );
+        if ( fd == -1 )
+          return;
+        struct stat st;
+        if ( ::fstat( fd, &st ) != 0 || st.st_size == 0 )
+          return;
+        size_t len = st.st_size;
+        void * addr = ::mmap( nullptr, len, PROT_READ, MAP_SHARED, fd, 0 );
+        if ( addr == MAP_FAILED )
+        {
+          WAR << "Can't map trigram index " << idxfile << ": " << str::strerror( errno ) << endl;
+          return;
+        }
+        _map = AutoDispose<void*>( addr, [len]( void * addr_r ) { ::munmap( addr_r, len ); } );
+
+        const uint8_t * p = (const uint8_t *)addr;
+        const uint8_t * e = p + len;
+        auto take = [&p,e]( size_t n_r ) -> const uint8_t * {
+          if ( size_t(e - p) < n_r )
+            return nullptr;
+          const uint8_t * ret = p;
+          p += n_r;
+          return ret;
+        };
+        auto takeU32 = [&take]( uint32_t & val_r ) -> bool {
+          const uint8_t * v = take( sizeof(val_r) );
+          if ( v )
+            ::memcpy( &val_r, v, sizeof(val_r) );
+          return v;
+        };
+
+        const uint8_t * magic = take( sizeof(_magic) );
+        uint32_t byteorder = 0;
+        SolvStamp stamp;
+        const uint8_t * size = nullptr;
+        const uint8_t * mtime = nullptr;
+        if ( magic && ::memcmp( magic, _magic, sizeof(_magic) ) == 0 && takeU32( byteorder ) && byteorder == _byteorder )
+        {
+          size = take( sizeof(stamp._size) );
+          mtime = ( size ? take( sizeof(stamp._mtime) ) : nullptr );
+        }
+        if ( ! mtime || ! takeU32( _nsolvables ) )
+        {
+          WAR << "Ignore bad trigram index " << idxfile << endl;
+          return;
+        }
+        ::memcpy( &stamp._size, size, sizeof(stamp._size) );
+        ::memcpy( &stamp._mtime, mtime, sizeof(stamp._mtime) );
+        if ( ! ( stamp == SolvStamp( solvfile_r ) ) )
+        {
+          WAR << "Ignore stale trigram index " << idxfile << endl;
+          return;
+        }
+
+        for ( Postings & postings : _postings )
+        {
+          uint32_t datalen = 0;
+          if ( ! takeU32( postings._nkeys ) || ! takeU32( datalen ) )
+          {
+            truncated( idxfile );
+            return;
+          }
+          postings._keys = (const uint32_t *)take( postings._nkeys * sizeof(uint32_t) );
+          postings._offs = (const uint32_t *)take( (postings._nkeys+1) * sizeof(uint32_t) );
+          postings._data = take( datalen );
+          if ( ! postings._keys || ! postings._offs || ! postings._data || ! take( padding( datalen ) )
+               || postings._offs[postings._nkeys] != datalen )
+          {
+            truncated( idxfile );
+            return;
+          }
+        }
+        _valid = true;
+        DBG << "Mapped trigram index " << idxfile << " (" << _nsolvables << " solvables)" << endl;
+      }
+
+      void truncated( const Pathname & idxfile_r )
+      {
+        WAR << "Ignore truncated trigram index " << idxfile_r << endl;
+        for ( Postings & postings : _postings )
+          postings = Postings();
+      }
+
+    public:
+      bool candidates( int slot_r, const Literals & literals_r, std::vector<unsigned> & offsets_r ) const
+      {
+        offsets_r.clear();
+        if ( ! _valid || slot_r < 0 || literals_r.empty() )
+          return false;
+
+        const Postings & postings( _postings[slot_r] );
+        std::vector<unsigned> hits;
+        std::vector<unsigned> tmp;
+        std::vector<uint32_t> tris;
+        for ( const std::vector<std::string> & alternative : literals_r )
+        {
+          tris.clear();
+          for ( const std::string & lit : alternative )
+            addTrigrams( lit.c_str(), tris );
+          if ( tris.empty() )
+            return false;	// can't restrict this alternative
+          std::sort( tris.begin(), tris.end() );
+          tris.erase( std::unique( tris.begin(), tris.end() ), tris.end() );
+
+          // intersect the postings of all trigrams
+          std::vector<unsigned> acc;
+          bool first = true;
+          for ( uint32_t tri : tris )
+          {
+            if ( ! postings.get( tri, tmp ) )
+            {
+              acc.clear();
+              break;
+            }
+            if ( first )
+            {
+              acc.swap( tmp );
+              first = false;
+            }
+            else
+            {
+              std::vector<unsigned> isect;
+              std::set_intersection( acc.begin(), acc.end(), tmp.begin(), tmp.end(), std::back_inserter( isect ) );
+              acc.swap( isect );
+            }
+            if ( acc.empty() )
+              break;
+          }
+
+          // unite the alternatives
+          std::vector<unsigned> unite;
+          std::set_union( hits.begin(), hits.end(), acc.begin(), acc.end(), std::back_inserter( unite ) );
+          hits.swap( unite );
+        }
+        offsets_r.swap( hits );
+        return true;
+      }
+
+    public:
+      bool _valid = false;
+      uint32_t _nsolvables = 0;
+      Postings _postings[A_COUNT];
+      AutoDispose<void*> _map;	///< the mapped index file
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    //	class TrigramIndex
+    ///////////////////////////////////////////////////////////////////
+
+    TrigramIndex::TrigramIndex()
+    : _pimpl( new Impl )
+    {}
+
+    TrigramIndex::TrigramIndex( const Pathname & solvfile_r )
+    : _pimpl( new Impl( solvfile_r ) )
+    {}
+
+    TrigramIndex::~TrigramIndex()
+    {}
+
+    TrigramIndex::operator bool() const
+    { return _pimpl->_valid; }
+
+    unsigned TrigramIndex::solvablesSize() const
+    { return _pimpl->_nsolvables; }
+
+    bool TrigramIndex::indexed( const SolvAttr & attr_r )
+    { return attrSlot( attr_r ) >= 0; }
+
+    bool TrigramIndex::candidates( const SolvAttr & attr_r, const Literals & literals_r, std::vector<unsigned> & offsets_r ) const
+    { return _pimpl->candidates( attrSlot( attr_r ), literals_r, offsets_r ); }
+
+    Pathname TrigramIndex::indexFile( const Pathname & solvfile_r )
+    { return solvfile_r.extend( ".tri" ); }
+
+    bool TrigramIndex::build( const Pathname & solvfile_r )
+    {
+      AutoDispose<FILE*> solv( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
+      if ( solv == NULL )
+      {
+        solv.resetDispose();
+        ERR << "Can't open solv-file: " << solvfile_r << endl;
+        return false;
+      }
+
+      AutoDispose<detail::CPool*> pool( ::pool_create(), ::pool_free );
+      detail::CRepo * repo = ::repo_create( pool, "" );
+      if ( ::repo_add_solv( repo, solv, 0 ) != 0 )
+      {
+        ERR << "Can't read solv-file: " << ::pool_errstr( pool ) << endl;
+        return false;
+      }
+      uint32_t nsolvables = repo->end - repo->start;
+      if ( int(nsolvables) != repo->nsolvables )
+      {
+        ERR << "Unexpected gaps in solv-file: " << solvfile_r << endl;
+        return false;
+      }
+
+      PostingsBuilder builder[A_COUNT];
+      std::vector<uint32_t> tris;
+      int id = 0;
+      detail::CSolvable * s = nullptr;
+      FOR_REPO_SOLVABLES( repo, id, s )
+      {
+        unsigned off = id - repo->start;
+        addTrigrams( ::pool_id2str( pool, s->name ), tris );
+        builder[A_NAME].add( off, tris );
+        addTrigrams( ::repo_lookup_str( repo, id, SOLVABLE_SUMMARY ), tris );
+        builder[A_SUMMARY].add( off, tris );
+        addTrigrams( ::repo_lookup_str( repo, id, SOLVABLE_DESCRIPTION ), tris );
+        builder[A_DESCRIPTION].add( off, tris );
+      }
+      {
+        ::Dataiterator di;
+        ::dataiterator_init( &di, pool, repo, 0, SOLVABLE_FILELIST, 0, 0 );
+        int lastid = 0;
+        while ( ::dataiterator_step( &di ) )
+        {
+          if ( di.solvid != lastid )
+          {
+            if ( lastid )
+              builder[A_FILELIST].add( lastid - repo->start, tris );
+            lastid = di.solvid;
+          }
+          addTrigrams( ::repodata_dir2str( di.data, di.kv.id, di.kv.str ), tris );
+        }
+        if ( lastid )
+          builder[A_FILELIST].add( lastid - repo->start, tris );
+        ::dataiterator_free( &di );
+      }
+
+      // Write to a temp file and rename, so readers never see a partial index.
+      Pathname idxfile( indexFile( solvfile_r ) );
+      Pathname tmpfile( idxfile.extend( ".new" ) );
+      {
+        std::ofstream str( tmpfile.c_str(), std::ios::binary|std::ios::trunc );
+        SolvStamp stamp( solvfile_r );
+        str.write( _magic, sizeof(_magic) );
+        str.write( (const char *)&_byteorder, sizeof(_byteorder) );
+        str.write( (const char *)&stamp._size, sizeof(stamp._size) );
+        str.write( (const char *)&stamp._mtime, sizeof(stamp._mtime) );
+        str.write( (const char *)&nsolvables, sizeof(nsolvables) );
+        for ( const PostingsBuilder & b : builder )
+          b.write( str );
+        if ( ! str )
+        {
+          ERR << "Can't write trigram index: " << tmpfile << endl;
+          filesystem::unlink( tmpfile );
+          return false;
+        }
+      }
+      if ( filesystem::rename( tmpfile, idxfile ) != 0 )
+      {
+        filesystem::unlink( tmpfile );
+        return false;
+      }
+      MIL << "Built trigram index " << idxfile << " (" << nsolvables << " solvables)" << endl;
+      return true;
+    }
+
+    bool TrigramIndex::literals( const StrMatcher & matcher_r, Literals & literals_r )
+    {
+      literals_r.clear();
+      const std::string & search( matcher_r.searchstring() );
+      if ( search.empty() )
+        return false;	// matches always
+
+      switch ( matcher_r.flags().mode() )
+      {
+        case Match::STRING:
+        case Match::STRINGSTART:
+        case Match::STRINGEND:
+        case Match::SUBSTRING:
+          literals_r.push_back( { search } );
+          break;
+
+        case Match::GLOB:
+          literals_r.resize( 1 );
+          if ( ! patternLiterals( search, false, literals_r.back() ) )
+            return false;
+          break;
+
+        case Match::REGEX:
+        {
+          std::vector<std::string> alternatives;
+          if ( ! regexAlternatives( search, alternatives ) )
+            return false;
+          for ( const std::string & alternative : alternatives )
+          {
+            literals_r.resize( literals_r.size()+1 );
+            if ( ! patternLiterals( alternative, true, literals_r.back() ) )
+              return false;
+          }
+          break;
+        }
+
+        case Match::NOTHING:
+        case Match::OTHER:
+          return false;
+      }
+
+      // each alternative needs a trigram
+      for ( const auto & alternative : literals_r )
+      {
+        bool hasTrigram = false;
+        for ( const std::string & lit : alternative )
+        {
+          if ( lit.size() >= 3 )
+          {
+            hasTrigram = true;
+            break;
+          }
+        }
+        if ( ! hasTrigram )
+          return false;
+      }
+      return true;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const TrigramIndex & obj )
+    {
+      str << "TrigramIndex(";
+      if ( obj )
+        str << obj.solvablesSize() << " solvables";
+      else
+        str << "invalid";
+      return str << ")";
+    }
+
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/TrigramIndex.h
+ */
+#ifndef ZYPP_SAT_TRIGRAMINDEX_H
+#define ZYPP_SAT_TRIGRAMINDEX_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/base/PtrTypes.h>
+#include <zypp/Pathname.h>
+#include <zypp/sat/SolvAttr.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  class StrMatcher;
+
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class TrigramIndex
+    /// \brief Trigram index of a solv file's searchable strings.
+    ///
+    /// For \ref SolvAttr::name, \c summary, \c description and \c filelist,
+    /// every (lowercased) 3-byte sequence maps to the solvables whose attribute
+    /// value contains it. Solvables are identified by their offset within the
+    /// repo, i.e. the order they are stored in the solv file.
+    ///
+    /// The index is a prefilter: \ref candidates returns a superset of the
+    /// solvables a \ref StrMatcher may match. The candidates still need to be
+    /// verified.
+    ///
+    /// The index is written next to the solv file (\c solv.tri) by
+    /// \ref build and remembers size and mtime of the solv file it was
+    /// built from. A stale or unreadable index is not loaded.
+    ///
+    /// Loading maps the file read-only and shared instead of copying it
+    /// to the heap. All processes using the same repo cache (zypper,
+    /// PackageKit, ...) thus share one copy of the index in memory, and
+    /// attaching it costs no more than checking its header.
+    ///////////////////////////////////////////////////////////////////
+    class TrigramIndex : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const TrigramIndex & obj );
+
+    public:
+      /** Alternatives (OR) of literal strings which must all (AND) be present. */
+      typedef std::vector<std::vector<std::string>> Literals;
+
+    public:
+      /** Default ctor: empty, invalid index */
+      TrigramIndex();
+
+      /** Load the index built for \a solvfile_r (invalid if missing or stale). */
+      explicit TrigramIndex( const Pathname & solvfile_r );
+
+      ~TrigramIndex();
+
+      /** Whether the index was loaded. */
+      explicit operator bool() const;
+
+      /** Number of solvables in the indexed solv file. */
+      unsigned solvablesSize() const;
+
+      /** Whether \a attr_r is indexed. */
+      static bool indexed( const SolvAttr & attr_r );
+
+      /** Offsets of the solvables whose \a attr_r value may match \a literals_r.
+       * Returns \c false if the index is not able to restrict the candidates.
+       */
+      bool candidates( const SolvAttr & attr_r, const Literals & literals_r, std::vector<unsigned> & offsets_r ) const;
+
+    public:
+      /** Name of the index file built for \a solvfile_r. */
+      static Pathname indexFile( const Pathname & solvfile_r );
+
+      /** Build the index for \a solvfile_r.
+       * Returns \c false if the solv file can not be read or the index not be written.
+       */
+      static bool build( const Pathname & solvfile_r );
+
+      /** The literal strings any string matched by \a matcher_r must contain.
+       * Returns \c false if they can not be determined (e.g. complex regex),
+       * or if some alternative contains no literal of at least 3 bytes.
+       */
+      static bool literals( const StrMatcher & matcher_r, Literals & literals_r );
+
+    public:
+      class Impl;
+    private:
+      scoped_ptr<Impl> _pimpl;
+    };
+
+    /** \relates TrigramIndex Stream output */
+    std::ostream & operator<<( std::ostream & str, const TrigramIndex & obj );
+
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_SAT_TRIGRAMINDEX_H
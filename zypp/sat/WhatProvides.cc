@@ -60,6 +60,17 @@ namespace zypp
           _private = &_pdata.front(); // ptr to 1st element
         }
 
+        /** Copy the \c 0 terminated \a ids_r. */
+        Impl( const detail::IdType * ids_r )
+        : _offset( 0 ), _private( 0 )
+        {
+          for ( ; *ids_r; ++ids_r )
+            _pdata.push_back( *ids_r );
+          _pdata.push_back( detail::noId );
+
+          _private = &_pdata.front(); // ptr to 1st element
+        }
+
       public:
         unsigned                         _offset;
         const detail::IdType *           _private;
@@ -96,6 +107,17 @@ namespace zypp
 
     WhatProvides::WhatProvides( Capability cap_r )
     {
+      if ( myPool().frozen() )
+      {
+        // libsolv computes some results on demand, relocating whatprovidesdata.
+        // Concurrent readers must not keep an offset into it.
+        auto guard( myPool().frozenLock() );
+        unsigned res( myPool().whatProvides( cap_r ) );
+        if ( myPool().whatProvidesData( res ) )
+          _pimpl.reset( new Impl( &myPool().getPool()->whatprovidesdata[res] ) );
+        return;
+      }
+
       unsigned res( myPool().whatProvides( cap_r ) );
       if ( myPool().whatProvidesData( res ) )
       {
@@ -23,10 +23,12 @@
 #include <zypp/base/IOStream.h>
 
 #include <zypp/ZConfig.h>
+#include <zypp/PathInfo.h>
 
 #include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/sat/SolvableSet.h>
 #include <zypp/sat/Pool.h>
+#include <zypp/sat/FileIndex.h>
 #include <zypp/Capability.h>
 #include <zypp/Locale.h>
 #include <zypp/PoolItem.h>
@@ -36,6 +38,7 @@
 
 extern "C"
 {
+#include <solv/evr.h>
 // Workaround libsolv project not providing a common include
 // directory. (the -devel package does, but the git repo doesn't).
 // #include <solv/repo_helix.h>
@@ -175,12 +178,59 @@ namespace zypp
       //	METHOD NAME : PoolMember::myPool
       //	METHOD TYPE : PoolImpl
       //
+      namespace
+      {
+        /** The pool \ref PoolMember::myPool refers to on this thread (\c nullptr: the default pool). */
+        thread_local PoolImpl * _currentPool = nullptr;
+      }
+
       PoolImpl & PoolMember::myPool()
+      { return _currentPool ? *_currentPool : PoolImpl::defaultPool(); }
+
+      PoolImpl & PoolImpl::defaultPool()
       {
         static PoolImpl _global;
         return _global;
       }
 
+      PoolImpl * PoolImpl::makeCurrent( PoolImpl * pool_r )
+      {
+        PoolImpl * ret = _currentPool;
+        _currentPool = pool_r;
+        return ret;
+      }
+
+      IdType constStr2id( const char * str_r )
+      { return PoolMember::myPool().constStr2id( str_r ); }
+
+      void PoolImpl::adoptIds( PoolImpl & other_r )
+      {
+        std::lock_guard<std::mutex> guard( other_r._idsMutex );
+        CPool * other = other_r._pool;
+        for ( IdType id = _pool->ss.nstrings; id < other->ss.nstrings; ++id )
+          ::pool_str2id( _pool, ::pool_id2str( other, id ), /*create*/true );
+        for ( IdType id = _pool->nrels; id < other->nrels; ++id )
+        {
+          const ::Reldep & rd( other->rels[id] );
+          ::pool_rel2id( _pool, rd.name, rd.evr, rd.flags, /*create*/true );
+        }
+        if ( _pool->ss.nstrings != other->ss.nstrings || _pool->nrels != other->nrels )
+          WAR << "Ids differ from the adopted pool: " << _pool->ss.nstrings << "/" << other->ss.nstrings
+              << " strings, " << _pool->nrels << "/" << other->nrels << " relations" << endl;
+        _adoptedStrings = other->ss.nstrings;
+      }
+
+      IdType PoolImpl::constStr2id( const char * str_r )
+      {
+        if ( ! _adoptedStrings )
+          return str2id( str_r, ::strlen( str_r ) );
+
+        IdType ret = ::pool_str2id( _pool, str_r, /*create*/false );
+        if ( ! ret || ret >= _adoptedStrings )
+          ZYPP_THROW( Exception( str::Str() << "Constant string not adopted from the default pool: " << str_r ) );
+        return ret;
+      }
+
       ///////////////////////////////////////////////////////////////////
       //
       //	METHOD NAME : PoolImpl::PoolImpl
@@ -188,6 +238,7 @@ namespace zypp
       //
       PoolImpl::PoolImpl()
       : _pool( ::pool_create() )
+      , _sysconfigFile( sysconfigStoragePath(), WatchFile::NO_INIT )
       {
         MIL << "Creating sat-pool." << endl;
         if ( ! _pool )
@@ -233,6 +284,7 @@ namespace zypp
 
       void PoolImpl::setDirty( const char * a1, const char * a2, const char * a3 )
       {
+        assertNotFrozen( a1 ? a1 : __FUNCTION__ );
         if ( a1 )
         {
           if      ( a3 ) MIL << a1 << " " << a2 << " " << a3 << endl;
@@ -249,6 +301,7 @@ namespace zypp
 
       void PoolImpl::localeSetDirty( const char * a1, const char * a2, const char * a3 )
       {
+        assertNotFrozen( a1 ? a1 : __FUNCTION__ );
         if ( a1 )
         {
           if      ( a3 ) MIL << a1 << " " << a2 << " " << a3 << endl;
@@ -261,20 +314,23 @@ namespace zypp
 
       void PoolImpl::depSetDirty( const char * a1, const char * a2, const char * a3 )
       {
+        assertNotFrozen( a1 ? a1 : __FUNCTION__ );
         if ( a1 )
         {
           if      ( a3 ) MIL << a1 << " " << a2 << " " << a3 << endl;
           else if ( a2 ) MIL << a1 << " " << a2 << endl;
           else           MIL << a1 << endl;
         }
+        _serialDeps.setDirty();
         ::pool_freewhatprovides( _pool );
       }
 
       void PoolImpl::prepare() const
       {
+        if ( _frozen )
+          return;	// prepared by freeze
 	// additional /etc/sysconfig/storage check:
-	static WatchFile sysconfigFile( sysconfigStoragePath(), WatchFile::NO_INIT );
-	if ( sysconfigFile.hasChanged() )
+	if ( _sysconfigFile.hasChanged() )
 	{
 	  _requiredFilesystemsPtr.reset(); // recreated on demand
 	  const_cast<PoolImpl*>(this)->depSetDirty( "/etc/sysconfig/storage change" );
@@ -301,6 +357,93 @@ namespace zypp
 
       ///////////////////////////////////////////////////////////////////
 
+      void PoolImpl::freeze()
+      {
+        if ( _frozen )
+        {
+          ++_frozen;
+          return;
+        }
+        debug::Measure m( "freeze" );
+
+        // Compute everything readers would otherwise compute on demand.
+        prepare();
+        _serial.serial();
+        for ( int i = 1; i < _pool->nrepos; ++i )
+        {
+          CRepo * repo = _pool->repos[i];
+          if ( ! repo )
+            continue;
+          int rdid;
+          ::Repodata * data;
+          FOR_REPODATAS( repo, rdid, data )
+          {
+            if ( data->state == REPODATA_STUB )
+              ::repodata_load( data );
+          }
+          ::repo_disable_paging( repo );
+        }
+        trackedLocaleIds();
+        getAvailableLocales();
+        multiversionList();
+        requiredFilesystems();
+        _needrebootSpec.contains( Solvable() );
+        if ( _evrRankWatcher.remember( _serial ) || _evrRanks.empty() )
+          buildEvrRanks();
+
+        // pool_createwhatprovides drops the string and relation hashes, the
+        // next lookup rebuilds them. Do it now, so lookups just read them.
+        // (The empty string is answered without looking at the hash.)
+        ::pool_str2id( _pool, "x", /*create*/false );
+        ::pool_rel2id( _pool, 1, 1, REL_EQ, /*create*/false );
+
+        // libsolvs temporary string buffers are reused round robin. Let them
+        // grow now, so the usual paths and dependencies fit without realloc.
+        for ( unsigned i = 0; i < 16; ++i )
+          ::pool_alloctmpspace( _pool, 4096 );
+
+        _frozen = 1;
+        MIL << "Pool frozen" << endl;
+      }
+
+      void PoolImpl::thaw()
+      {
+        if ( ! _frozen )
+          return;
+        if ( --_frozen == 0 )
+          MIL << "Pool thawed" << endl;
+      }
+
+      void PoolImpl::assertNotFrozen( const char * what_r ) const
+      {
+        if ( _frozen )
+          ZYPP_THROW( Exception( str::Str() << "Pool is frozen: " << what_r ) );
+      }
+
+      IdType PoolImpl::str2id( const char * str_r, unsigned len_r )
+      {
+        std::unique_lock<std::mutex> guard;
+        if ( ! _frozen )
+          guard = std::unique_lock<std::mutex>( _idsMutex );
+        IdType ret = ::pool_strn2id( _pool, str_r, len_r, /*create*/!_frozen );
+        if ( ! ret && str_r && _frozen )
+          assertNotFrozen( str_r );
+        return ret;
+      }
+
+      IdType PoolImpl::rel2id( IdType name_r, IdType evr_r, int flags_r )
+      {
+        std::unique_lock<std::mutex> guard;
+        if ( ! _frozen )
+          guard = std::unique_lock<std::mutex>( _idsMutex );
+        IdType ret = ::pool_rel2id( _pool, name_r, evr_r, flags_r, /*create*/!_frozen );
+        if ( ! ret && _frozen )
+          assertNotFrozen( "new relation" );
+        return ret;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+
       CRepo * PoolImpl::_createRepo( const std::string & name_r )
       {
         setDirty(__FUNCTION__, name_r.c_str() );
@@ -316,6 +459,10 @@ namespace zypp
 	if ( isSystemRepo( repo_r ) )
 	  _autoinstalled.clear();
         eraseRepoInfo( repo_r );
+        _solvLoadTimes.erase( repo_r );
+        _solvFiles.erase( repo_r );
+        _trigramIndexes.erase( repo_r );
+        _fileIndexes.erase( repo_r );
         ::repo_free( repo_r, /*resusePoolIDs*/false );
 	// If the last repo is removed clear the pool to actually reuse all IDs.
 	// NOTE: the explicit ::repo_free above asserts all solvables are memset(0)!
@@ -329,6 +476,7 @@ namespace zypp
       int PoolImpl::_addSolv( CRepo * repo_r, FILE * file_r )
       {
         setDirty(__FUNCTION__, repo_r->name );
+        _fileIndexes.erase( repo_r );
         int ret = ::repo_add_solv( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -338,6 +486,7 @@ namespace zypp
       int PoolImpl::_addHelix( CRepo * repo_r, FILE * file_r )
       {
         setDirty(__FUNCTION__, repo_r->name );
+        _fileIndexes.erase( repo_r );
         int ret = ::repo_add_helix( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -347,6 +496,7 @@ namespace zypp
       int PoolImpl::_addTesttags(CRepo *repo_r, FILE *file_r)
       {
         setDirty(__FUNCTION__, repo_r->name );
+        _fileIndexes.erase( repo_r );
         int ret = ::testcase_add_testtags( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -400,11 +550,13 @@ namespace zypp
       detail::SolvableIdType PoolImpl::_addSolvables( CRepo * repo_r, unsigned count_r )
       {
         setDirty(__FUNCTION__, repo_r->name );
+        _fileIndexes.erase( repo_r );
         return ::repo_add_solvable_block( repo_r, count_r );
       }
 
       void PoolImpl::setRepoInfo( RepoIdType id_r, const RepoInfo & info_r )
       {
+        assertNotFrozen( __FUNCTION__ );
         CRepo * repo( getRepo( id_r ) );
         if ( repo )
         {
@@ -433,10 +585,78 @@ namespace zypp
         _repoinfos[id_r] = info_r;
       }
 
+      shared_ptr<const TrigramIndex> PoolImpl::trigramIndex( RepoIdType id_r ) const
+      {
+        std::lock_guard<std::mutex> guard( _indexMutex );
+        auto it = _trigramIndexes.find( id_r );
+        if ( it == _trigramIndexes.end() )
+        {
+          shared_ptr<const TrigramIndex> idx;
+          auto file = _solvFiles.find( id_r );
+          if ( file != _solvFiles.end() && PathInfo( TrigramIndex::indexFile( file->second ) ).isFile() )
+          {
+            idx.reset( new TrigramIndex( file->second ) );
+            if ( ! *idx )
+              idx.reset();
+          }
+          it = _trigramIndexes.insert( std::make_pair( id_r, idx ) ).first;
+        }
+        // Offsets are relative to repo->start; anything added or removed
+        // after loading the solv file invalidates them.
+        if ( it->second && ( int(it->second->solvablesSize()) != id_r->nsolvables
+                             || unsigned(id_r->end - id_r->start) != it->second->solvablesSize() ) )
+          return nullptr;
+        return it->second;
+      }
+
+      void PoolImpl::buildEvrRanks() const
+      {
+        std::vector<IdType> evrs;
+        for ( SolvableIdType id = 2; id < SolvableIdType(_pool->nsolvables); ++id )
+        {
+          const CSolvable * s( _pool->solvables + id );
+          if ( s->repo && s->evr && ! ISRELDEP( s->evr ) )
+            evrs.push_back( s->evr );
+        }
+        std::sort( evrs.begin(), evrs.end() );
+        evrs.erase( std::unique( evrs.begin(), evrs.end() ), evrs.end() );
+        std::sort( evrs.begin(), evrs.end(), [this]( IdType lhs, IdType rhs ) {
+          return ::pool_evrcmp( _pool, lhs, rhs, EVRCMP_COMPARE ) < 0;
+        } );
+
+        _evrRanks.assign( _pool->ss.nstrings, 0 );
+        unsigned rank = 0;
+        for ( unsigned i = 0; i < evrs.size(); ++i )
+        {
+          // EVRs comparing equal (e.g. 1.0 and 1_0) share a rank
+          if ( i == 0 || ::pool_evrcmp( _pool, evrs[i-1], evrs[i], EVRCMP_COMPARE ) != 0 )
+            ++rank;
+          _evrRanks[evrs[i]] = rank;
+        }
+        DBG << "Ranked " << evrs.size() << " EVRs (" << rank << " distinct)" << endl;
+      }
+
+      shared_ptr<const FileIndex> PoolImpl::fileIndex( RepoIdType id_r ) const
+      {
+        std::lock_guard<std::mutex> guard( _indexMutex );
+        shared_ptr<const FileIndex> & ret( _fileIndexes[id_r] );
+        if ( ! ret )
+          ret.reset( new FileIndex( Repository( id_r ) ) );
+        return ret;
+      }
+
+      shared_ptr<const FileIndex> PoolImpl::cachedFileIndex( RepoIdType id_r ) const
+      {
+        std::lock_guard<std::mutex> guard( _indexMutex );
+        auto it = _fileIndexes.find( id_r );
+        return it == _fileIndexes.end() ? nullptr : it->second;
+      }
+
       ///////////////////////////////////////////////////////////////////
 
       void PoolImpl::setTextLocale( const Locale & locale_r )
       {
+	assertNotFrozen( __FUNCTION__ );
 	if ( ! locale_r )
 	{
 	  // We need one, so "en" is the last resort
@@ -462,6 +682,7 @@ namespace zypp
 
       void PoolImpl::initRequestedLocales( const LocaleSet & locales_r )
       {
+	assertNotFrozen( __FUNCTION__ );
 	if ( _requestedLocalesTracker.setInitial( locales_r ) )
 	{
 	  localeSetDirty( "initRequestedLocales" );
@@ -471,6 +692,7 @@ namespace zypp
 
       void PoolImpl::setRequestedLocales( const LocaleSet & locales_r )
       {
+	assertNotFrozen( __FUNCTION__ );
 	if ( _requestedLocalesTracker.set( locales_r ) )
 	{
 	  localeSetDirty( "setRequestedLocales" );
@@ -480,6 +702,7 @@ namespace zypp
 
       bool PoolImpl::addRequestedLocale( const Locale & locale_r )
       {
+	assertNotFrozen( __FUNCTION__ );
 	bool done = _requestedLocalesTracker.add( locale_r );
         if ( done )
         {
@@ -491,6 +714,7 @@ namespace zypp
 
       bool PoolImpl::eraseRequestedLocale( const Locale & locale_r )
       {
+	assertNotFrozen( __FUNCTION__ );
 	bool done = _requestedLocalesTracker.remove( locale_r );
         if ( done )
         {
@@ -616,7 +840,7 @@ namespace zypp
       }
 
       void PoolImpl::multiversionSpecChanged()
-      { _multiversionListPtr.reset(); }
+      { assertNotFrozen( __FUNCTION__ ); _multiversionListPtr.reset(); }
 
       const PoolImpl::MultiversionList & PoolImpl::multiversionList() const
       {
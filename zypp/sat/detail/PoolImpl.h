@@ -20,14 +20,18 @@ extern "C"
 #include <solv/repo_solv.h>
 }
 #include <iosfwd>
+#include <atomic>
+#include <mutex>
 
 #include <zypp/base/Hash.h>
 #include <zypp/base/NonCopyable.h>
 #include <zypp/base/SerialNumber.h>
 #include <zypp/base/SetTracker.h>
+#include <zypp/base/WatchFile.h>
 #include <zypp/sat/detail/PoolMember.h>
 #include <zypp/sat/SolvableSpec.h>
 #include <zypp/sat/Queue.h>
+#include <zypp/sat/TrigramIndex.h>
 #include <zypp/RepoInfo.h>
 #include <zypp/Locale.h>
 #include <zypp/Capability.h>
@@ -40,6 +44,7 @@ namespace zypp
   namespace sat
   { /////////////////////////////////////////////////////////////////
     class SolvableSet;
+    class FileIndex;
     ///////////////////////////////////////////////////////////////////
     namespace detail
     { /////////////////////////////////////////////////////////////////
@@ -58,6 +63,30 @@ namespace zypp
           /** Dtor */
           ~PoolImpl();
 
+        public:
+          /** The global pool (used unless a different one is \ref makeCurrent). */
+          static PoolImpl & defaultPool();
+
+          /** Let \ref PoolMember::myPool refer to \a pool_r on this thread (\c nullptr: the \ref defaultPool).
+           * Returns the previous one.
+           * \see \ref PoolContext
+           */
+          static PoolImpl * makeCurrent( PoolImpl * pool_r );
+
+          /** Intern the strings and relations of \a other_r, so this (new) pool assigns them the same ids.
+           * Ids kept in static data (e.g. \ref ResKind or \ref Arch constants) remain valid this way.
+           */
+          void adoptIds( PoolImpl & other_r );
+
+          /** Id of a string constant kept in a namespace scope static.
+           * Those are initialized at load time, so the string is interned
+           * into the default pool before any \ref PoolContext adopts its ids.
+           * In a pool which adopted its ids, a string not adopted from the
+           * default pool throws (e.g. if used in a function-local static
+           * first initialized in a context).
+           */
+          IdType constStr2id( const char * str_r );
+
           /** Pointer style access forwarded to sat-pool. */
           CPool * operator->()
           { return _pool; }
@@ -71,11 +100,49 @@ namespace zypp
           const SerialNumber & serialIDs() const
           { return _serialIDs; }
 
+          /** Serial number changing whenever dependency/namespace related indices are invalidated (\ref depSetDirty). */
+          const SerialNumber & serialDeps() const
+          { return _serialDeps; }
+
           /** Update housekeeping data (e.g. whatprovides).
            * \todo actually requires a watcher.
            */
           void prepare() const;
 
+        public:
+          /** \name Frozen pool.
+           * \see \ref Pool::freeze
+           */
+          //@{
+          /** Prepare the pool for concurrent readers and reject changes until the last \ref thaw. */
+          void freeze();
+
+          /** Undo one \ref freeze. */
+          void thaw();
+
+          /** Whether the pool is frozen. */
+          bool frozen() const
+          { return _frozen; }
+
+          /** While frozen, serializes the few libsolv calls which compute data on demand. */
+          std::unique_lock<std::mutex> frozenLock() const
+          { return _frozen ? std::unique_lock<std::mutex>( _frozenMutex ) : std::unique_lock<std::mutex>(); }
+
+          /** Id of the string \a str_r (of length \a len_r), created if new.
+           * A frozen pool rejects new strings.
+           */
+          IdType str2id( const char * str_r, unsigned len_r );
+
+          /** Id of the relation \a name_r \a flags_r \a evr_r, created if new.
+           * A frozen pool rejects new relations.
+           */
+          IdType rel2id( IdType name_r, IdType evr_r, int flags_r );
+          //@}
+
+        private:
+          /** Throw if the pool is frozen. */
+          void assertNotFrozen( const char * what_r ) const;
+
         private:
           /** Invalidate housekeeping data (e.g. whatprovides) if the
            *  pools content changed.
@@ -113,6 +180,7 @@ namespace zypp
 	  /** Set rootdir (for file conflicts check) */
 	  void rootDir( const Pathname & root_r )
 	  {
+	    assertNotFrozen( __FUNCTION__ );
 	    if ( root_r.empty() || root_r == "/" )
 	      ::pool_set_rootdir( _pool, nullptr );
 	    else
@@ -209,13 +277,60 @@ namespace zypp
 
         public:
           /** */
-          const RepoInfo & repoInfo( RepoIdType id_r )
-          { return _repoinfos[id_r]; }
+          const RepoInfo & repoInfo( RepoIdType id_r ) const
+          { auto it = _repoinfos.find( id_r ); return it == _repoinfos.end() ? RepoInfo::noRepo : it->second; }
           /** Also adjust repo priority and subpriority accordingly. */
           void setRepoInfo( RepoIdType id_r, const RepoInfo & info_r );
           /** */
           void eraseRepoInfo( RepoIdType id_r )
-          { _repoinfos.erase( id_r ); }
+          { assertNotFrozen( __FUNCTION__ ); _repoinfos.erase( id_r ); }
+
+          /** Time (ms) spent in the last \ref _addSolv for this repo. */
+          unsigned solvLoadTime( RepoIdType id_r ) const
+          { auto it = _solvLoadTimes.find( id_r ); return it == _solvLoadTimes.end() ? 0 : it->second; }
+          /** */
+          void setSolvLoadTime( RepoIdType id_r, unsigned ms_r )
+          { assertNotFrozen( __FUNCTION__ ); _solvLoadTimes[id_r] = ms_r; }
+
+          /** Remember the solv file loaded into this repo (for \ref trigramIndex). */
+          void setSolvFile( RepoIdType id_r, const Pathname & file_r )
+          {
+            assertNotFrozen( __FUNCTION__ );
+            std::lock_guard<std::mutex> guard( _indexMutex );
+            _solvFiles[id_r] = file_r;
+            _trigramIndexes.erase( id_r );
+          }
+          /** The \ref TrigramIndex of the repos solv file, if one exists and still fits the repo content (loaded on demand). */
+          shared_ptr<const TrigramIndex> trigramIndex( RepoIdType id_r ) const;
+
+          /** The repos \ref FileIndex (built on demand, dropped when solvables are added to the repo). */
+          shared_ptr<const FileIndex> fileIndex( RepoIdType id_r ) const;
+
+          /** The repos \ref FileIndex if it was already built (\c nullptr otherwise). */
+          shared_ptr<const FileIndex> cachedFileIndex( RepoIdType id_r ) const;
+
+        public:
+          /** Sort rank of the EVR string \a id_r among all solvables EVRs (\c 0 if unknown).
+           * Equal ranks compare equal, so two known EVRs can be compared as integers.
+           * The ranks are computed on demand, once the pool content is stable for a
+           * while (i.e. after a number of compares since the last change), and are
+           * discarded on any pool content change.
+           */
+          unsigned evrRank( IdType id_r ) const
+          {
+            if ( _evrRankWatcher.remember( _serial ) )
+            {
+              _evrRanks.clear();
+              _evrRankMisses = 0;
+            }
+            if ( _evrRanks.empty() )
+            {
+              if ( _frozen || ++_evrRankMisses < 1000 )
+                return 0;
+              buildEvrRanks();
+            }
+            return( unsigned(id_r) < _evrRanks.size() ? _evrRanks[id_r] : 0 );
+          }
 
         public:
           /** Returns the id stored at \c offset_r in the internal
@@ -306,7 +421,7 @@ namespace zypp
 
 	  /** Set ident list of all autoinstalled solvables. */
 	  void setAutoInstalled( const StringQueue & autoInstalled_r )
-	  { _autoinstalled = autoInstalled_r; }
+	  { assertNotFrozen( __FUNCTION__ ); _autoinstalled = autoInstalled_r; }
 
           bool isOnSystemByUser( IdString ident_r ) const
           { return !_autoinstalled.contains( ident_r.id() ); }
@@ -321,6 +436,7 @@ namespace zypp
           /** Set new Solvable specs.*/
           void setNeedrebootSpec( sat::SolvableSpec needrebootSpec_r )
 	  {
+	    assertNotFrozen( __FUNCTION__ );
 	    _needrebootSpec = std::move(needrebootSpec_r);
 	    _needrebootSpec.setDirty();
 	  }
@@ -341,10 +457,27 @@ namespace zypp
           SerialNumber _serial;
           /** Serial number of IDs - changes whenever resusePoolIDs==true - ResPool must also invalidate it's PoolItems! */
           SerialNumber _serialIDs;
+          /** Serial number of dependency/namespace related indices - changes with each \ref depSetDirty. */
+          SerialNumber _serialDeps;
           /** Watch serial number. */
           SerialNumberWatcher _watcher;
           /** Additional \ref RepoInfo. */
           std::map<RepoIdType,RepoInfo> _repoinfos;
+          /**  */
+          std::map<RepoIdType,unsigned> _solvLoadTimes;
+          /**  */
+          std::map<RepoIdType,Pathname> _solvFiles;
+          /** Loaded on demand; \c nullptr if not available. */
+          mutable std::map<RepoIdType,shared_ptr<const TrigramIndex>> _trigramIndexes;
+          /** Built on demand. */
+          mutable std::map<RepoIdType,shared_ptr<const FileIndex>> _fileIndexes;
+          /** Guards \ref _trigramIndexes and \ref _fileIndexes. */
+          mutable std::mutex _indexMutex;
+          /** \ref evrRank per string Id. */
+          mutable std::vector<unsigned> _evrRanks;
+          mutable SerialNumberWatcher _evrRankWatcher;
+          mutable unsigned _evrRankMisses = 0;
+          void buildEvrRanks() const;
 
           /**  */
 	  base::SetTracker<LocaleSet> _requestedLocalesTracker;
@@ -364,6 +497,16 @@ namespace zypp
 
 	  /** filesystems mentioned in /etc/sysconfig/storage */
 	  mutable scoped_ptr<std::set<std::string> > _requiredFilesystemsPtr;
+	  mutable WatchFile _sysconfigFile;
+
+          /** Number of active \ref freeze. */
+          std::atomic<unsigned> _frozen { 0 };
+          mutable std::mutex _frozenMutex;
+
+          /** Serializes interning with \ref adoptIds reading the ids. */
+          std::mutex _idsMutex;
+          /** Number of strings adopted by \ref adoptIds. */
+          IdType _adoptedStrings = 0;
       };
       ///////////////////////////////////////////////////////////////////
 
@@ -119,6 +119,11 @@ namespace zypp
       inline bool isDepMarkerId( IdType id_r )
       { return( id_r == solvablePrereqMarker || id_r == solvableFileMarker ); }
 
+      /** Id of a string constant kept in a namespace scope static.
+       * \see \ref PoolImpl::constStr2id
+       */
+      IdType constStr2id( const char * str_r );
+
       /** Id type to connect \ref Solvable and sat-solvable.
        * Indext into solvable array.
       */
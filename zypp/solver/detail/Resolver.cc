@@ -19,6 +19,8 @@
  * 02111-1307, USA.
  */
 #include <boost/static_assert.hpp>
+#include <unordered_map>
+#include <unordered_set>
 
 #define ZYPP_USE_RESOLVER_INTERNALS
 
@@ -33,6 +35,8 @@
 #include <zypp/solver/detail/SolverQueueItem.h>
 
 #include <zypp/ZConfig.h>
+#include <zypp/pool/StatusStore.h>
+#include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/sat/Transaction.h>
 
 #define MAXSOLVERRUNS 5
@@ -67,6 +71,8 @@ std::ostream & Resolver::dumpOn( std::ostream & os ) const
   OUTS( _onlyRequires );
   OUTS( _solveSrcPackages );
   OUTS( _cleandepsOnRemove );
+  OUTS( _incrementalSolve );
+  OUTS( _resultCachePath );
   OUTS( _ignoreAlreadyRecommended );
   #undef OUT
   return os << "<resolver/>";
@@ -85,7 +91,10 @@ Resolver::Resolver (const ResPool & pool)
     , _onlyRequires		( ZConfig::instance().solver_onlyRequires() )
     , _solveSrcPackages		( false )
     , _cleandepsOnRemove	( ZConfig::instance().solver_cleandepsOnRemove() )
+    , _incrementalSolve		( false )
+    , _resultCachePath		( ZConfig::instance().solver_resultCachePath() )
     , _ignoreAlreadyRecommended	( true )
+    , _resolverInfoCollected	( false )
 {
     sat::Pool satPool( sat::Pool::instance() );
     _satResolver = new SATResolver(_pool, satPool.get());
@@ -150,12 +159,14 @@ void Resolver::reset( bool keepExtras )
     if (!keepExtras) {
       _extra_requires.clear();
       _extra_conflicts.clear();
+      _extra_installIdents.clear();
     }
 
     _isInstalledBy.clear();
     _installs.clear();
     _satifiedByInstalled.clear();
     _installedSatisfied.clear();
+    _resolverInfoCollected = false;
 }
 
 bool Resolver::doUpgrade()
@@ -186,6 +197,58 @@ void Resolver::addExtraConflict( const Capability & capability )
 void Resolver::removeExtraConflict( const Capability & capability )
 { _extra_conflicts.erase (capability); }
 
+std::vector<std::string> Resolver::addExtraInstallSpecs( const std::vector<std::string> & specs_r )
+{
+    // The ident of each spec (noId if unknown to the pool). Names (also those
+    // in 'provides:' specs) are looked up without creating them, so unknown
+    // names don't grow a (maybe frozen) pool.
+    std::vector<sat::detail::IdType> specIdents( specs_r.size(), sat::detail::noId );
+    // requested idents (true once found)
+    std::unordered_map<sat::detail::IdType,bool> idents;
+    std::vector<bool> known( specs_r.size(), false );
+
+    for ( unsigned i = 0; i < specs_r.size(); ++i ) {
+	const std::string & spec( specs_r[i] );
+	if ( str::hasPrefix( spec, "provides:" ) ) {
+	    Capability cap( Capability::lookup( spec.substr( 9 ) ) );
+	    if ( cap && ! sat::WhatProvides( cap ).empty() ) {
+		_extra_requires.insert( cap );
+		known[i] = true;
+	    }
+	}
+	else if ( spec.empty() )
+	    known[i] = true;
+	else {
+	    specIdents[i] = ::pool_str2id( sat::Pool::instance().get(), spec.c_str(), /*create*/false );
+	    if ( specIdents[i] != sat::detail::noId )
+		idents.emplace( specIdents[i], false );
+	}
+    }
+
+    // a single pass over the pool looking up all idents
+    if ( ! idents.empty() ) {
+	unsigned todo = idents.size();
+	for ( const sat::Solvable & solv : sat::Pool::instance().solvables() ) {
+	    auto it = idents.find( solv.ident().id() );
+	    if ( it != idents.end() && ! it->second && ! solv.isKind( ResKind::srcpackage ) ) {
+		_extra_installIdents.insert( IdString( it->first ) );
+		it->second = true;
+		if ( --todo == 0 )
+		    break;
+	    }
+	}
+    }
+
+    std::vector<std::string> unknown;
+    for ( unsigned i = 0; i < specs_r.size(); ++i ) {
+	if ( ! known[i] && ! ( specIdents[i] != sat::detail::noId && idents[specIdents[i]] ) )
+	    unknown.push_back( specs_r[i] );
+    }
+
+    MIL << "Install specs: " << specs_r.size() << " (" << unknown.size() << " unknown)" << endl;
+    return unknown;
+}
+
 void Resolver::removeQueueItem( SolverQueueItem_Ptr item )
 {
     bool found = false;
@@ -225,21 +288,6 @@ void Resolver::addWeak( const PoolItem & item )
 
 //---------------------------------------------------------------------------
 
-struct UndoTransact : public resfilter::PoolItemFilterFunctor
-{
-    ResStatus::TransactByValue resStatus;
-    UndoTransact ( const ResStatus::TransactByValue &status)
-	:resStatus(status)
-    { }
-
-    bool operator()( PoolItem item )		// only transacts() items go here
-    {
-	item.status().resetTransact( resStatus );// clear any solver/establish transactions
-	return true;
-    }
-};
-
-
 struct DoTransact : public resfilter::PoolItemFilterFunctor
 {
     ResStatus::TransactByValue resStatus;
@@ -257,15 +305,11 @@ struct DoTransact : public resfilter::PoolItemFilterFunctor
 
 bool Resolver::verifySystem()
 {
-    UndoTransact resetting (ResStatus::APPL_HIGH);
-
     DBG << "Resolver::verifySystem()" << endl;
 
     _verifying = true;
 
-    invokeOnEach ( _pool.begin(), _pool.end(),
-		   resfilter::ByTransact( ),			// Resetting all transcations
-		   functor::functorRef<bool,PoolItem>(resetting) );
+    _pool.statusStore().resetTransact( ResStatus::APPL_HIGH );	// Resetting all transcations
 
     return resolvePool();
 }
@@ -275,11 +319,8 @@ bool Resolver::verifySystem()
 // undo
 void Resolver::undo()
 {
-    UndoTransact info(ResStatus::APPL_LOW);
     MIL << "*** undo ***" << endl;
-    invokeOnEach ( _pool.begin(), _pool.end(),
-		   resfilter::ByTransact( ),			// collect transacts from Pool to resolver queue
-		   functor::functorRef<bool,PoolItem>(info) );
+    _pool.statusStore().resetTransact( ResStatus::APPL_LOW );	// clear any solver/establish transactions
     //  Regard dependencies of the item weak onl
     _addWeak.clear();
 
@@ -311,6 +352,8 @@ void Resolver::solverInit()
     _satResolver->setUpdatesystem		(_updateMode);
     _satResolver->setSolveSrcPackages		( solveSrcPackages() );
     _satResolver->setCleandepsOnRemove		( cleandepsOnRemove() );
+    _satResolver->setIncrementalSolve		( incrementalSolve() );
+    _satResolver->setResultCachePath		( resultCachePath() );
 
     _satResolver->setDistupgrade		(_upgradeMode);
     if (_upgradeMode) {
@@ -323,12 +366,25 @@ void Resolver::solverInit()
     _installs.clear();
     _satifiedByInstalled.clear();
     _installedSatisfied.clear();
+    _resolverInfoCollected = false;
+}
+
+void Resolver::solverFailed()
+{
+    const char * dir = getenv("ZYPP_SOLVER_FAILURE_TESTCASE");
+    if ( dir && *dir ) {
+	Testcase testcase( dir );
+	testcase.createArchive( *this, false );
+    }
 }
 
 bool Resolver::resolvePool()
 {
     solverInit();
-    return _satResolver->resolvePool(_extra_requires, _extra_conflicts, _addWeak, _upgradeRepos );
+    bool ret = _satResolver->resolvePool(_extra_requires, _extra_conflicts, _extra_installIdents, _addWeak, _upgradeRepos );
+    if ( ! ret )
+	solverFailed();
+    return ret;
 }
 
 bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
@@ -367,9 +423,15 @@ bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
     _removed_queue_items.clear();
     _added_queue_items.clear();
 
-    return _satResolver->resolveQueue(queue, _addWeak);
+    bool ret = _satResolver->resolveQueue(queue, _addWeak);
+    if ( ! ret )
+	solverFailed();
+    return ret;
 }
 
+const ResolverStatistics & Resolver::statistics() const
+{ return _satResolver->statistics(); }
+
 sat::Transaction Resolver::getTransaction()
 {
   // FIXME: That's an ugly way of pushing autoInstalled into the transaction.
@@ -415,149 +477,103 @@ bool Resolver::applySolution( const ProblemSolution & solution )
 
 //----------------------------------------------------------------------------
 
+namespace
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class ResolverInfoCollector
+  /// \brief Fill the \ref Resolver's ItemCapKindMaps.
+  ///
+  /// Whether an item is already known to be installed by another one is
+  /// looked up in a hash of (installed, by) pairs, instead of scanning
+  /// all entries of the installed item (which was quadratic for items
+  /// required by many others).
+  ///////////////////////////////////////////////////////////////////
+  class ResolverInfoCollector
+  {
+  public:
+    ResolverInfoCollector( ItemCapKindMap & isInstalledBy_r, ItemCapKindMap & installs_r,
+			   ItemCapKindMap & satifiedByInstalled_r, ItemCapKindMap & installedSatisfied_r )
+    : _isInstalledBy( isInstalledBy_r )
+    , _installs( installs_r )
+    , _satifiedByInstalled( satifiedByInstalled_r )
+    , _installedSatisfied( installedSatisfied_r )
+    {}
+
+    /** \a item_r REQUIRES or RECOMMENDS \a cap_r: relate \a item_r to its providers. */
+    void requirement( const PoolItem & item_r, const Capability & cap_r, Dep kind_r )
+    {
+      for ( const sat::Solvable & solv : sat::WhatProvides( cap_r ) )
+      {
+	PoolItem provider( ResPool::instance().find( solv ) );
+	relate( provider, item_r, cap_r, kind_r );
+
+	if ( provider.status().staysInstalled() ) { // Is already satisfied by an item which is installed
+	  _satifiedByInstalled.insert( make_pair( item_r, ItemCapKind( provider, cap_r, kind_r, false ) ) );
+	  _installedSatisfied.insert( make_pair( provider, ItemCapKind( item_r, cap_r, kind_r, false ) ) );
+	}
+      }
+    }
+
+    /** \a item_r SUPPLEMENTS \a cap_r: relate the providers to \a item_r. */
+    void supplement( const PoolItem & item_r, const Capability & cap_r )
+    {
+      for ( const sat::Solvable & solv : sat::WhatProvides( cap_r ) )
+      {
+	PoolItem provider( ResPool::instance().find( solv ) );
+	bool alreadySetForInstallation = relate( item_r, provider, cap_r, Dep::SUPPLEMENTS );
+
+	if ( item_r.status().staysInstalled() ) { // Is already satisfied by an item which is installed
+	  _satifiedByInstalled.insert( make_pair( provider, ItemCapKind( item_r, cap_r, Dep::SUPPLEMENTS, !alreadySetForInstallation ) ) );
+	  _installedSatisfied.insert( make_pair( item_r, ItemCapKind( provider, cap_r, Dep::SUPPLEMENTS, false ) ) );
+	}
+      }
+    }
+
+  private:
+    /** Remember \a installed_r is installed by \a by_r (unless already known).
+     * \returns whether \a installed_r was already known to be installed by some item.
+     */
+    bool relate( const PoolItem & installed_r, const PoolItem & by_r, const Capability & cap_r, Dep kind_r )
+    {
+      bool alreadySetForInstallation = _isInstalledBy.find( installed_r ) != _isInstalledBy.end();
+      if ( ! installed_r.status().isToBeInstalled() )
+	return alreadySetForInstallation;
+      if ( ! _known.insert( ( uint64_t(installed_r.id()) << 32 ) | uint32_t(by_r.id()) ).second )
+	return alreadySetForInstallation;	// found
+
+      // no initial installation if it has been set be e.g. user
+      bool initial = installed_r.status().isBySolver() && !alreadySetForInstallation;
+      _isInstalledBy.insert( make_pair( installed_r, ItemCapKind( by_r, cap_r, kind_r, initial ) ) );
+      _installs.insert( make_pair( by_r, ItemCapKind( installed_r, cap_r, kind_r, !alreadySetForInstallation ) ) );
+      return alreadySetForInstallation;
+    }
+
+  private:
+    ItemCapKindMap & _isInstalledBy;
+    ItemCapKindMap & _installs;
+    ItemCapKindMap & _satifiedByInstalled;
+    ItemCapKindMap & _installedSatisfied;
+    std::unordered_set<uint64_t> _known;	///< (installed,by) pairs in _isInstalledBy
+  };
+} // namespace
+
 void Resolver::collectResolverInfo()
 {
-    if ( _satResolver
-	 && _isInstalledBy.empty()
-	 && _installs.empty()) {
-
-	// generating new
-	PoolItemList itemsToInstall = _satResolver->resultItemsToInstall();
-
-	for (PoolItemList::const_iterator instIter = itemsToInstall.begin();
-	     instIter != itemsToInstall.end(); instIter++) {
-	    // Requires
-	    for (Capabilities::const_iterator capIt = (*instIter)->dep (Dep::REQUIRES).begin(); capIt != (*instIter)->dep (Dep::REQUIRES).end(); ++capIt)
-	    {
-		sat::WhatProvides possibleProviders(*capIt);
-		for_( iter, possibleProviders.begin(), possibleProviders.end() ) {
-		    PoolItem provider = ResPool::instance().find( *iter );
-
-		    // searching if this provider will already be installed
-		    bool found = false;
-		    bool alreadySetForInstallation = false;
-		    ItemCapKindMap::const_iterator pos = _isInstalledBy.find(provider);
-		    while (pos != _isInstalledBy.end()
-			   && pos->first == provider
-			   && !found) {
-			alreadySetForInstallation = true;
-			ItemCapKind capKind = pos->second;
-			if (capKind.item() == *instIter)  found = true;
-			pos++;
-		    }
-
-		    if (!found
-			&& provider.status().isToBeInstalled()) {
-			if (provider.status().isBySolver()) {
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::REQUIRES, !alreadySetForInstallation );
-			    _isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			} else {
-			    // no initial installation cause it has been set be e.g. user
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::REQUIRES, false );
-			    _isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			}
-			ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::REQUIRES, !alreadySetForInstallation );
-			_installs.insert (make_pair( *instIter, capKindisInstalledBy));
-		    }
-
-		    if (provider.status().staysInstalled()) { // Is already satisfied by an item which is installed
-			ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::REQUIRES, false );
-			_satifiedByInstalled.insert (make_pair( *instIter, capKindisInstalledBy));
-
-			ItemCapKind installedSatisfied( *instIter, *capIt, Dep::REQUIRES, false );
-			_installedSatisfied.insert (make_pair( provider, installedSatisfied));
-		    }
-		}
-	    }
+    if ( ! _satResolver || _resolverInfoCollected )
+	return;
+    _resolverInfoCollected = true;	// until the next solver run
 
-	    if (!(_satResolver->onlyRequires())) {
-		//Recommends
-		for (Capabilities::const_iterator capIt = (*instIter)->dep (Dep::RECOMMENDS).begin(); capIt != (*instIter)->dep (Dep::RECOMMENDS).end(); ++capIt)
-		{
-		    sat::WhatProvides possibleProviders(*capIt);
-		    for_( iter, possibleProviders.begin(), possibleProviders.end() ) {
-			PoolItem provider = ResPool::instance().find( *iter );
-
-			// searching if this provider will already be installed
-			bool found = false;
-			bool alreadySetForInstallation = false;
-			ItemCapKindMap::const_iterator pos = _isInstalledBy.find(provider);
-			while (pos != _isInstalledBy.end()
-			       && pos->first == provider
-			       && !found) {
-			    alreadySetForInstallation = true;
-			    ItemCapKind capKind = pos->second;
-			    if (capKind.item() == *instIter)  found = true;
-			    pos++;
-			}
-
-			if (!found
-			    && provider.status().isToBeInstalled()) {
-			    if (provider.status().isBySolver()) {
-				ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::RECOMMENDS, !alreadySetForInstallation );
-				_isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			    } else {
-				// no initial installation cause it has been set be e.g. user
-				ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::RECOMMENDS, false );
-				_isInstalledBy.insert (make_pair( provider, capKindisInstalledBy));
-			    }
-			    ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::RECOMMENDS, !alreadySetForInstallation );
-			    _installs.insert (make_pair( *instIter, capKindisInstalledBy));
-			}
-
-			if (provider.status().staysInstalled()) { // Is already satisfied by an item which is installed
-			    ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::RECOMMENDS, false );
-			    _satifiedByInstalled.insert (make_pair( *instIter, capKindisInstalledBy));
-
-			    ItemCapKind installedSatisfied( *instIter, *capIt, Dep::RECOMMENDS, false );
-			    _installedSatisfied.insert (make_pair( provider, installedSatisfied));
-			}
-		    }
-		}
-
-		//Supplements
-		for (Capabilities::const_iterator capIt = (*instIter)->dep (Dep::SUPPLEMENTS).begin(); capIt != (*instIter)->dep (Dep::SUPPLEMENTS).end(); ++capIt)
-		{
-		    sat::WhatProvides possibleProviders(*capIt);
-		    for_( iter, possibleProviders.begin(), possibleProviders.end() ) {
-			PoolItem provider = ResPool::instance().find( *iter );
-			// searching if this item will already be installed
-			bool found = false;
-			bool alreadySetForInstallation = false;
-			ItemCapKindMap::const_iterator pos = _isInstalledBy.find(*instIter);
-			while (pos != _isInstalledBy.end()
-			       && pos->first == *instIter
-			       && !found) {
-			    alreadySetForInstallation = true;
-			    ItemCapKind capKind = pos->second;
-			    if (capKind.item() == provider)  found = true;
-			    pos++;
-			}
-
-			if (!found
-			    && instIter->status().isToBeInstalled()) {
-			    if (instIter->status().isBySolver()) {
-				ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::SUPPLEMENTS, !alreadySetForInstallation );
-				_isInstalledBy.insert (make_pair( *instIter, capKindisInstalledBy));
-			    } else {
-				// no initial installation cause it has been set be e.g. user
-				ItemCapKind capKindisInstalledBy( provider, *capIt, Dep::SUPPLEMENTS, false );
-				_isInstalledBy.insert (make_pair( *instIter, capKindisInstalledBy));
-			    }
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::SUPPLEMENTS, !alreadySetForInstallation );
-			    _installs.insert (make_pair( provider, capKindisInstalledBy));
-			}
-
-			if (instIter->status().staysInstalled()) { // Is already satisfied by an item which is installed
-			    ItemCapKind capKindisInstalledBy( *instIter, *capIt, Dep::SUPPLEMENTS, !alreadySetForInstallation );
-			    _satifiedByInstalled.insert (make_pair( provider, capKindisInstalledBy));
-
-			    ItemCapKind installedSatisfied( provider, *capIt, Dep::SUPPLEMENTS, false );
-			    _installedSatisfied.insert (make_pair( *instIter, installedSatisfied));
-			}
-		    }
-		}
-   	    }
+    ResolverInfoCollector collector( _isInstalledBy, _installs, _satifiedByInstalled, _installedSatisfied );
+    for ( const PoolItem & item : _satResolver->resultItemsToInstall() )
+    {
+	for ( const Capability & cap : item->dep( Dep::REQUIRES ) )
+	    collector.requirement( item, cap, Dep::REQUIRES );
+
+	if ( ! _satResolver->onlyRequires() ) {
+	    for ( const Capability & cap : item->dep( Dep::RECOMMENDS ) )
+		collector.requirement( item, cap, Dep::RECOMMENDS );
+	    for ( const Capability & cap : item->dep( Dep::SUPPLEMENTS ) )
+		collector.supplement( item, cap );
 	}
     }
 }
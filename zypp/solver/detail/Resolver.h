@@ -32,6 +32,8 @@
 
 #include <zypp/solver/Types.h>
 #include <zypp/base/SerialNumber.h>
+#include <zypp/Pathname.h>
+#include <zypp/ResolverStatistics.h>
 
 /////////////////////////////////////////////////////////////////////////
 namespace zypp
@@ -70,6 +72,7 @@ class Resolver : private base::NonCopyable
 
     CapabilitySet _extra_requires;
     CapabilitySet _extra_conflicts;
+    IdStringSet _extra_installIdents;
     std::set<Repository> _upgradeRepos;
 
     // Regard dependencies of the item weak onl
@@ -85,6 +88,8 @@ class Resolver : private base::NonCopyable
                                   // packages, hardware packages (modalias)
     bool _solveSrcPackages;	// whether to generate solver jobs for selected source packges.
     bool _cleandepsOnRemove;	// whether removing a package should also remove no longer needed requirements
+    bool _incrementalSolve;	// whether to keep the solver between runs
+    Pathname _resultCachePath;	// where to cache solver results (empty: disabled)
 
     bool _ignoreAlreadyRecommended;   //ignore recommended packages that have already been recommended by the installed packages
     //@}
@@ -99,6 +104,7 @@ class Resolver : private base::NonCopyable
     ItemCapKindMap _installs;
     ItemCapKindMap _satifiedByInstalled;
     ItemCapKindMap _installedSatisfied;
+    bool _resolverInfoCollected;	// whether the maps above are up to date
 
     // helpers
     void collectResolverInfo();
@@ -109,6 +115,8 @@ class Resolver : private base::NonCopyable
     bool checkUnmaintainedItems ();
 
     void solverInit();
+    /** Capture a testcase archive if \c ZYPP_SOLVER_FAILURE_TESTCASE is set. */
+    void solverFailed();
 
   public:
 
@@ -137,12 +145,15 @@ class Resolver : private base::NonCopyable
     void removeExtraRequire( const Capability & capability );
     void addExtraConflict( const Capability & capability );
     void removeExtraConflict( const Capability & capability );
+    std::vector<std::string> addExtraInstallSpecs( const std::vector<std::string> & specs_r );
+    void removeExtraInstallIdents()		{ _extra_installIdents.clear(); }
 
     void removeQueueItem( SolverQueueItem_Ptr item );
     void addQueueItem( SolverQueueItem_Ptr item );
 
     CapabilitySet extraRequires() const		{ return _extra_requires; }
     CapabilitySet extraConflicts() const	{ return _extra_conflicts; }
+    const IdStringSet & extraInstallIdents() const { return _extra_installIdents; }
 
     void addWeak( const PoolItem & item );
 
@@ -176,6 +187,12 @@ class Resolver : private base::NonCopyable
 
     bool cleandepsOnRemove() const 		{ return _cleandepsOnRemove; }
     void setCleandepsOnRemove( TriBool state_r );
+
+    bool incrementalSolve() const 		{ return _incrementalSolve; }
+    void setIncrementalSolve( TriBool state_r )	{ _incrementalSolve = indeterminate(state_r) ? false : bool(state_r); }
+
+    const Pathname & resultCachePath() const	{ return _resultCachePath; }
+    void setResultCachePath( const Pathname & path_r ) { _resultCachePath = path_r; }
     //@}
 
     void setFocus( ResolverFocus focus_r );
@@ -207,6 +224,8 @@ class Resolver : private base::NonCopyable
     // Return the Transaction computed by the last solver run.
     sat::Transaction getTransaction();
 
+    const ResolverStatistics & statistics() const;
+
     // reset all SOLVER transaction in pool
     void undo();
 
@@ -0,0 +1,318 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/solver/detail/ResultCache.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/solver.h>
+#include <solv/solvversion.h>
+#include <solv/testcase.h>
+}
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#define ZYPP_USE_RESOLVER_INTERNALS
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/Digest.h>
+#include <zypp/PathInfo.h>
+#include <zypp/Repository.h>
+#include <zypp/VendorAttr.h>
+#include <zypp/ZConfig.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/target/modalias/Modalias.h>
+
+#include <zypp/solver/detail/ResultCache.h>
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::solver"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp::solver::detail
+{
+  namespace
+  {
+    const std::string entryHeader { "zypp-resolver-result 1" };
+
+    /** Repo alias, priorities and content. */
+    void digestRepo( std::ostream & str, const Repository & repo_r )
+    {
+      ::Repo * repo { repo_r.get() };
+      str << "repo " << repo_r.alias() << ' ' << repo->priority << ' ' << repo->subpriority
+          << ' ' << repo_r.solvablesSize() << ' ' << repo_r.isSystemRepo() << endl;
+
+      if ( Date generated = repo_r.generatedTimestamp() )
+      {
+        str << "generated " << Date::ValueType(generated) << endl;
+        return;
+      }
+      // no solv file cookie: use the content
+      for ( const sat::Solvable & slv : repo_r.solvables() )
+        str << slv.ident() << ' ' << slv.edition() << ' ' << slv.arch() << ' ' << slv.vendor() << ' ' << Date::ValueType(slv.buildtime()) << endl;
+    }
+
+    /** A solver job independent of the pools Ids. */
+    void digestJob( std::ostream & str, sat::detail::CPool * satPool_r, sat::detail::IdType how_r, sat::detail::IdType what_r )
+    {
+      str << "job " << how_r;
+      switch ( how_r & SOLVER_SELECTMASK )
+      {
+        case SOLVER_SOLVABLE:
+          str << ' ' << ::testcase_solvid2str( satPool_r, what_r );
+          break;
+        case SOLVER_SOLVABLE_NAME:
+        case SOLVER_SOLVABLE_PROVIDES:
+          str << ' ' << ::pool_dep2str( satPool_r, what_r );
+          break;
+        case SOLVER_SOLVABLE_ONE_OF:
+          for ( sat::detail::IdType * wp = satPool_r->whatprovidesdata + what_r; *wp; ++wp )
+            str << ' ' << ::testcase_solvid2str( satPool_r, *wp );
+          break;
+        case SOLVER_SOLVABLE_REPO:
+        {
+          ::Repo * repo { ::pool_id2repo( satPool_r, what_r ) };
+          str << ' ' << ( repo && repo->name ? repo->name : "" );
+          break;
+        }
+      }
+      str << endl;
+    }
+
+    /** The pools repos in iteration order. */
+    std::vector<Repository> poolRepos()
+    {
+      std::vector<Repository> ret;
+      for ( const Repository & repo : sat::Pool::instance().repos() )
+        ret.push_back( repo );
+      return ret;
+    }
+
+    /** Status codes stored per item. */
+    char transactCode( const ResStatus & status_r )
+    {
+      if ( ! status_r.transacts() || ! ( status_r.isBySolver() || status_r.isByApplLow() ) )
+        return '-';
+      char ret = 'I';
+      if ( status_r.isToBeUninstalledDueToObsolete() )
+        ret = 'O';
+      else if ( status_r.isToBeUninstalledDueToUpgrade() )
+        ret = 'U';
+      else if ( status_r.isToBeUninstalled() )
+        ret = 'E';
+      return status_r.isByApplLow() ? std::tolower( ret ) : ret;
+    }
+
+    unsigned weakCode( const ResStatus & status_r )
+    {
+      return ( status_r.isSuggested()   ? 1 : 0 )
+           | ( status_r.isRecommended() ? 2 : 0 )
+           | ( status_r.isOrphaned()    ? 4 : 0 )
+           | ( status_r.isUnneeded()    ? 8 : 0 );
+    }
+
+    char validateCode( const PoolItem & pi_r )
+    {
+      if ( ! traits::isPseudoInstalled( pi_r.kind() ) )
+        return '-';
+      const ResStatus & status { pi_r.status() };
+      if ( status.isBroken() )      return 'B';
+      if ( status.isSatisfied() )   return 'S';
+      if ( status.isNonRelevant() ) return 'N';
+      return 'U';
+    }
+
+    /** One line of an entry. */
+    struct Entry
+    {
+      PoolItem pi;
+      char transact;
+      unsigned weak;
+      char validate;
+    };
+
+    /** Remove all but the \ref ResultCache::entriesToKeep most recently used entries. */
+    void pruneEntries( const Pathname & dir_r )
+    {
+      std::list<std::string> names;
+      if ( filesystem::readdir( names, dir_r, false ) != 0 || names.size() <= ResultCache::entriesToKeep )
+        return;
+
+      std::vector<std::pair<time_t,std::string>> entries;
+      for ( const std::string & name : names )
+        entries.push_back( { PathInfo( dir_r/name ).mtime(), name } );
+      std::sort( entries.begin(), entries.end(), std::greater<>() );
+      for ( unsigned i = ResultCache::entriesToKeep; i < entries.size(); ++i )
+        filesystem::unlink( dir_r/entries[i].second );
+    }
+  } // namespace
+
+  ResultCache::ResultCache( const Pathname & dir_r, sat::detail::CPool * satPool_r, const sat::detail::CQueue & jobs_r, unsigned solverFlags_r )
+  : _dir( dir_r )
+  {
+    std::ostringstream str;
+    str << entryHeader << ' ' << solv_version << endl;
+    str << "flags " << solverFlags_r << endl;
+    str << "arch " << ZConfig::instance().systemArchitecture() << endl;
+    for ( const Locale & locale : sat::Pool::instance().getRequestedLocales() )
+      str << "locale " << locale << endl;
+    for ( const std::string & modalias : target::Modalias::instance().modaliasList() )
+      str << "modalias " << modalias << endl;
+    for ( const std::string & filesystem : sat::detail::PoolMember::myPool().requiredFilesystems() )
+      str << "filesystem " << filesystem << endl;
+    VendorAttr::instance().foreachVendorList( [&str]( VendorAttr::VendorList vlist_r )->bool {
+      str << "vendors " << str::join( vlist_r, " " ) << endl;
+      return true;
+    } );
+
+    for ( const Repository & repo : sat::Pool::instance().repos() )
+      digestRepo( str, repo );
+
+    for ( int i = 0; i + 1 < jobs_r.count; i += 2 )
+      digestJob( str, satPool_r, jobs_r.elements[i], jobs_r.elements[i+1] );
+
+    _key = Digest::digest( Digest::sha256(), str.str() );
+  }
+
+  bool ResultCache::restore( PoolItemList & toInstall_r, PoolItemList & toRemove_r, PoolItemList & orphaned_r ) const
+  {
+    std::ifstream in( ( _dir/_key ).c_str() );
+    if ( ! in )
+      return false;
+
+    std::string line;
+    if ( ! std::getline( in, line ) || line != entryHeader )
+    {
+      WAR << "Ignore result cache entry with unexpected header " << _dir/_key << endl;
+      return false;
+    }
+
+    // Parse and check all entries before touching the pool
+    const std::vector<Repository> repos { poolRepos() };
+    std::vector<Entry> entries;
+    while ( std::getline( in, line ) )
+    {
+      std::istringstream lstr( line );
+      unsigned repoIdx = 0;
+      sat::detail::SolvableIdType offset = 0;
+      Entry entry;
+      std::string name;
+      lstr >> repoIdx >> offset >> entry.transact >> entry.weak >> entry.validate >> name;
+      if ( ! lstr || repoIdx >= repos.size() )
+      {
+        WAR << "Ignore corrupted result cache entry " << _dir/_key << endl;
+        return false;
+      }
+      ::Repo * repo { repos[repoIdx].get() };
+      sat::Solvable slv { sat::detail::SolvableIdType( repo->start ) + offset };
+      if ( slv.id() >= sat::detail::SolvableIdType( repo->end ) || slv.repository() != repos[repoIdx] || slv.ident().asString() != name )
+      {
+        WAR << "Ignore result cache entry not matching the pool " << _dir/_key << endl;
+        return false;
+      }
+      entry.pi = PoolItem( slv );
+      entries.push_back( std::move(entry) );
+    }
+
+    toInstall_r.clear();
+    toRemove_r.clear();
+    orphaned_r.clear();
+    for ( const Entry & entry : entries )
+    {
+      ResStatus & status { entry.pi.status() };
+      if ( entry.transact != '-' )
+      {
+        status.resetTransact( ResStatus::SOLVER );
+        status.resetWeak();
+        switch ( std::toupper( entry.transact ) )
+        {
+          case 'I': status.setToBeInstalled( ResStatus::SOLVER ); break;
+          case 'U': status.setToBeUninstalledDueToUpgrade( ResStatus::SOLVER ); break;
+          case 'E': status.setToBeUninstalled( ResStatus::SOLVER ); break;
+          case 'O': status.setToBeUninstalled( ResStatus::SOLVER ); status.setToBeUninstalledDueToObsolete(); break;
+        }
+        if ( std::islower( entry.transact ) )
+          status.setTransactByValue( ResStatus::APPL_LOW );
+        ( entry.pi.isSystem() ? toRemove_r : toInstall_r ).push_back( entry.pi );
+      }
+      if ( entry.weak & 1 ) status.setSuggested( true );
+      if ( entry.weak & 2 ) status.setRecommended( true );
+      if ( entry.weak & 4 ) { status.setOrphaned( true ); orphaned_r.push_back( entry.pi ); }
+      if ( entry.weak & 8 ) status.setUnneeded( true );
+      switch ( entry.validate )
+      {
+        case 'B': status.setBroken(); break;
+        case 'S': status.setSatisfied(); break;
+        case 'N': status.setNonRelevant(); break;
+        case 'U': status.setUndetermined(); break;
+      }
+    }
+    filesystem::touch( _dir/_key );	// most recently used
+    MIL << "Restored " << entries.size() << " item states from result cache " << _dir/_key << endl;
+    return true;
+  }
+
+  void ResultCache::store( const ResPool & pool_r ) const
+  {
+    if ( filesystem::assert_dir( _dir ) != 0 )
+    {
+      WAR << "Can't create result cache " << _dir << endl;
+      return;
+    }
+
+    std::unordered_map<::Repo *, unsigned> repoIdx;
+    for ( const Repository & repo : poolRepos() )
+      repoIdx.emplace( repo.get(), repoIdx.size() );
+
+    std::ostringstream str;
+    str << entryHeader << endl;
+    for ( const PoolItem & pi : pool_r )
+    {
+      char transact = transactCode( pi.status() );
+      unsigned weak = weakCode( pi.status() );
+      char validate = validateCode( pi );
+      if ( transact == '-' && ! weak && validate == '-' )
+        continue;
+
+      ::Repo * repo { pi.repository().get() };
+      str << repoIdx[repo] << ' ' << ( pi.id() - repo->start ) << ' ' << transact << ' ' << weak << ' ' << validate << ' ' << pi.ident() << endl;
+    }
+
+    // write atomically, concurrent readers see the old or the new entry
+    const Pathname tmp { _dir/(_key+".new") };
+    {
+      std::ofstream out( tmp.c_str() );
+      out << str.str();
+      if ( ! out )
+      {
+        WAR << "Can't write result cache entry " << tmp << endl;
+        filesystem::unlink( tmp );
+        return;
+      }
+    }
+    if ( filesystem::rename( tmp, _dir/_key ) != 0 )
+    {
+      filesystem::unlink( tmp );
+      return;
+    }
+    MIL << "Stored result cache entry " << _dir/_key << endl;
+    pruneEntries( _dir );
+  }
+
+} // namespace zypp::solver::detail
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,79 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/solver/detail/ResultCache.h
+ *
+*/
+#ifndef ZYPP_SOLVER_DETAIL_RESULTCACHE_H
+#define ZYPP_SOLVER_DETAIL_RESULTCACHE_H
+#ifndef ZYPP_USE_RESOLVER_INTERNALS
+#error Do not directly include this file!
+#else
+
+#include <list>
+#include <string>
+
+#include <zypp/Pathname.h>
+#include <zypp/ResPool.h>
+#include <zypp/sat/detail/PoolMember.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp::solver::detail
+{
+  typedef std::list<PoolItem> PoolItemList;
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class ResultCache
+  /// \brief Persistent cache of successful solver results.
+  ///
+  /// An entry is keyed by a digest of the pool content, the solver job
+  /// queue and the solver flags. A repo contributes its alias, priorities,
+  /// size and the timestamp of its solv file (a digest of its solvables,
+  /// if the timestamp is missing). The jobs are hashed as strings, so
+  /// the key does not depend on the pools Ids. So are the inputs of the
+  /// pools namespace callback: requested locales, modaliases and required
+  /// filesystems.
+  ///
+  /// An entry stores the status values the solver sets: transactions,
+  /// weak flags and the validation of pseudo installed items. Restoring
+  /// it leaves the pool as the solver would have left it.
+  ///
+  /// Only the \ref entriesToKeep most recently used entries are kept.
+  ///////////////////////////////////////////////////////////////////
+  class ResultCache
+  {
+  public:
+    /** Number of entries kept in the cache directory. */
+    static constexpr unsigned entriesToKeep = 32;
+
+  public:
+    /** Cache entry in \a dir_r for the current pool, \a jobs_r and \a solverFlags_r. */
+    ResultCache( const Pathname & dir_r, sat::detail::CPool * satPool_r, const sat::detail::CQueue & jobs_r, unsigned solverFlags_r );
+
+    /** The entries key. */
+    const std::string & key() const
+    { return _key; }
+
+    /** Apply a cached result to the pool.
+     * The transacting and orphaned items are returned in the lists.
+     * \returns \c false and leaves the pool untouched if there is no usable entry.
+     */
+    bool restore( PoolItemList & toInstall_r, PoolItemList & toRemove_r, PoolItemList & orphaned_r ) const;
+
+    /** Remember the result of the last solver run. */
+    void store( const ResPool & pool_r ) const;
+
+  private:
+    Pathname _dir;
+    std::string _key;
+  };
+
+} // namespace zypp::solver::detail
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_USE_RESOLVER_INTERNALS
+#endif // ZYPP_SOLVER_DETAIL_RESULTCACHE_H
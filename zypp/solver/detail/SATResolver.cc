@@ -24,11 +24,23 @@ extern "C"
 #include <solv/poolarch.h>
 #include <solv/evr.h>
 #include <solv/poolvendor.h>
-#include <solv/policy.h>
 #include <solv/bitmap.h>
 #include <solv/queue.h>
+#include <solv/transaction.h>
+#include <solv/rules.h>
+#include <solv/problems.h>
+// Just for solverCountRules: libsolv exports no getter for the rule
+// count (Solver::nrules). Its dependencies are included above, so the
+// define only exposes the Solver struct members.
+#define LIBSOLV_INTERNAL
+#include <solv/solver.h>
+#undef LIBSOLV_INTERNAL
+#include <solv/policy.h>
 }
 
+#include <algorithm>
+#include <optional>
+
 #define ZYPP_USE_RESOLVER_INTERNALS
 
 #include <zypp/base/LogTools.h>
@@ -44,6 +56,7 @@ extern "C"
 
 #include <zypp/solver/detail/Resolver.h>
 #include <zypp/solver/detail/SATResolver.h>
+#include <zypp/solver/detail/ResultCache.h>
 
 #include <zypp/solver/detail/ProblemSolutionCombi.h>
 #include <zypp/solver/detail/ProblemSolutionIgnore.h>
@@ -73,6 +86,8 @@ namespace zypp
       ///////////////////////////////////////////////////////////////////////
       namespace
       {
+	const Capability productCap { sat::detail::constStr2id( "product()" ) };
+
 	inline void solverSetFocus( sat::detail::CSolver & satSolver_r, const ResolverFocus & focus_r )
 	{
 	  switch ( focus_r )
@@ -93,6 +108,52 @@ namespace zypp
 	  }
 	}
 
+	/** Number of (how,what) jobs in just one of the job queues. */
+	inline unsigned jobQueueDiff( const sat::detail::CQueue & lhs_r, const sat::detail::CQueue & rhs_r )
+	{
+	  auto jobs = []( const sat::detail::CQueue & q_r ) {
+	    std::vector<std::pair<Id,Id>> ret;
+	    for ( int i = 0; i+1 < q_r.count; i += 2 )
+	      ret.push_back( { q_r.elements[i], q_r.elements[i+1] } );
+	    std::sort( ret.begin(), ret.end() );
+	    return ret;
+	  };
+	  std::vector<std::pair<Id,Id>> l( jobs( lhs_r ) );
+	  std::vector<std::pair<Id,Id>> r( jobs( rhs_r ) );
+	  std::vector<std::pair<Id,Id>> diff;
+	  std::set_symmetric_difference( l.begin(), l.end(), r.begin(), r.end(), std::back_inserter( diff ) );
+	  return diff.size();
+	}
+
+	/** Count the solver rules (by their libsolv rule class). */
+	inline void solverCountRules( sat::detail::CSolver & satSolver_r, ResolverStatistics & stats_r )
+	{
+	  stats_r.ruleCount = stats_r.learntRules = 0;
+	  for ( Id rid = 1; rid < satSolver_r.nrules; ++rid )
+	  {
+	    SolverRuleinfo ruleClass = solver_ruleclass( &satSolver_r, rid );
+	    if ( ruleClass == SOLVER_RULE_UNKNOWN )
+	      continue;	// e.g. unused slots between the rule classes
+	    ++stats_r.ruleCount;
+	    if ( ruleClass == SOLVER_RULE_LEARNT )
+	      ++stats_r.learntRules;
+	  }
+	}
+
+	/** Add the time spent in scope to a \ref ResolverStatistics::Duration. */
+	struct PhaseTime
+	{
+	  PhaseTime( ResolverStatistics::Duration & duration_r )
+	  : _duration( duration_r )
+	  , _start( std::chrono::steady_clock::now() )
+	  {}
+	  ~PhaseTime()
+	  { _duration += std::chrono::steady_clock::now() - _start; }
+	private:
+	  ResolverStatistics::Duration & _duration;
+	  std::chrono::steady_clock::time_point _start;
+	};
+
 	/** Helper collecting pseudo installed items from the pool.
 	 * \todo: pseudoItems are cachable as long as pool content does not change
 	 */
@@ -289,6 +350,10 @@ SATResolver::SATResolver (const ResPool & pool, sat::detail::CPool *satPool)
     : _pool(pool)
     , _satPool(satPool)
     , _satSolver(NULL)
+    , _solverSerial(0)
+    , _lastSolveValid(false)
+    , _lastSolverFlags(0)
+    , _lastDepSerial(0)
     , _focus			( ZConfig::instance().solver_focus() )
     , _fixsystem(false)
     , _allowdowngrade		( false )
@@ -309,13 +374,16 @@ SATResolver::SATResolver (const ResPool & pool, sat::detail::CPool *satPool)
     , _dup_allowvendorchange	( ZConfig::instance().solver_dupAllowVendorChange() )
     , _solveSrcPackages(false)
     , _cleandepsOnRemove(ZConfig::instance().solver_cleandepsOnRemove())
+    , _incrementalSolve(false)
 {
+  queue_init( &_lastJobQueue );
 }
 
 
 SATResolver::~SATResolver()
 {
   solverEnd();
+  queue_free( &_lastJobQueue );
 }
 
 //---------------------------------------------------------------------------
@@ -464,11 +532,54 @@ class CheckIfUpdate : public resfilter::PoolItemFilterFunctor
 };
 
 
+void
+SATResolver::solverCreate()
+{
+    if ( _satSolver )
+      solver_free( _satSolver );
+    _satSolver = solver_create( _satPool );
+    _solverSerial = _pool.serial().serial();
+    _lastSolveValid = false;
+}
+
+
+ResolverStatistics::Duration
+SATResolver::phaseLap()
+{
+    std::chrono::steady_clock::time_point now( std::chrono::steady_clock::now() );
+    ResolverStatistics::Duration ret( now - _phaseStart );
+    _phaseStart = now;
+    return ret;
+}
+
+
+unsigned
+SATResolver::solverFlags() const
+{
+    unsigned ret = unsigned(_focus);
+    unsigned bit = 1U << 8;
+    for ( bool flag : { _fixsystem, _allowdowngrade, _allownamechange, _allowarchchange, _allowvendorchange,
+			_allowuninstall, _updatesystem, _noupdateprovide, _dosplitprovides, _onlyRequires,
+			_ignorealreadyrecommended, _distupgrade, _distupgrade_removeunsupported,
+			_dup_allowdowngrade, _dup_allownamechange, _dup_allowarchchange, _dup_allowvendorchange,
+			ZConfig::instance().solverUpgradeRemoveDroppedPackages() } )
+    {
+      if ( flag )
+	ret |= bit;
+      bit <<= 1;
+    }
+    return ret;
+}
+
+
 bool
 SATResolver::solving(const CapabilitySet & requires_caps,
 		     const CapabilitySet & conflict_caps)
 {
-    _satSolver = solver_create( _satPool );
+    // Incremental mode keeps the solver as long as the pool content is unchanged.
+    bool reuseSolver = _incrementalSolve && _satSolver && _solverSerial == _pool.serial().serial();
+    if ( ! reuseSolver )
+      solverCreate();
     ::pool_set_custom_vendorcheck( _satPool, &vendorCheck );
     if (_fixsystem) {
 	queue_push( &(_jobQueue), SOLVER_VERIFY|SOLVER_SOLVABLE_ALL);
@@ -502,12 +613,60 @@ SATResolver::solving(const CapabilitySet & requires_caps,
     solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	_dup_allowarchchange );
     solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	_dup_allowvendorchange );
 
+    _statistics.jobs = phaseLap();
     sat::Pool::instance().prepare();
+    _statistics.prepare = phaseLap();
+
+    // The kept solver already holds the result for an unchanged job queue.
+    bool reuseResult = false;
+    if ( reuseSolver )
+    {
+      reuseResult = _lastSolveValid
+		    && _lastSolverFlags == solverFlags()
+		    && _lastDepSerial == myPool().serialDeps().serial()
+		    && _lastJobQueue.count == _jobQueue.count
+		    && std::equal( _jobQueue.elements, _jobQueue.elements + _jobQueue.count, _lastJobQueue.elements );
+      MIL << "Incremental re-solve: " << jobQueueDiff( _lastJobQueue, _jobQueue ) << " changed jobs"
+	  << ( reuseResult ? ", reusing the previous result" : "" ) << endl;
+    }
+    if ( _incrementalSolve && ! reuseResult )
+    {
+      // remember the request before droplist processing extends it
+      queue_free( &_lastJobQueue );
+      queue_init_clone( &_lastJobQueue, &_jobQueue );
+      _lastSolverFlags = solverFlags();
+      _lastDepSerial = myPool().serialDeps().serial();
+      _lastSolveValid = true;
+    }
+
+    // A stored result for the same pool content and request is restored without solving.
+    std::optional<ResultCache> resultCache;
+    if ( ! reuseResult && ! _resultCachePath.empty() )
+    {
+      resultCache.emplace( _resultCachePath, _satPool, _jobQueue, solverFlags() );
+      if ( resultCache->restore( _result_items_to_install, _result_items_to_remove, _problem_items ) )
+      {
+	_lastSolveValid = false;	// the solver itself holds no result
+	_statistics.cached = true;
+	_statistics.jobCount = _jobQueue.count / 2;
+	_statistics.copyBack = phaseLap();
+	MIL << _statistics << endl;
+	return true;
+      }
+    }
 
     // Solve !
     MIL << "Starting solving...." << endl;
     MIL << *this;
-    if ( solver_solve( _satSolver, &(_jobQueue) ) == 0 )
+    _statistics.reused = reuseResult;
+    int solveProblems = 0;
+    if ( ! reuseResult )
+    {
+      ++_statistics.solverRuns;
+      solveProblems = solver_solve( _satSolver, &(_jobQueue) );
+    }
+    _statistics.solve = phaseLap();
+    if ( ! reuseResult && solveProblems == 0 )
     {
       // bsc#1155819: Weakremovers of future product not evaluated.
       // Do a 2nd run to cleanup weakremovers() of to be installed
@@ -531,7 +690,6 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	      continue;
 	    sat::Solvable slv { (sat::detail::SolvableIdType)id };
 	    // get product buddies (they carry the weakremover)...
-	    static const Capability productCap { "product()" };
 	    if ( slv && slv.provides().matches( productCap ) )
 	    {
 	      CapabilitySet droplist { slv.valuesOfNamespace( "weakremover" ) };
@@ -551,9 +709,13 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	    }
 	  }
 	  if ( resolve )
+	  {
+	    ++_statistics.solverRuns;
 	    solver_solve( _satSolver, &(_jobQueue) );
+	  }
 	}
       }
+      _statistics.droplist = phaseLap();
     }
     MIL << "....Solver end" << endl;
 
@@ -580,6 +742,7 @@ SATResolver::solving(const CapabilitySet & requires_caps,
       SATSolutionToPool (poolItem, ResStatus::toBeInstalled, ResStatus::SOLVER);
       _result_items_to_install.push_back( poolItem );
     }
+    _statistics.decisions = decisionq.count;
     queue_free(&decisionq);
 
     /* solvables to be erased */
@@ -651,12 +814,20 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	}
     }
 
+    _statistics.jobCount = _jobQueue.count / 2;
+    _statistics.problemCount = solver_problem_count(_satSolver);
+    solverCountRules( *_satSolver, _statistics );
+    _statistics.copyBack = phaseLap();
+    MIL << _statistics << endl;
+
     if (solver_problem_count(_satSolver) > 0 )
     {
 	ERR << "Solverrun finished with an ERROR" << endl;
 	return false;
     }
 
+    if ( resultCache )
+      resultCache->store( _pool );
     return true;
 }
 
@@ -666,9 +837,15 @@ SATResolver::solverInit(const PoolItemList & weakItems)
 {
 
     MIL << "SATResolver::solverInit()" << endl;
+    renderPendingProblems();
+    _statistics = ResolverStatistics();
+    _phaseStart = std::chrono::steady_clock::now();
 
     // remove old stuff
-    solverEnd();
+    if ( _incrementalSolve && _satSolver )
+      queue_free( &(_jobQueue) );	// keep the solver, solving() decides whether it's still usable
+    else
+      solverEnd();
     queue_init( &_jobQueue );
 
     // clear and rebuild: _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep
@@ -729,8 +906,10 @@ SATResolver::solverEnd()
   // cleanup
   if ( _satSolver )
   {
+    renderPendingProblems();
     solver_free(_satSolver);
     _satSolver = NULL;
+    _lastSolveValid = false;
     queue_free( &(_jobQueue) );
   }
 }
@@ -739,6 +918,7 @@ SATResolver::solverEnd()
 bool
 SATResolver::resolvePool(const CapabilitySet & requires_caps,
 			 const CapabilitySet & conflict_caps,
+			 const IdStringSet & install_idents,
 			 const PoolItemList & weakItems,
                          const std::set<Repository> & upgradeRepos)
 {
@@ -782,6 +962,13 @@ SATResolver::resolvePool(const CapabilitySet & requires_caps,
 	MIL << "Requires " << *iter << endl;
     }
 
+    for ( IdString ident : install_idents ) {
+	queue_push( &(_jobQueue), SOLVER_INSTALL | SOLVER_SOLVABLE_NAME );
+	queue_push( &(_jobQueue), ident.id() );
+    }
+    if ( ! install_idents.empty() )
+	MIL << "Install " << install_idents.size() << " names" << endl;
+
     for (CapabilitySet::const_iterator iter = conflict_caps.begin(); iter != conflict_caps.end(); iter++) {
 	queue_push( &(_jobQueue), SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES | MAYBE_CLEANDEPS );
 	queue_push( &(_jobQueue), iter->id() );
@@ -861,7 +1048,7 @@ void SATResolver::doUpdate()
     // set locks for the solver
     setLocks();
 
-    _satSolver = solver_create( _satPool );
+    solverCreate();
     ::pool_set_custom_vendorcheck( _satPool, &vendorCheck );
     if (_fixsystem) {
 	queue_push( &(_jobQueue), SOLVER_VERIFY|SOLVER_SOLVABLE_ALL);
@@ -1184,312 +1371,397 @@ std::string SATResolver::SATproblemRuleInfoString (Id probr, std::string &detail
 ResolverProblemList
 SATResolver::problems ()
 {
+    PhaseTime phaseTime( _statistics.problems );
     ResolverProblemList resolverProblems;
     if (_satSolver && solver_problem_count(_satSolver)) {
-	sat::detail::CPool *pool = _satSolver->pool;
-	int pcnt;
-	Id p, rp, what;
-	Id problem, solution, element;
-	sat::Solvable s, sd;
-
-	CapabilitySet system_requires = SystemCheck::instance().requiredSystemCap();
-	CapabilitySet system_conflicts = SystemCheck::instance().conflictSystemCap();
-
-	MIL << "Encountered problems! Here are the solutions:\n" << endl;
-	pcnt = 1;
-	problem = 0;
+	// Strings and solutions are rendered on first access. Problems still
+	// referenced when the solver data change are rendered in renderPendingProblems.
+	if ( ! _pendingProblemsGuard )
+	    _pendingProblemsGuard = std::make_shared<bool>( true );
+	std::weak_ptr<bool> guard( _pendingProblemsGuard );
+
+	MIL << "Encountered " << solver_problem_count(_satSolver) << " problems!" << endl;
+	Id problem = 0;
 	while ((problem = solver_next_problem(_satSolver, problem)) != 0) {
-	    MIL << "Problem " <<  pcnt++ << ":" << endl;
-	    MIL << "====================================" << endl;
-	    std::string detail;
-	    Id ignoreId;
-	    std::string whatString = SATprobleminfoString (problem,detail,ignoreId);
-	    MIL << whatString << endl;
-	    MIL << "------------------------------------" << endl;
-            ResolverProblem_Ptr resolverProblem = new ResolverProblem (whatString, detail, SATgetCompleteProblemInfoStrings( problem ));
-
-	    solution = 0;
-	    while ((solution = solver_next_solution(_satSolver, problem, solution)) != 0) {
-		element = 0;
-		ProblemSolutionCombi *problemSolution = new ProblemSolutionCombi;
-		while ((element = solver_next_solutionelement(_satSolver, problem, solution, element, &p, &rp)) != 0) {
-		    if (p == SOLVER_SOLUTION_JOB) {
-			/* job, rp is index into job queue */
-			what = _jobQueue.elements[rp];
-			switch (_jobQueue.elements[rp-1]&(SOLVER_SELECTMASK|SOLVER_JOBMASK))
-			{
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE: {
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, REMOVE);
-					std::string description = str::form (_("remove lock to allow removal of %s"),  s.asString().c_str() );
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::form (_("do not install %s"), s.asString().c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    }
-				} else {
-				    ERR << "SOLVER_INSTALL_SOLVABLE: No item found for " << s.asString() << endl;
-				}
-			    }
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE: {
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::form (_("keep %s"), s.asString().c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					problemSolution->addSingleAction (poolItem, UNLOCK);
-					std::string description = str::form (_("remove lock to allow installation of %s"), itemToString( poolItem ).c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    }
-				} else {
-				    ERR << "SOLVER_ERASE_SOLVABLE: No item found for " << s.asString() << endl;
-				}
-			    }
-				break;
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE_NAME:
-				{
-				IdString ident( what );
-				SolverQueueItemInstall_Ptr install =
-				    new SolverQueueItemInstall(_pool, ident.asString(), false );
-				problemSolution->addSingleAction (install, REMOVE_SOLVE_QUEUE_ITEM);
-
-				std::string description = str::form (_("do not install %s"), ident.c_str() );
+	    auto lazy = [this,guard,problem]( void (SATResolver::*render_r)( Id, ResolverProblem & ) ) {
+		return [this,guard,problem,render_r]( ResolverProblem & resolverProblem_r ) {
+		    if ( guard.expired() ) {
+			ERR << "Problem " << problem << " can not be rendered: the solver data changed" << endl;
+			return;
+		    }
+		    PhaseTime phaseTime( _statistics.problems );
+		    (this->*render_r)( problem, resolverProblem_r );
+		};
+	    };
+	    ResolverProblem::LazyRender lazyRender;
+	    lazyRender.description		= lazy( &SATResolver::renderProblemDescription );
+	    lazyRender.completeProblemInfo	= lazy( &SATResolver::renderProblemCompleteInfo );
+	    lazyRender.solutions		= lazy( &SATResolver::renderProblemSolutions );
+	    resolverProblems.push_back( new ResolverProblem( std::move(lazyRender) ) );
+	}
+	_pendingProblems.insert( _pendingProblems.end(), resolverProblems.begin(), resolverProblems.end() );
+    }
+    return resolverProblems;
+}
+
+void SATResolver::renderPendingProblems()
+{
+    unsigned cnt = 0;
+    for ( const ResolverProblem_Ptr & resolverProblem : _pendingProblems ) {
+	if ( resolverProblem->refCount() > 1 && ! resolverProblem->rendered() ) {	// still referenced outside
+	    resolverProblem->render();
+	    ++cnt;
+	}
+    }
+    if ( cnt )
+	MIL << "Rendered " << cnt << " of " << _pendingProblems.size() << " pending problems" << endl;
+    _pendingProblems.clear();
+    _pendingProblemsGuard.reset();
+}
+
+bool SATResolver::problemBreaksSystem( Id problem )
+{
+    CapabilitySet system_requires = SystemCheck::instance().requiredSystemCap();
+    CapabilitySet system_conflicts = SystemCheck::instance().conflictSystemCap();
+    if ( system_requires.empty() && system_conflicts.empty() )
+	return false;
+
+    Id p, rp;
+    Id solution = 0;
+    while ((solution = solver_next_solution(_satSolver, problem, solution)) != 0) {
+	Id element = 0;
+	while ((element = solver_next_solutionelement(_satSolver, problem, solution, element, &p, &rp)) != 0) {
+	    if (p != SOLVER_SOLUTION_JOB)
+		continue;
+	    Capability what( _jobQueue.elements[rp] );
+	    switch (_jobQueue.elements[rp-1]&(SOLVER_SELECTMASK|SOLVER_JOBMASK))
+	    {
+		case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
+		    if ( system_requires.count( what ) )
+			return true;
+		    break;
+		case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
+		    if ( system_conflicts.count( what ) )
+			return true;
+		    break;
+	    }
+	}
+    }
+    return false;
+}
+
+void SATResolver::renderProblemDescription( Id problem, ResolverProblem & resolverProblem )
+{
+    std::string detail;
+    Id ignoreId;
+    std::string whatString = SATprobleminfoString (problem,detail,ignoreId);
+    MIL << "Problem " << problem << ": " << whatString << endl;
+
+    // Checking if a problem solution would break your system
+    if ( problemBreaksSystem( problem ) ) {
+	// Show a better warning
+	detail = whatString + "\n" + detail;
+	whatString = _("This request will break your system!");
+    }
+    resolverProblem.setDescription( std::move(whatString) );
+    resolverProblem.setDetails( std::move(detail) );
+}
+
+void SATResolver::renderProblemCompleteInfo( Id problem, ResolverProblem & resolverProblem )
+{ resolverProblem.setCompleteProblemInfo( SATgetCompleteProblemInfoStrings( problem ) ); }
+
+void SATResolver::renderProblemSolutions( Id problem, ResolverProblem & resolverProblem )
+{
+    sat::detail::CPool *pool = _satSolver->pool;
+    Id p, rp, what;
+    Id solution, element;
+    sat::Solvable s, sd;
+
+    CapabilitySet system_requires = SystemCheck::instance().requiredSystemCap();
+    CapabilitySet system_conflicts = SystemCheck::instance().conflictSystemCap();
+
+    MIL << "Solutions of problem " << problem << ":" << endl;
+    MIL << "====================================" << endl;
+    solution = 0;
+    while ((solution = solver_next_solution(_satSolver, problem, solution)) != 0) {
+	element = 0;
+	ProblemSolutionCombi *problemSolution = new ProblemSolutionCombi;
+	while ((element = solver_next_solutionelement(_satSolver, problem, solution, element, &p, &rp)) != 0) {
+	    if (p == SOLVER_SOLUTION_JOB) {
+		/* job, rp is index into job queue */
+		what = _jobQueue.elements[rp];
+		switch (_jobQueue.elements[rp-1]&(SOLVER_SELECTMASK|SOLVER_JOBMASK))
+		{
+		    case SOLVER_INSTALL | SOLVER_SOLVABLE: {
+			s = mapSolvable (what);
+			PoolItem poolItem = _pool.find (s);
+			if (poolItem) {
+			    if (pool->installed && s.get()->repo == pool->installed) {
+				problemSolution->addSingleAction (poolItem, REMOVE);
+				std::string description = str::form (_("remove lock to allow removal of %s"),  s.asString().c_str() );
 				MIL << description << endl;
 				problemSolution->addDescription (description);
-				}
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE_NAME:
-				{
-				// As we do not know, if this request has come from resolvePool or
-				// resolveQueue we will have to take care for both cases.
-                                IdString ident( what );
-				FindPackage info (problemSolution, KEEP);
-				invokeOnEach( _pool.byIdentBegin( ident ),
-					      _pool.byIdentEnd( ident ),
-					      functor::chain (resfilter::ByInstalled (),			// ByInstalled
-							      resfilter::ByTransact ()),			// will be deinstalled
-					      functor::functorRef<bool,PoolItem> (info) );
-
-				SolverQueueItemDelete_Ptr del =
-				    new SolverQueueItemDelete(_pool, ident.asString(), false );
-				problemSolution->addSingleAction (del, REMOVE_SOLVE_QUEUE_ITEM);
-
-				std::string description = str::form (_("keep %s"), ident.c_str());
+			    } else {
+				problemSolution->addSingleAction (poolItem, KEEP);
+				std::string description = str::form (_("do not install %s"), s.asString().c_str());
 				MIL << description << endl;
 				problemSolution->addDescription (description);
-				}
-				break;
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
-				{
-				problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_REQUIRE);
-				std::string description = "";
-
-				// Checking if this problem solution would break your system
-				if (system_requires.find(Capability(what)) != system_requires.end()) {
-				    // Show a better warning
-				    resolverProblem->setDetails( resolverProblem->description() + "\n" + resolverProblem->details() );
-				    resolverProblem->setDescription(_("This request will break your system!"));
-				    description = _("ignore the warning of a broken system");
-				    description += std::string(" (requires:")+pool_dep2str(pool, what)+")";
-                                    MIL << description << endl;
-                                    problemSolution->addFrontDescription (description);
-				} else {
-				    description = str::form (_("do not ask to install a solvable providing %s"), pool_dep2str(pool, what));
-                                    MIL << description << endl;
-                                    problemSolution->addDescription (description);
-				}
-				}
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
-				{
-				problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_CONFLICT);
-				std::string description = "";
-
-				// Checking if this problem solution would break your system
-				if (system_conflicts.find(Capability(what)) != system_conflicts.end()) {
-				    // Show a better warning
-				    resolverProblem->setDetails( resolverProblem->description() + "\n" + resolverProblem->details() );
-				    resolverProblem->setDescription(_("This request will break your system!"));
-				    description = _("ignore the warning of a broken system");
-				    description += std::string(" (conflicts:")+pool_dep2str(pool, what)+")";
-                                    MIL << description << endl;
-                                    problemSolution->addFrontDescription (description);
-
-				} else {
-				    description = str::form (_("do not ask to delete all solvables providing %s"), pool_dep2str(pool, what));
-                                    MIL << description << endl;
-                                    problemSolution->addDescription (description);
-				}
-				}
-				break;
-			    case SOLVER_UPDATE | SOLVER_SOLVABLE:
-				{
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::form (_("do not install most recent version of %s"), s.asString().c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE " << poolItem << " is not selected for installation" << endl;
-				    }
-				} else {
-				    ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE: No item found for " << s.asString() << endl;
-				}
-				}
-				break;
-			    default:
-				MIL << "- do something different" << endl;
-				ERR << "No valid solution available" << endl;
-				break;
+			    }
+			} else {
+			    ERR << "SOLVER_INSTALL_SOLVABLE: No item found for " << s.asString() << endl;
 			}
-		    } else if (p == SOLVER_SOLUTION_INFARCH) {
-			s = mapSolvable (rp);
+		    }
+			break;
+		    case SOLVER_ERASE | SOLVER_SOLVABLE: {
+			s = mapSolvable (what);
 			PoolItem poolItem = _pool.find (s);
-			if (pool->installed && s.get()->repo == pool->installed) {
-			    problemSolution->addSingleAction (poolItem, LOCK);
-			    std::string description = str::form (_("keep %s despite the inferior architecture"), s.asString().c_str());
+			if (poolItem) {
+			    if (pool->installed && s.get()->repo == pool->installed) {
+				problemSolution->addSingleAction (poolItem, KEEP);
+				std::string description = str::form (_("keep %s"), s.asString().c_str());
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+			    } else {
+				problemSolution->addSingleAction (poolItem, UNLOCK);
+				std::string description = str::form (_("remove lock to allow installation of %s"), itemToString( poolItem ).c_str());
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+			    }
+			} else {
+			    ERR << "SOLVER_ERASE_SOLVABLE: No item found for " << s.asString() << endl;
+			}
+		    }
+			break;
+		    case SOLVER_INSTALL | SOLVER_SOLVABLE_NAME:
+			{
+			IdString ident( what );
+			SolverQueueItemInstall_Ptr install =
+			    new SolverQueueItemInstall(_pool, ident.asString(), false );
+			problemSolution->addSingleAction (install, REMOVE_SOLVE_QUEUE_ITEM);
+
+			std::string description = str::form (_("do not install %s"), ident.c_str() );
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+			}
+			break;
+		    case SOLVER_ERASE | SOLVER_SOLVABLE_NAME:
+			{
+			// As we do not know, if this request has come from resolvePool or
+			// resolveQueue we will have to take care for both cases.
+			IdString ident( what );
+			FindPackage info (problemSolution, KEEP);
+			invokeOnEach( _pool.byIdentBegin( ident ),
+				      _pool.byIdentEnd( ident ),
+				      functor::chain (resfilter::ByInstalled (),			// ByInstalled
+						      resfilter::ByTransact ()),			// will be deinstalled
+				      functor::functorRef<bool,PoolItem> (info) );
+
+			SolverQueueItemDelete_Ptr del =
+			    new SolverQueueItemDelete(_pool, ident.asString(), false );
+			problemSolution->addSingleAction (del, REMOVE_SOLVE_QUEUE_ITEM);
+
+			std::string description = str::form (_("keep %s"), ident.c_str());
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+			}
+			break;
+		    case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
+			{
+			problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_REQUIRE);
+			std::string description = "";
+
+			// Checking if this problem solution would break your system
+			if (system_requires.find(Capability(what)) != system_requires.end()) {
+			    description = _("ignore the warning of a broken system");
+			    description += std::string(" (requires:")+pool_dep2str(pool, what)+")";
 			    MIL << description << endl;
-			    problemSolution->addDescription (description);
+			    problemSolution->addFrontDescription (description);
 			} else {
-			    problemSolution->addSingleAction (poolItem, INSTALL);
-			    std::string description = str::form (_("install %s despite the inferior architecture"), s.asString().c_str());
+			    description = str::form (_("do not ask to install a solvable providing %s"), pool_dep2str(pool, what));
 			    MIL << description << endl;
 			    problemSolution->addDescription (description);
 			}
-		    } else if (p == SOLVER_SOLUTION_DISTUPGRADE) {
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-			if (pool->installed && s.get()->repo == pool->installed) {
-			    problemSolution->addSingleAction (poolItem, LOCK);
-			    std::string description = str::form (_("keep obsolete %s"), s.asString().c_str());
+			}
+			break;
+		    case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
+			{
+			problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_CONFLICT);
+			std::string description = "";
+
+			// Checking if this problem solution would break your system
+			if (system_conflicts.find(Capability(what)) != system_conflicts.end()) {
+			    description = _("ignore the warning of a broken system");
+			    description += std::string(" (conflicts:")+pool_dep2str(pool, what)+")";
 			    MIL << description << endl;
-			    problemSolution->addDescription (description);
+			    problemSolution->addFrontDescription (description);
+
 			} else {
-			    problemSolution->addSingleAction (poolItem, INSTALL);
-			    std::string description = str::form (_("install %s from excluded repository"), s.asString().c_str());
+			    description = str::form (_("do not ask to delete all solvables providing %s"), pool_dep2str(pool, what));
 			    MIL << description << endl;
 			    problemSolution->addDescription (description);
 			}
-		    } else if ( p == SOLVER_SOLUTION_BLACK ) {
-			// Allow to install a blacklisted package (PTF, retracted,...).
-			// For not-installed items only
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-
-			problemSolution->addSingleAction (poolItem, INSTALL);
-			std::string description;
-			if ( s.isRetracted() ) {
-			  // translator: %1% is a package name
-			  description = str::Format(_("install %1% although it has been retracted")) % s.asString();
-			} else if ( s.isPtf() ) {
-			  // translator: %1% is a package name
-			  description = str::Format(_("allow to install the PTF %1%")) % s.asString();
-			} else {
-			  // translator: %1% is a package name
-			  description = str::Format(_("install %1% although it is blacklisted")) % s.asString();
 			}
-			MIL << description << endl;
-			problemSolution->addDescription( description );
-		    } else if ( p > 0 ) {
-			/* policy, replace p with rp */
-			s = mapSolvable (p);
-			PoolItem itemFrom = _pool.find (s);
-			if (rp)
+			break;
+		    case SOLVER_UPDATE | SOLVER_SOLVABLE:
 			{
-			    int gotone = 0;
-
-			    sd = mapSolvable (rp);
-			    PoolItem itemTo = _pool.find (sd);
-			    if (itemFrom && itemTo) {
-				problemSolution->addSingleAction (itemTo, INSTALL);
-				int illegal = policy_is_illegal(_satSolver, s.get(), sd.get(), 0);
-
-				if ((illegal & POLICY_ILLEGAL_DOWNGRADE) != 0)
-				{
-				    std::string description = str::form (_("downgrade of %s to %s"), s.asString().c_str(), sd.asString().c_str());
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if ((illegal & POLICY_ILLEGAL_ARCHCHANGE) != 0)
-				{
-				    std::string description = str::form (_("architecture change of %s to %s"), s.asString().c_str(), sd.asString().c_str());
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if ((illegal & POLICY_ILLEGAL_VENDORCHANGE) != 0)
-				{
-                                    IdString s_vendor( s.vendor() );
-                                    IdString sd_vendor( sd.vendor() );
-				    std::string description = str::form (_("install %s (with vendor change)\n  %s  -->  %s") ,
-								    sd.asString().c_str(),
-                                                                    ( s_vendor ? s_vendor.c_str() : " (no vendor) " ),
-                                                                    ( sd_vendor ? sd_vendor.c_str() : " (no vendor) " ) );
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if (!gotone) {
-				    std::string description = str::form (_("replacement of %s with %s"), s.asString().c_str(), sd.asString().c_str());
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				}
+			s = mapSolvable (what);
+			PoolItem poolItem = _pool.find (s);
+			if (poolItem) {
+			    if (pool->installed && s.get()->repo == pool->installed) {
+				problemSolution->addSingleAction (poolItem, KEEP);
+				std::string description = str::form (_("do not install most recent version of %s"), s.asString().c_str());
+				MIL << description << endl;
+				problemSolution->addDescription (description);
 			    } else {
-				ERR << s.asString() << " or "  << sd.asString() << " not found" << endl;
+				ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE " << poolItem << " is not selected for installation" << endl;
 			    }
+			} else {
+			    ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE: No item found for " << s.asString() << endl;
+			}
 			}
-			else
+			break;
+		    default:
+			MIL << "- do something different" << endl;
+			ERR << "No valid solution available" << endl;
+			break;
+		}
+	    } else if (p == SOLVER_SOLUTION_INFARCH) {
+		s = mapSolvable (rp);
+		PoolItem poolItem = _pool.find (s);
+		if (pool->installed && s.get()->repo == pool->installed) {
+		    problemSolution->addSingleAction (poolItem, LOCK);
+		    std::string description = str::form (_("keep %s despite the inferior architecture"), s.asString().c_str());
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		} else {
+		    problemSolution->addSingleAction (poolItem, INSTALL);
+		    std::string description = str::form (_("install %s despite the inferior architecture"), s.asString().c_str());
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		}
+	    } else if (p == SOLVER_SOLUTION_DISTUPGRADE) {
+		s = mapSolvable (rp);
+		PoolItem poolItem = _pool.find (s);
+		if (pool->installed && s.get()->repo == pool->installed) {
+		    problemSolution->addSingleAction (poolItem, LOCK);
+		    std::string description = str::form (_("keep obsolete %s"), s.asString().c_str());
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		} else {
+		    problemSolution->addSingleAction (poolItem, INSTALL);
+		    std::string description = str::form (_("install %s from excluded repository"), s.asString().c_str());
+		    MIL << description << endl;
+		    problemSolution->addDescription (description);
+		}
+	    } else if ( p == SOLVER_SOLUTION_BLACK ) {
+		// Allow to install a blacklisted package (PTF, retracted,...).
+		// For not-installed items only
+		s = mapSolvable (rp);
+		PoolItem poolItem = _pool.find (s);
+
+		problemSolution->addSingleAction (poolItem, INSTALL);
+		std::string description;
+		if ( s.isRetracted() ) {
+		  // translator: %1% is a package name
+		  description = str::Format(_("install %1% although it has been retracted")) % s.asString();
+		} else if ( s.isPtf() ) {
+		  // translator: %1% is a package name
+		  description = str::Format(_("allow to install the PTF %1%")) % s.asString();
+		} else {
+		  // translator: %1% is a package name
+		  description = str::Format(_("install %1% although it is blacklisted")) % s.asString();
+		}
+		MIL << description << endl;
+		problemSolution->addDescription( description );
+	    } else if ( p > 0 ) {
+		/* policy, replace p with rp */
+		s = mapSolvable (p);
+		PoolItem itemFrom = _pool.find (s);
+		if (rp)
+		{
+		    int gotone = 0;
+
+		    sd = mapSolvable (rp);
+		    PoolItem itemTo = _pool.find (sd);
+		    if (itemFrom && itemTo) {
+			problemSolution->addSingleAction (itemTo, INSTALL);
+			int illegal = policy_is_illegal(_satSolver, s.get(), sd.get(), 0);
+
+			if ((illegal & POLICY_ILLEGAL_DOWNGRADE) != 0)
 			{
-			    if (itemFrom) {
-				std::string description = str::form (_("deinstallation of %s"), s.asString().c_str());
-				MIL << description << endl;
-				problemSolution->addDescription (description);
-				problemSolution->addSingleAction (itemFrom, REMOVE);
-			    }
+			    std::string description = str::form (_("downgrade of %s to %s"), s.asString().c_str(), sd.asString().c_str());
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    gotone = 1;
+			}
+			if ((illegal & POLICY_ILLEGAL_ARCHCHANGE) != 0)
+			{
+			    std::string description = str::form (_("architecture change of %s to %s"), s.asString().c_str(), sd.asString().c_str());
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    gotone = 1;
 			}
+			if ((illegal & POLICY_ILLEGAL_VENDORCHANGE) != 0)
+			{
+			    IdString s_vendor( s.vendor() );
+			    IdString sd_vendor( sd.vendor() );
+			    std::string description = str::form (_("install %s (with vendor change)\n  %s  -->  %s") ,
+							    sd.asString().c_str(),
+							    ( s_vendor ? s_vendor.c_str() : " (no vendor) " ),
+							    ( sd_vendor ? sd_vendor.c_str() : " (no vendor) " ) );
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    gotone = 1;
+			}
+			if (!gotone) {
+			    std::string description = str::form (_("replacement of %s with %s"), s.asString().c_str(), sd.asString().c_str());
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			}
+		    } else {
+			ERR << s.asString() << " or "  << sd.asString() << " not found" << endl;
 		    }
-		    else
-		    {
-		      INT << "Unknown solution " << p << endl;
+		}
+		else
+		{
+		    if (itemFrom) {
+			std::string description = str::form (_("deinstallation of %s"), s.asString().c_str());
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+			problemSolution->addSingleAction (itemFrom, REMOVE);
 		    }
-
 		}
-		resolverProblem->addSolution (problemSolution,
-					      problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
-		MIL << "------------------------------------" << endl;
 	    }
-
-	    if (ignoreId > 0) {
-		// There is a possibility to ignore this error by setting weak dependencies
-		PoolItem item = _pool.find (sat::Solvable(ignoreId));
-		ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
-		resolverProblem->addSolution (problemSolution,
-					      false); // Solutions will be shown at the end
-		MIL << "ignore some dependencies of " << item << endl;
-		MIL << "------------------------------------" << endl;
+	    else
+	    {
+	      INT << "Unknown solution " << p << endl;
 	    }
 
-	    // save problem
-	    resolverProblems.push_back (resolverProblem);
 	}
+	resolverProblem.addSolution (problemSolution,
+				     problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
+	MIL << "------------------------------------" << endl;
+    }
+
+
+    // There is a possibility to ignore this error by setting weak dependencies
+    // on the source of the problem rule (see SATproblemRuleInfoString)
+    Id source, target, dep;
+    switch ( solver_ruleinfo( _satSolver, solver_findproblemrule( _satSolver, problem ), &source, &target, &dep ) )
+    {
+	case SOLVER_RULE_PKG_NOTHING_PROVIDES_DEP:
+	case SOLVER_RULE_PKG_REQUIRES: {
+	    PoolItem item = _pool.find (sat::Solvable(source));
+	    ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
+	    resolverProblem.addSolution (problemSolution,
+					 false); // Solutions will be shown at the end
+	    MIL << "ignore some dependencies of " << item << endl;
+	    MIL << "------------------------------------" << endl;
+	}
+	    break;
+	default:
+	    break;
     }
-    return resolverProblems;
 }
 
 void SATResolver::applySolutions( const ProblemSolutionList & solutions )
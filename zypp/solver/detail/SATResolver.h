@@ -31,10 +31,14 @@ extern "C"
 }
 
 #include <iosfwd>
+#include <chrono>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 
+#include <zypp/Pathname.h>
+#include <zypp/ResolverStatistics.h>
 #include <zypp/solver/Types.h>
 
 /////////////////////////////////////////////////////////////////////////
@@ -83,6 +87,23 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     // solve results
     PoolItemList _result_items_to_install;
     PoolItemList _result_items_to_remove;
+
+    // incremental re-solve: what the kept _satSolver was last solved for
+    unsigned _solverSerial;		// pool serial the _satSolver was created for
+    bool _lastSolveValid;		// whether the _last* values below are valid
+    unsigned _lastSolverFlags;		// solverFlags() of the last run
+    unsigned _lastDepSerial;		// pool serialDeps of the last run
+    sat::detail::CQueue _lastJobQueue;	// job queue of the last run
+
+    // problems of the last run, rendered on demand (see problems())
+    ResolverProblemList _pendingProblems;
+    std::shared_ptr<bool> _pendingProblemsGuard;	// expires when the solver data change
+
+    // statistics of the last run
+    ResolverStatistics _statistics;
+    std::chrono::steady_clock::time_point _phaseStart;
+
+    Pathname _resultCachePath;		// persistent ResultCache (empty: disabled)
   public:
     ResolverFocus _focus;		// The resolvers general attitude
 
@@ -105,16 +126,31 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     bool _dup_allowvendorchange:1;	// dup mode: allow to change vendor of installed solvables
     bool _solveSrcPackages:1;		// false: generate no job rule for source packages selected in the pool
     bool _cleandepsOnRemove:1;		// whether removing a package should also remove no longer needed requirements
+    bool _incrementalSolve:1;		// keep the solver between runs and skip solving an unchanged job queue
 
   private:
     // ---------------------------------- methods
     std::string SATprobleminfoString (Id problem, std::string &detail, Id &ignoreId);
     std::string SATproblemRuleInfoString (Id rule, std::string &detail, Id &ignoreId);
     std::vector<std::string> SATgetCompleteProblemInfoStrings ( Id problem );
+    // Whether a solution of the problem drops a SystemCheck requirement or conflict
+    bool problemBreaksSystem( Id problem );
+    // ResolverProblem::LazyRender functions (see problems())
+    void renderProblemDescription( Id problem, ResolverProblem & resolverProblem );
+    void renderProblemCompleteInfo( Id problem, ResolverProblem & resolverProblem );
+    void renderProblemSolutions( Id problem, ResolverProblem & resolverProblem );
+    // Render the problems still referenced outside before the solver data change
+    void renderPendingProblems();
     void resetItemTransaction (PoolItem item);
 
     // Create a SAT solver and reset solver selection in the pool (Collecting
     void solverInit(const PoolItemList & weakItems);
+    // (Re)create the _satSolver (drops a solver kept for an incremental re-solve)
+    void solverCreate();
+    // Digest of the solver flags passed to the _satSolver
+    unsigned solverFlags() const;
+    // Time since the last phaseLap (or solverInit)
+    ResolverStatistics::Duration phaseLap();
     // common solver run with the _jobQueue; Save results back to pool
     bool solving(const CapabilitySet & requires_caps = CapabilitySet(),
 		 const CapabilitySet & conflict_caps = CapabilitySet());
@@ -151,6 +187,7 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     // solver run with pool selected items
     bool resolvePool(const CapabilitySet & requires_caps,
 		     const CapabilitySet & conflict_caps,
+		     const IdStringSet & install_idents,
 		     const PoolItemList & weakItems,
 		     const std::set<Repository> & upgradeRepos
 		     );
@@ -206,9 +243,17 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     bool cleandepsOnRemove() const 		{ return _cleandepsOnRemove; }
     void setCleandepsOnRemove( bool state_r )	{ _cleandepsOnRemove = state_r; }
 
+    bool incrementalSolve() const 		{ return _incrementalSolve; }
+    void setIncrementalSolve( bool state_r )	{ _incrementalSolve = state_r; }
+
+    const Pathname & resultCachePath() const		{ return _resultCachePath; }
+    void setResultCachePath( const Pathname & path_r )	{ _resultCachePath = path_r; }
+
     PoolItemList problematicUpdateItems( void ) const { return _problem_items; }
     PoolItemList problematicUpdateItems() { return _problem_items; }
 
+    const ResolverStatistics & statistics() const { return _statistics; }
+
     PoolItemList resultItemsToInstall () { return _result_items_to_install; }
     PoolItemList resultItemsToRemove () { return _result_items_to_remove; }
 
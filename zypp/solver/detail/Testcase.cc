@@ -37,6 +37,7 @@
 #include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/solver/detail/Resolver.h>
 #include <zypp/solver/detail/SystemCheck.h>
+#include <zypp/misc/TestcaseArchive.h>
 
 #include <yaml-cpp/yaml.h>
 
@@ -69,34 +70,21 @@ namespace zypp
       Testcase::~Testcase()
       {}
 
-      bool Testcase::createTestcase(Resolver & resolver, bool dumpPool, bool runSolver)
+      namespace
+      {
+      /** How \ref writeControl refers to the repos and where it puts long lists. */
+      struct ControlWriter
+      {
+        std::function<std::string(const Repository &)> repoFile;	///< The (relative) file a repo is stored in.
+        bool solvRepos = false;						///< Whether the repo files are solv files rather than testtags.
+        std::string solverTestcase;					///< The libsolv testcase (if written).
+        std::string solverResult;					///< The libsolv result (if written).
+        std::function<void(const std::string &, const std::string &)> writeFile;	///< If set, long lists go into extra files, otherwise inline.
+      };
+
+      /** The zypp-control.yaml describing the current pool and resolver state. */
+      std::string writeControl( Resolver & resolver, const ControlWriter & writer_r )
       {
-	MIL << "createTestcase at " << dumpPath << (dumpPool?" dumpPool":"") << (runSolver?" runSolver":"") << endl;
-        PathInfo path (dumpPath);
-
-        if ( !path.isExist() ) {
-          if (zypp::filesystem::assert_dir (dumpPath)!=0) {
-            ERR << "Cannot create directory " << dumpPath << endl;
-            return false;
-          }
-        } else {
-          if (!path.isDir()) {
-            ERR << dumpPath << " is not a directory." << endl;
-            return false;
-          }
-          // remove old stuff if pool will be dump
-          if (dumpPool)
-            zypp::filesystem::clean_dir (dumpPath);
-        }
-
-        if (runSolver) {
-          zypp::base::LogControl::TmpLineWriter tempRedirect;
-          zypp::base::LogControl::instance().logfile( dumpPath +"/y2log" );
-          zypp::base::LogControl::TmpExcessive excessive;
-
-          resolver.resolvePool();
-        }
-
         ResPool pool 	= resolver.pool();
         PoolItemList	items_to_install;
         PoolItemList 	items_to_remove;
@@ -104,22 +92,6 @@ namespace zypp
         PoolItemList 	items_keep;
 
 
-        const std::string slvTestcaseName = "testcase.t";
-        const std::string slvResult       = "solver.result";
-
-        zypp::AutoDispose<const char **> repoFileNames( testcase_mangle_repo_names( resolver.get()->pool ),
-          [ nrepos = resolver.get()->pool->nrepos ]( auto **x ){
-            if (!x) return;
-            for ( int i = 1; i < nrepos; i++ )
-                solv_free((void *)x[i]);
-            solv_free((void *)x);
-        });
-
-        if ( ::testcase_write( resolver.get(), dumpPath.c_str(), TESTCASE_RESULT_TRANSACTION | TESTCASE_RESULT_PROBLEMS, slvTestcaseName.c_str(), slvResult.c_str() ) == 0 ) {
-          ERR << "Failed to write solv data, aborting." << endl;
-          return false;
-        }
-
         // HACK: directly access sat::pool
         const sat::Pool & satpool( sat::Pool::instance() );
 
@@ -171,7 +143,9 @@ namespace zypp
             yOut << YAML::Key << "generated" << YAML::Value << myRepo.generatedTimestamp().form( "%Y-%m-%d %H:%M:%S" );
             yOut << YAML::Key << "outdated" << YAML::Value << myRepo.suggestedExpirationTimestamp().form( "%Y-%m-%d %H:%M:%S" );
             yOut << YAML::Key << "priority" << YAML::Value << myRepoInfo.priority();
-            yOut << YAML::Key << "file" << YAML::Value << str::Format("%1%.repo.gz") % repoFileNames[myRepo.id()->repoid];
+            yOut << YAML::Key << "file" << YAML::Value << writer_r.repoFile( myRepo );
+            if ( writer_r.solvRepos )
+              yOut << YAML::Key << "format" << YAML::Value << "solv";
 
             yOut << YAML::EndMap;
           }
@@ -181,8 +155,10 @@ namespace zypp
         yOut << YAML::EndSeq;
 
         yOut << YAML::Key << "arch" << YAML::Value << ZConfig::instance().systemArchitecture().asString() ;
-        yOut << YAML::Key << "solverTestcase" << YAML::Value << slvTestcaseName ;
-        yOut << YAML::Key << "solverResult" << YAML::Value << slvResult ;
+        if ( ! writer_r.solverTestcase.empty() )
+          yOut << YAML::Key << "solverTestcase" << YAML::Value << writer_r.solverTestcase ;
+        if ( ! writer_r.solverResult.empty() )
+          yOut << YAML::Key << "solverResult" << YAML::Value << writer_r.solverResult ;
 
         // RequestedLocales
         const LocaleSet & addedLocales( satpool.getAddedRequestedLocales() );
@@ -220,15 +196,14 @@ namespace zypp
 
         // helper lambda to write a list of elements into a external file instead of the main file
         const auto &writeListOrFile = [&]( const std::string &name, const auto &list, const auto &callback ) {
-          if ( list.size() > 10 ) {
+          if ( list.size() > 10 && writer_r.writeFile ) {
             const std::string fName = str::Format("zypp-%1%.yaml") % name;
             yOut << YAML::Key << name << YAML::Value << fName;
 
             YAML::Emitter yOutFile;
             callback( yOutFile, list );
 
-            std::ofstream fout( dumpPath+"/"+fName );
-            fout << yOutFile.c_str();
+            writer_r.writeFile( fName, yOutFile.c_str() );
           } else {
             yOut << YAML::Key << name << YAML::Value ;
             callback( yOut, list );
@@ -305,8 +280,7 @@ namespace zypp
           cb( yOutFile, data );
           yOutFile << YAML::EndSeq;
 
-          std::ofstream fout( dumpPath+"/"+fName );
-          fout << yOutFile.c_str();
+          writer_r.writeFile( fName, yOutFile.c_str() );
         };
 
         // Multiversion
@@ -345,14 +319,21 @@ namespace zypp
         writePoolItemJobs("keep")( yOut, items_keep );
         writePoolItemJobs("uninstall")( yOut, items_to_remove, true );
 
-        if ( items_locked.size() )
-          writeJobsToFile("zypp-locks.yaml", items_locked, writePoolItemJobs("lock") );
+        if ( items_locked.size() ) {
+          if ( writer_r.writeFile )
+            writeJobsToFile("zypp-locks.yaml", items_locked, writePoolItemJobs("lock") );
+          else
+            writePoolItemJobs("lock")( yOut, items_locked );
+        }
 
         for ( const auto &v : resolver.extraRequires() )
           writeMapJob( yOut, "addRequire", { { "name", v.asString() } } );
         for ( const auto &v : SystemCheck::instance().requiredSystemCap() )
           writeMapJob( yOut, "addRequire", { { "name", v.asString() } } );
 
+        for ( const auto &v : resolver.extraInstallIdents() )
+          writeMapJob( yOut, "install", { { "name", v.asString() } } );
+
         for ( const auto &v : resolver.extraConflicts() )
           writeMapJob( yOut, "addConflict", { { "name", v.asString() } } );
         for ( const auto &v : SystemCheck::instance().conflictSystemCap() )
@@ -376,12 +357,121 @@ namespace zypp
         yOut << YAML::EndMap; // trials
         yOut << YAML::EndMap; // root
 
+        return yOut.c_str();
+      }
+      } // namespace
+
+      bool Testcase::createTestcase(Resolver & resolver, bool dumpPool, bool runSolver)
+      {
+	MIL << "createTestcase at " << dumpPath << (dumpPool?" dumpPool":"") << (runSolver?" runSolver":"") << endl;
+        PathInfo path (dumpPath);
+
+        if ( !path.isExist() ) {
+          if (zypp::filesystem::assert_dir (dumpPath)!=0) {
+            ERR << "Cannot create directory " << dumpPath << endl;
+            return false;
+          }
+        } else {
+          if (!path.isDir()) {
+            ERR << dumpPath << " is not a directory." << endl;
+            return false;
+          }
+          // remove old stuff if pool will be dump
+          if (dumpPool)
+            zypp::filesystem::clean_dir (dumpPath);
+        }
+
+        if (runSolver) {
+          zypp::base::LogControl::TmpLineWriter tempRedirect;
+          zypp::base::LogControl::instance().logfile( dumpPath +"/y2log" );
+          zypp::base::LogControl::TmpExcessive excessive;
+
+          resolver.resolvePool();
+        }
+
+        const std::string slvTestcaseName = "testcase.t";
+        const std::string slvResult       = "solver.result";
+        const std::string slvStatistics   = "solver.statistics";
+
+        zypp::AutoDispose<const char **> repoFileNames( testcase_mangle_repo_names( resolver.get()->pool ),
+          [ nrepos = resolver.get()->pool->nrepos ]( auto **x ){
+            if (!x) return;
+            for ( int i = 1; i < nrepos; i++ )
+                solv_free((void *)x[i]);
+            solv_free((void *)x);
+        });
+
+        if ( ::testcase_write( resolver.get(), dumpPath.c_str(), TESTCASE_RESULT_TRANSACTION | TESTCASE_RESULT_PROBLEMS, slvTestcaseName.c_str(), slvResult.c_str() ) == 0 ) {
+          ERR << "Failed to write solv data, aborting." << endl;
+          return false;
+        }
+
+        if (runSolver) {
+          // timings and counters of the solver run (not read by the testcase parser)
+          std::ofstream fout( dumpPath+"/"+slvStatistics );
+          fout << resolver.statistics() << endl;
+        }
+
+
+        ControlWriter writer;
+        writer.repoFile = [&repoFileNames]( const Repository & repo_r ) -> std::string {
+          return str::Format("%1%.repo.gz") % repoFileNames[repo_r.id()->repoid];
+        };
+        writer.solverTestcase = slvTestcaseName;
+        writer.solverResult   = slvResult;
+        writer.writeFile = [this]( const std::string & fName, const std::string & data_r ) {
+          std::ofstream fout( dumpPath+"/"+fName );
+          fout << data_r;
+        };
+
         std::ofstream fout( dumpPath+"/zypp-control.yaml" );
-        fout << yOut.c_str();
+        fout << writeControl( resolver, writer );
 
 	MIL << "createTestcase done at " << dumpPath << endl;
         return true;
       }
+
+      bool Testcase::createArchive( Resolver & resolver, bool runSolver )
+      {
+        const Pathname archivePath { Pathname(dumpPath) / misc::testcase::TestcaseArchive::fileName };
+        MIL << "createArchive at " << archivePath << (runSolver?" runSolver":"") << endl;
+
+        if ( zypp::filesystem::assert_dir( dumpPath ) != 0 ) {
+          ERR << "Cannot create directory " << dumpPath << endl;
+          return false;
+        }
+
+        if ( runSolver )
+          resolver.resolvePool();
+
+        try {
+          misc::testcase::TestcaseArchive archive( archivePath );
+
+          ControlWriter writer;
+          writer.solvRepos = true;
+          writer.repoFile = [&archive]( const Repository & repo_r ) -> std::string {
+            std::string fName { str::Format("repo%1%.solv") % repo_r.id()->repoid };
+            archive.addRepo( fName, repo_r );
+            return fName;
+          };
+          archive.add( "zypp-control.yaml", writeControl( resolver, writer ) );
+
+          if ( runSolver ) {
+            std::ostringstream statistics;
+            statistics << resolver.statistics() << endl;
+            archive.add( "solver.statistics", statistics.str() );
+          }
+          archive.close();
+        }
+        catch ( const Exception & excpt ) {
+          ZYPP_CAUGHT( excpt );
+          ERR << "Failed to write testcase archive " << archivePath << endl;
+          return false;
+        }
+
+        MIL << "createArchive done at " << archivePath << endl;
+        return true;
+      }
       ///////////////////////////////////////////////////////////////////
     };// namespace detail
     /////////////////////////////////////////////////////////////////////
@@ -48,6 +48,12 @@ namespace zypp
 	  ~Testcase();
 
           bool createTestcase( Resolver & resolver, bool dumpPool = true, bool runSolver = true );
+
+          /** Write a single file \ref misc::testcase::TestcaseArchive (repos as solv files) into \c dumpPath.
+           * Unlike \ref createTestcase no log is captured, so this is cheap
+           * enough to be done whenever the solver fails.
+           */
+          bool createArchive( Resolver & resolver, bool runSolver = true );
       };
 
       ///////////////////////////////////////////////////////////////////
@@ -219,6 +219,8 @@ namespace zypp
       Pathname _root;
       /** RPM database */
       rpm::RpmDb _rpm;
+      /** The rpmdb state the @System solv file was built from (set by \ref buildCache) */
+      std::string _systemSolvState;
       /** Requested Locales database */
       RequestedLocalesFile _requestedLocalesFile;
       /** user/auto installed database */
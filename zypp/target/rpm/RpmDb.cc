@@ -15,6 +15,8 @@ extern "C"
 #include <rpm/rpmcli.h>
 #include <rpm/rpmlog.h>
 }
+#include <sys/stat.h>
+
 #include <cstdlib>
 #include <cstdio>
 #include <ctime>
@@ -25,6 +27,8 @@ extern "C"
 #include <list>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -52,6 +56,16 @@ extern "C"
 #include <zypp/ZYppFactory.h>
 #include <zypp/ZConfig.h>
 #include <zypp/base/IOTools.h>
+#include <zypp/base/SerialNumber.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/LookupAttr.h>
+
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/chksum.h>
+#include <solv/repo_rpmdb.h>
+}
 
 using std::endl;
 using namespace zypp::filesystem;
@@ -405,6 +419,7 @@ void RpmDb::rebuildDatabase()
 void RpmDb::doRebuildDatabase(callback::SendReport<RebuildDBReport> & report)
 {
   FAILIFNOTINITIALIZED;
+  DtorReset rpmdbChangedGuard( _rpmdbStamp );	// forget the cached rpmdb state when done
   MIL << "RpmDb::rebuildDatabase" << *this << endl;
 
   const Pathname mydbpath { root()/dbPath() };	// the configured path used in reports
@@ -699,6 +714,7 @@ void RpmDb::exportTrustedKeysInZyppKeyRing()
 void RpmDb::importPubkey( const PublicKey & pubkey_r )
 {
   FAILIFNOTINITIALIZED;
+  DtorReset rpmdbChangedGuard( _rpmdbStamp );	// forget the cached rpmdb state when done
 
   // bnc#828672: On the fly key import in READONLY
   if ( zypp_readonly_hack::IGotIt() )
@@ -812,6 +828,7 @@ void RpmDb::importPubkey( const PublicKey & pubkey_r )
 void RpmDb::removePubkey( const PublicKey & pubkey_r )
 {
   FAILIFNOTINITIALIZED;
+  DtorReset rpmdbChangedGuard( _rpmdbStamp );	// forget the cached rpmdb state when done
 
   // check if the key is in the rpm database and just
   // return if it does not.
@@ -959,6 +976,180 @@ RpmDb::fileList( const std::string & name_r, const Edition & edition_r ) const
 }
 
 
+///////////////////////////////////////////////////////////////////
+//
+//	CLASS NAME : RpmDb::SolvIndex
+//
+/** Lookup tables on the \c @System repo, built on demand.
+ * Valid as long as the pools content does not change.
+ */
+class RpmDb::SolvIndex : private base::NonCopyable
+{
+public:
+  typedef std::unordered_multimap<std::string,sat::Solvable> FileOwners;
+  typedef std::unordered_multimap<IdString,sat::Solvable>    Packages;
+  typedef std::unordered_set<IdString>                       DepNames;
+
+public:
+  SolvIndex( Repository repo_r )
+  : _repo( repo_r )
+  , _watcher( sat::Pool::instance().serial() )
+  {}
+
+  /** Whether the index is (still) usable for \a repo_r. */
+  bool validFor( Repository repo_r ) const
+  { return _repo == repo_r && _watcher.isClean( sat::Pool::instance().serial() ); }
+
+  /** Path => owning packages. */
+  const FileOwners & fileOwners()
+  {
+    if ( ! _fileOwners )
+    {
+      _fileOwners.reset( new FileOwners );
+      sat::LookupAttr q( sat::SolvAttr::filelist, _repo );
+      for_( it, q.begin(), q.end() )
+	_fileOwners->emplace( it.c_str(), it.inSolvable() );
+      DBG << _repo << ": indexed " << _fileOwners->size() << " files" << endl;
+    }
+    return *_fileOwners;
+  }
+
+  /** Package name => packages. */
+  const Packages & packages()
+  {
+    if ( ! _packages )
+    {
+      _packages.reset( new Packages );
+      for ( const sat::Solvable & solv : _repo.solvables() )
+      {
+	if ( solv.isKind<Package>() )
+	  _packages->emplace( solv.ident(), solv );
+      }
+    }
+    return *_packages;
+  }
+
+  /** The names used in all \a which_r dependencies. */
+  const DepNames & depNames( Dep which_r )
+  {
+    shared_ptr<DepNames> & names( _depNames[which_r.inSwitch()] );
+    if ( ! names )
+    {
+      names.reset( new DepNames );
+      for ( const sat::Solvable & solv : _repo.solvables() )
+      {
+	if ( ! solv.isKind<Package>() )
+	  continue;
+	for ( const Capability & cap : solv.dep( which_r ) )
+	{
+	  CapDetail detail( cap.detail() );
+	  if ( detail.isSimple() )
+	    names->insert( detail.name() );
+	}
+      }
+    }
+    return *names;
+  }
+
+  /** Whether \a str_r is in the pools string space (but never create it).
+   * A string not known to the pool can not be used by the \c @System repo.
+   */
+  static IdString lookup( const std::string & str_r )
+  { return IdString( ::pool_str2id( sat::Pool::instance().get(), str_r.c_str(), /*create*/0 ) ); }
+
+private:
+  Repository _repo;
+  SerialNumberWatcher _watcher;
+  shared_ptr<FileOwners> _fileOwners;
+  shared_ptr<Packages> _packages;
+  std::map<Dep::for_use_in_switch,shared_ptr<DepNames>> _depNames;
+};
+
+std::string RpmDb::stateHash( const Pathname & root_r )
+{
+  std::string ret;
+  AutoDispose<void*> state { ::rpm_state_create( sat::Pool::instance().get(), root_r.c_str() ), ::rpm_state_free };
+  AutoDispose<Chksum*> chk { ::solv_chksum_create( REPOKEY_TYPE_SHA1 ), []( Chksum *chk ) -> void {
+    ::solv_chksum_free( chk, nullptr );
+  } };
+  if ( ::rpm_hash_database_state( state, chk ) == 0 )
+  {
+    int md5l;
+    const unsigned char * md5 = ::solv_chksum_get( chk, &md5l );
+    ret = ::pool_bin2hex( sat::Pool::instance().get(), md5, md5l );
+  }
+  else
+    WAR << "rpm_hash_database_state failed" << endl;
+  return ret;
+}
+
+namespace
+{
+  /** Inode, size and mtime of the rpmdb files below \a dir_r.
+   * Cheap to compute, it changes whenever rpm writes the database.
+   */
+  std::string rpmdbStamp( const Pathname & dir_r )
+  {
+    std::ostringstream str;
+    std::list<std::string> names;
+    if ( filesystem::readdir( names, dir_r, /*dots*/false ) != 0 )
+      return std::string();
+    names.sort();
+    names.push_front( "." );
+    for ( const std::string & name : names )
+    {
+      struct stat st;
+      if ( ::stat( (dir_r/name).c_str(), &st ) != 0 )
+        continue;
+      str << name << ' ' << st.st_ino << ' ' << st.st_size << ' ' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec << '\n';
+    }
+    return str.str();
+  }
+} // namespace
+
+void RpmDb::setSystemRepoState( const std::string & stateHash_r )
+{
+  MIL << "@System repo reflects rpmdb state '" << stateHash_r << "'" << endl;
+  _systemRepoState = stateHash_r;
+  _solvIndex.reset();
+  _rpmdbStamp.clear();
+}
+
+bool RpmDb::systemRepoIsCurrent() const
+{
+  if ( _systemRepoState.empty() || ! initialized() )
+    return false;
+
+  // rpm_hash_database_state reads the whole Name index; do it only if the rpmdb files changed.
+  std::string stamp { rpmdbStamp( root() / dbPath() ) };
+  if ( stamp.empty() || stamp != _rpmdbStamp )	// empty: unknown
+  {
+    _systemRepoCurrent = ( stateHash( _root ) == _systemRepoState );
+    _rpmdbStamp = std::move(stamp);
+    if ( ! _systemRepoCurrent )
+      DBG << "@System repo is outdated. Using the rpmdb." << endl;
+  }
+  return _systemRepoCurrent;
+}
+
+RpmDb::SolvIndex * RpmDb::solvIndex() const
+{
+  if ( _systemRepoState.empty() || ! initialized() )
+    return nullptr;
+
+  sat::Pool satpool( sat::Pool::instance() );
+  Repository system( satpool.findSystemRepo() );
+  if ( ! system || satpool.rootDir() != _root )
+    return nullptr;
+
+  if ( ! systemRepoIsCurrent() )
+    return nullptr;
+
+  if ( ! _solvIndex || ! _solvIndex->validFor( system ) )
+    _solvIndex.reset( new SolvIndex( system ) );
+  return _solvIndex.get();
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 //
@@ -969,6 +1160,19 @@ RpmDb::fileList( const std::string & name_r, const Edition & edition_r ) const
 //
 bool RpmDb::hasFile( const std::string & file_r, const std::string & name_r ) const
 {
+  if ( SolvIndex * idx = solvIndex() )
+  {
+    const SolvIndex::FileOwners & owners( idx->fileOwners() );
+    if ( name_r.empty() )
+      return owners.count( file_r );
+    for ( const auto & owner : makeIterable( owners.equal_range( file_r ) ) )
+    {
+      if ( owner.second.name() == name_r )
+	return true;
+    }
+    return false;
+  }
+
   librpmDb::db_const_iterator it;
   bool res;
   do
@@ -995,6 +1199,13 @@ bool RpmDb::hasFile( const std::string & file_r, const std::string & name_r ) co
 //
 std::string RpmDb::whoOwnsFile( const std::string & file_r) const
 {
+  if ( SolvIndex * idx = solvIndex() )
+  {
+    const SolvIndex::FileOwners & owners( idx->fileOwners() );
+    auto it = owners.find( file_r );
+    return( it == owners.end() ? std::string() : it->second.name() );
+  }
+
   librpmDb::db_const_iterator it;
   if (it.findByFile( file_r ))
   {
@@ -1013,6 +1224,9 @@ std::string RpmDb::whoOwnsFile( const std::string & file_r) const
 //
 bool RpmDb::hasProvides( const std::string & tag_r ) const
 {
+  if ( SolvIndex * idx = solvIndex() )
+    return idx->depNames( Dep::PROVIDES ).count( SolvIndex::lookup( tag_r ) );
+
   librpmDb::db_const_iterator it;
   return it.findByProvides( tag_r );
 }
@@ -1027,6 +1241,13 @@ bool RpmDb::hasProvides( const std::string & tag_r ) const
 //
 bool RpmDb::hasRequiredBy( const std::string & tag_r ) const
 {
+  // libsolv does not store the rpmlib() requirements
+  if ( ! str::hasPrefix( tag_r, "rpmlib(" ) )
+  {
+    if ( SolvIndex * idx = solvIndex() )
+      return idx->depNames( Dep::REQUIRES ).count( SolvIndex::lookup( tag_r ) );
+  }
+
   librpmDb::db_const_iterator it;
   return it.findByRequiredBy( tag_r );
 }
@@ -1041,6 +1262,9 @@ bool RpmDb::hasRequiredBy( const std::string & tag_r ) const
 //
 bool RpmDb::hasConflicts( const std::string & tag_r ) const
 {
+  if ( SolvIndex * idx = solvIndex() )
+    return idx->depNames( Dep::CONFLICTS ).count( SolvIndex::lookup( tag_r ) );
+
   librpmDb::db_const_iterator it;
   return it.findByConflicts( tag_r );
 }
@@ -1055,6 +1279,13 @@ bool RpmDb::hasConflicts( const std::string & tag_r ) const
 //
 bool RpmDb::hasPackage( const std::string & name_r ) const
 {
+  // libsolv does not store the gpg-pubkey pseudo packages
+  if ( name_r != "gpg-pubkey" )
+  {
+    if ( SolvIndex * idx = solvIndex() )
+      return idx->packages().count( SolvIndex::lookup( name_r ) );
+  }
+
   librpmDb::db_const_iterator it;
   return it.findPackage( name_r );
 }
@@ -1069,6 +1300,19 @@ bool RpmDb::hasPackage( const std::string & name_r ) const
 //
 bool RpmDb::hasPackage( const std::string & name_r, const Edition & ed_r ) const
 {
+  if ( name_r != "gpg-pubkey" )
+  {
+    if ( SolvIndex * idx = solvIndex() )
+    {
+      for ( const auto & pkg : makeIterable( idx->packages().equal_range( SolvIndex::lookup( name_r ) ) ) )
+      {
+	if ( ed_r == pkg.second.edition() )
+	  return true;
+      }
+      return false;
+    }
+  }
+
   librpmDb::db_const_iterator it;
   return it.findPackage( name_r, ed_r );
 }
@@ -1604,6 +1848,7 @@ void RpmDb::installPackage( const Pathname & filename, RpmInstFlags flags )
 void RpmDb::doInstallPackage( const Pathname & filename, RpmInstFlags flags, callback::SendReport<RpmInstallReport> & report )
 {
   FAILIFNOTINITIALIZED;
+  DtorReset rpmdbChangedGuard( _rpmdbStamp );	// forget the cached rpmdb state when done
   HistoryLog historylog;
 
   MIL << "RpmDb::installPackage(" << filename << "," << flags << ")" << endl;
@@ -1800,6 +2045,7 @@ void RpmDb::removePackage( const std::string & name_r, RpmInstFlags flags )
 void RpmDb::doRemovePackage( const std::string & name_r, RpmInstFlags flags, callback::SendReport<RpmRemoveReport> & report )
 {
   FAILIFNOTINITIALIZED;
+  DtorReset rpmdbChangedGuard( _rpmdbStamp );	// forget the cached rpmdb state when done
   HistoryLog historylog;
 
   MIL << "RpmDb::doRemovePackage(" << name_r << "," << flags << ")" << endl;
@@ -174,6 +174,33 @@ public:
   ///////////////////////////////////////////////////////////////////
 public:
 
+  /**
+   * Tell the rpmdb state (\ref stateHash) the \c @System repo
+   * currently loaded in the pool was built from.
+   *
+   * As long as the rpmdb is in this state, the queries below
+   * (\ref hasFile, \ref whoOwnsFile, \ref hasProvides, ...) are
+   * answered from the pool, using lazily built indices, instead of
+   * scanning the rpm database. Passing an empty string disables this.
+   **/
+  void setSystemRepoState( const std::string & stateHash_r );
+
+  /**
+   * Hash of the rpmdb state below \a root_r (the cookie
+   * used to decide whether the \c @System solv file is outdated).
+   **/
+  static std::string stateHash( const Pathname & root_r );
+
+  /**
+   * Whether the rpmdb is still in the state passed to \ref setSystemRepoState,
+   * so queries are answered from the \c @System repo.
+   *
+   * The \ref stateHash is recomputed only if inode, size or mtime of the
+   * rpmdb files changed since the last check, or the database was
+   * modified via this RpmDb.
+   **/
+  bool systemRepoIsCurrent() const;
+
   /**
    * return complete file list for installed package name_r (in FileInfo.filename)
    * if edition_r != Edition::noedition, check for exact edition
@@ -184,6 +211,7 @@ public:
   /**
    * Return true if at least one package owns a certain file (name_r empty)
    * Return true if package name_r owns file file_r (name_r nonempty).
+   * (If multiple packages own the file, any of them may be name_r.)
    **/
   bool hasFile( const std::string & file_r, const std::string & name_r = "" ) const;
 
@@ -244,6 +272,25 @@ public:
   void getData( const std::string & name_r, const Edition & ed_r,
                 RpmHeader::constPtr & result_r ) const;
 
+private:
+  /** Lookup tables on the \c @System repo. */
+  class SolvIndex;
+
+  /** The index to use if the \c @System repo reflects the current rpmdb state (or \c nullptr). */
+  SolvIndex * solvIndex() const;
+
+  /** The rpmdb state the \c @System repo was built from. */
+  std::string _systemRepoState;
+
+  /** Lazily created \ref SolvIndex. */
+  mutable shared_ptr<SolvIndex> _solvIndex;
+
+  /** Stat of the rpmdb files when \ref _systemRepoCurrent was computed (empty: unknown). */
+  mutable std::string _rpmdbStamp;
+
+  /** Cached result of \ref systemRepoIsCurrent. */
+  mutable bool _systemRepoCurrent = false;
+
   ///////////////////////////////////////////////////////////////////
   //
   ///////////////////////////////////////////////////////////////////